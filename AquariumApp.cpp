@@ -1,39 +1,185 @@
-/**
- * @file AquariumApp.cpp
- * @author Evan Gasper
- */
-
-#include "pch.h"
-#include "AquariumApp.h"
-#include <MainFrame.h>
-
-// MEM LEAK DETECTOR
-#ifdef WIN32
-#define _CRTDBG_MAP_ALLOC
-#include <cstdlib>
-#include <crtdbg.h>
-#endif
-
-
-/**
- * Initialize the application.
- * @return
- */
-bool AquariumApp::OnInit()
-{
- #ifdef WIN32
-  _CrtSetDbgFlag ( _CRTDBG_ALLOC_MEM_DF | _CRTDBG_LEAK_CHECK_DF );
- #endif
-
- if (!wxApp::OnInit())
-  return false;
-
- // Add image type handlers
- wxInitAllImageHandlers();
-
- auto frame = new MainFrame();
- frame->Initialize();
- frame->Show(true);
-
- return true;
-}
+/**
+ * @file AquariumApp.cpp
+ * @author Evan Gasper
+ */
+
+#include "pch.h"
+#include "AquariumApp.h"
+#include <MainFrame.h>
+#include <AquariumView.h>
+#include <Aquarium.h>
+#include <SessionPlayer.h>
+#include <Renderer.h>
+#include <wx/cmdline.h>
+#include <iostream>
+
+// MEM LEAK DETECTOR
+#ifdef WIN32
+#define _CRTDBG_MAP_ALLOC
+#include <cstdlib>
+#include <crtdbg.h>
+#endif
+
+
+/**
+ * Initialize the application.
+ * @return
+ */
+bool AquariumApp::OnInit()
+{
+ #ifdef WIN32
+  _CrtSetDbgFlag ( _CRTDBG_ALLOC_MEM_DF | _CRTDBG_LEAK_CHECK_DF );
+ #endif
+
+ if (!wxApp::OnInit())
+  return false;
+
+ // Add image type handlers
+ wxInitAllImageHandlers();
+
+ if (mHeadless)
+ {
+  // OnRun replays without ever making a window
+  return true;
+ }
+
+ auto frame = new MainFrame();
+ frame->Initialize();
+ frame->Show(true);
+
+ // Recording and replaying use the first tank
+ auto view = frame->GetView();
+ for (long i = 1; i < mTanks; i++)
+ {
+  frame->AddTank();
+ }
+
+ for (auto tank : frame->GetViews())
+ {
+  tank->SetRenderer(mRenderer);
+ }
+
+ if (!mExportName.empty() && !view->Export(mExportName))
+ {
+  wxMessageBox(L"Unable to export to shared memory " + mExportName);
+ }
+
+ if (!mReplayFile.empty())
+ {
+  if (!view->Replay(mReplayFile))
+  {
+   wxMessageBox(L"Unable to open session " + mReplayFile);
+  }
+ }
+ else if (!mRecordFile.empty())
+ {
+  if (!view->Record(mRecordFile))
+  {
+   wxMessageBox(L"Unable to record session to " + mRecordFile);
+  }
+ }
+ else
+ {
+  for (auto tank : frame->GetViews())
+  {
+   tank->Recover();
+  }
+ }
+
+ return true;
+}
+
+/**
+ * Run the application
+ * @return Exit code
+ */
+int AquariumApp::OnRun()
+{
+ if (mHeadless)
+ {
+  return ReplayHeadless();
+ }
+
+ return wxApp::OnRun();
+}
+
+/**
+ * Add the command line options
+ * @param parser The command line parser
+ */
+void AquariumApp::OnInitCmdLine(wxCmdLineParser &parser)
+{
+ wxApp::OnInitCmdLine(parser);
+
+ parser.AddOption(L"", L"record", L"record the session to a file");
+ parser.AddOption(L"", L"replay", L"replay a recorded session");
+ parser.AddSwitch(L"", L"headless", L"with --replay, replay without a window and print the time taken");
+ parser.AddOption(L"", L"renderer", L"draw with dc or graphics");
+ parser.AddOption(L"", L"tanks", L"number of tanks to show", wxCMD_LINE_VAL_NUMBER);
+ parser.AddOption(L"", L"export", L"publish each frame of the first tank to this shared memory");
+}
+
+/**
+ * Handle the command line options
+ * @param parser The command line parser
+ * @return false to exit
+ */
+bool AquariumApp::OnCmdLineParsed(wxCmdLineParser &parser)
+{
+ parser.Found(L"record", &mRecordFile);
+ parser.Found(L"replay", &mReplayFile);
+ mHeadless = parser.Found(L"headless");
+ parser.Found(L"renderer", &mRenderer);
+ parser.Found(L"tanks", &mTanks);
+ parser.Found(L"export", &mExportName);
+
+ if (mTanks < 1)
+ {
+  std::cerr << "--tanks must be at least 1" << std::endl;
+  return false;
+ }
+
+ if (Renderer::Create(mRenderer) == nullptr)
+ {
+  std::cerr << "--renderer must be dc or graphics" << std::endl;
+  return false;
+ }
+
+ if (mHeadless && mReplayFile.empty())
+ {
+  std::cerr << "--headless needs --replay" << std::endl;
+  return false;
+ }
+
+ return wxApp::OnCmdLineParsed(parser);
+}
+
+/**
+ * Replay a recorded session as fast as possible without a window.
+ *
+ * Only the aquarium updates are timed, so the result can be used
+ * as a benchmark of a recorded session.
+ *
+ * @return Exit code, 0 if successful
+ */
+int AquariumApp::ReplayHeadless()
+{
+ SessionPlayer player;
+ if (!player.Open(mReplayFile))
+ {
+  std::cerr << "Unable to open session " << mReplayFile.ToStdString() << std::endl;
+  return 1;
+ }
+
+ Aquarium aquarium;
+ player.Start(&aquarium);
+
+ wxStopWatch stopWatch;
+ while (player.PlayFrame(&aquarium))
+ {
+ }
+
+ auto time = stopWatch.Time();
+ std::cout << "Replayed " << player.GetFrames() << " frames in " << time << " ms" << std::endl;
+ return 0;
+}
@@ -1,22 +1,44 @@
-/**
- * @file AquariumApp.h
- * @author Evan Gasper
- */
- 
-#ifndef AQUARIUMAPP_H
-#define AQUARIUMAPP_H
-
-
-/**
- * Main application class
- */
-class AquariumApp : public wxApp{
-private:
-
-public:
- bool OnInit() override;
-};
-
-
-
-#endif //AQUARIUMAPP_H
+/**
+ * @file AquariumApp.h
+ * @author Evan Gasper
+ */
+ 
+#ifndef AQUARIUMAPP_H
+#define AQUARIUMAPP_H
+
+
+/**
+ * Main application class
+ */
+class AquariumApp : public wxApp{
+private:
+ /// File to record the session to, if any
+ wxString mRecordFile;
+
+ /// Recorded session to replay, if any
+ wxString mReplayFile;
+
+ /// True to replay without a window
+ bool mHeadless = false;
+
+ /// What to draw the aquarium with
+ wxString mRenderer = L"dc";
+
+ /// Number of tanks to show
+ long mTanks = 1;
+
+ /// Shared memory to export the first tank to, if any
+ wxString mExportName;
+
+ int ReplayHeadless();
+
+public:
+ bool OnInit() override;
+ int OnRun() override;
+ void OnInitCmdLine(wxCmdLineParser& parser) override;
+ bool OnCmdLineParsed(wxCmdLineParser& parser) override;
+};
+
+
+
+#endif //AQUARIUMAPP_H
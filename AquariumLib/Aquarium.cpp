@@ -1,225 +1,1718 @@
-/**
- * @file Aquarium.cpp
- * @author Evan Gasper
- */
-
-#include "pch.h"
-#include "Aquarium.h"
-#include "DecorCastle.h"
-#include "FishBeta.h"
-#include "ChestFish.h"
-#include "DovaFish.h"
-#include <random>
-
-using namespace std;
-
-
-/// Initial fish X location
-const int InitialX = 200;
-
-/// Initial fish Y location
-const int InitialY = 200;
-
-/**
- * Aquarium Constructor
- */
-Aquarium::Aquarium()
-{
- // Seed the random number generator
- std::random_device rd;
- mRandom.seed(rd());
- // L turns the string into UNICODE
- mBackground = make_unique<wxBitmap>(
-         L"images/background1.png", wxBITMAP_TYPE_ANY);
-}
-
-/**
- * Draw the aquarium
- * @param dc The device context to draw on
- */
-void Aquarium::OnDraw(wxDC *dc)
-{
- dc->DrawBitmap(*mBackground, 0, 0);
- wxFont font(wxSize(0, 20),
-         wxFONTFAMILY_SWISS,
-         wxFONTSTYLE_NORMAL,
-         wxFONTWEIGHT_NORMAL);
- dc->SetFont(font);
- dc->SetTextForeground(wxColour(0, 64, 0));
- dc->DrawText(L"Under the Sea!", 10, 10);
-
- for (auto item : mItems)
- {
-  item->Draw(dc);
- }
-}
-
-/**
- * Add an item to the aquarium
- * We add an item and not FishBeta so we can
- * have multiple different items
- * @param item New item to add
- */
-void Aquarium::Add(std::shared_ptr<Item> item)
-{
- item->SetLocation(InitialX, InitialY);
- mItems.push_back(item);
-}
-
-/**
- * Test an x,y click location to see if it clicked
- * on some item in the aquarium.
- * @param x X location in pixels
- * @param y Y location in pixels
- * @returns Pointer to item we clicked on or nullptr if none.
-*/
-std::shared_ptr<Item> Aquarium::HitTest(int x, int y)
-{
- for (auto i = mItems.rbegin(); i != mItems.rend();  i++)
- {
-  if ((*i)->HitTest(x, y))
-  {
-   return *i;
-  }
- }
-
- return  nullptr;
-}
-
-/**
- * Move the selected item to the end of the list
- * @param item The item to move
- */
-void Aquarium::MoveItemToEnd(std::shared_ptr<Item> item)
-{
- auto loc = find(begin(mItems), end(mItems), item);
- if (loc != end(mItems))
- {
-  // Erase and push to the end
-  mItems.erase(loc);     // Remove from current position
-  mItems.push_back(item); // Add to the end
- }
-}
-
-/**
- * Save the aquarium as a .aqua XML file.
- *
- * Open an XML file and stream the aquarium data to it.
- *
- * @param filename The filename of the file to save the aquarium to
- */
-void Aquarium::Save(const wxString &filename)
-{
- wxXmlDocument xmlDoc;
-
- auto root = new wxXmlNode(wxXML_ELEMENT_NODE, L"aqua");
- xmlDoc.SetRoot(root);
-
- // Iterate over all items and save them
- for (auto item : mItems)
- {
-  item->XmlSave(root);
- }
-
- if(!xmlDoc.Save(filename, wxXML_NO_INDENTATION))
- {
-  wxMessageBox(L"Write to XML failed");
-  return;
- }
-}
-
-/**
- * Load the aquarium from a .aqua XML file.
- *
- * Opens the XML file and reads the nodes, creating items as appropriate.
- *
- * @param filename The filename of the file to load the aquarium from.
- * This code creates an XML document and loads the file into it. If it fails, it
- * pops up an error message box and returns. Otherwise, it clears the aquarium.
- */
-void Aquarium::Load(const wxString &filename)
-{
- wxXmlDocument xmlDoc;
- if(!xmlDoc.Load(filename))
- {
-  wxMessageBox(L"Unable to load Aquarium file");
-  return;
- }
-
- Clear();
- // Get the XML document root node
- auto root = xmlDoc.GetRoot();
-
- //
- // Traverse the children of the root
- // node of the XML document in memory!!!!
- //
- auto child = root->GetChildren();
- for( ; child; child=child->GetNext())
- {
-  auto name = child->GetName();
-  if(name == L"item")
-  {
-   XmlItem(child);
-  }
- }
-}
-
-/**
- * Handle a node of type item.
- * @param node XML node
- */
-void Aquarium::XmlItem(wxXmlNode *node)
-{
- // A pointer for the item we are loading
- shared_ptr<Item> item;
-
- // We have an item. What type?
- auto type = node->GetAttribute(L"type");
- if (type == L"beta")
- {
-  item = make_shared<FishBeta>(this);
- }
- else if (type == L"chest")
- {
-  item = make_shared<ChestFish>(this);
- }
- else if (type == L"dova")
- {
-  item = make_shared<DovaFish>(this);
- }
- else
- {
-  item = make_shared<DecorCastle>(this);
- }
-
-
- if (item != nullptr)
- {
-
-  Add(item);
-  item->XmlLoad(node);
- }
-}
-
-/**
- * Clear the aquarium data.
- *
- * Deletes all known items in the aquarium.
- */
-void Aquarium::Clear()
-{
- mItems.clear();
-}
-
-/**
- * Handle updates for animation
- * @param elapsed The time since the last update
- */
-void Aquarium::Update(double elapsed)
-{
- for (auto item : mItems)
- {
-  item->Update(elapsed);
- }
-}
+/**
+ * @file Aquarium.cpp
+ * @author Evan Gasper
+ */
+
+#include "pch.h"
+#include "Aquarium.h"
+#include "DecorCastle.h"
+#include "FishBeta.h"
+#include "ChestFish.h"
+#include "DovaFish.h"
+#include "Fish.h"
+#include "WorkerPool.h"
+#include "DcRenderer.h"
+#include <random>
+#include <mutex>
+#include <atomic>
+#include <algorithm>
+#include <unordered_set>
+#include <cstring>
+#include <wx/wfstream.h>
+#include <wx/zstream.h>
+#include <wx/filefn.h>
+
+using namespace std;
+
+
+/// Initial fish X location
+const int InitialX = 200;
+
+/// Initial fish Y location
+const int InitialY = 200;
+
+/// Fewest journal records before the base file is compacted.
+/// Above this, compaction happens once the journal holds more
+/// records than the aquarium holds items.
+const size_t JournalCompactMinimum = 1000;
+
+/// Filename extension of gzip compressed aquarium files (.aqua.gz)
+const wxString CompressedExtension = L".gz";
+
+/// First two bytes of every gzip stream
+const unsigned char GzipMagic[] = {0x1f, 0x8b};
+
+/// Number of items each worker creates at a time when loading.
+/// Fixed, rather than based on the number of cores, so a file
+/// loads the same on every machine.
+const size_t LoadChunkSize = 256;
+
+/// First random number stream of the items created by a load. Far
+/// above the streams CounterRandom::Reserve hands out.
+const uint64_t LoadStreams = uint64_t(1) << 62;
+
+/// Bytes make_shared puts in front of each item for its reference
+/// counts. Their layout is up to the library; this is a virtual
+/// table pointer and two counts, as in libstdc++ and the MSVC library.
+const size_t SharedCountsSize = sizeof(void *) + 2 * sizeof(int);
+
+/// Items are drawn reduced once their images add up to more
+/// than this many times the area of the aquarium
+const double ReducedDensity = 4;
+
+/// Items are drawn as impostors once their images add up to
+/// more than this many times the area of the aquarium
+const double ImpostorDensity = 16;
+
+/// Generator that replaces mRandom on this thread, if any
+thread_local CounterRandom *Aquarium::sThreadRandom = nullptr;
+
+/**
+ * Aquarium Constructor
+ * @param assets Where the images of the background and items
+ * come from, or null for images in the asset bundle or files
+ */
+Aquarium::Aquarium(std::shared_ptr<AssetProvider> assets) :
+    mAssets(assets != nullptr ? std::move(assets) : AssetProvider::Shared()), mSchool(SchoolingRadius)
+{
+ // Seed the random number generator
+ std::random_device rd;
+ mRandom.seed(rd());
+ // L turns the string into UNICODE. The background is
+ // decoded in the background and drawn once it is ready.
+ mBackground = mAssets->GetSprite(L"images/background1.png");
+
+ // The aquarium starts out the size of the background
+ mSize = mBackground->GetSize();
+}
+
+/**
+ * Draw the whole aquarium straight onto a device context
+ * @param dc The device context to draw on
+ */
+void Aquarium::OnDraw(wxDC *dc)
+{
+ DcRenderer renderer;
+ renderer.Begin(dc, 1, wxPoint(0, 0));
+ OnDraw(&renderer, wxRect(0, 0, GetWidth(), GetHeight()));
+ renderer.End();
+}
+
+/**
+ * Draw the part of the aquarium that can be seen.
+ *
+ * Only items near the visible rectangle are looked at, so the
+ * cost of drawing depends on what can be seen rather than on
+ * the size of the aquarium.
+ *
+ * @param renderer The renderer to draw with, between its Begin and End
+ * @param visible The part of the aquarium that can be seen, in pixels
+ */
+void Aquarium::OnDraw(Renderer *renderer, const wxRect &visible)
+{
+ // The background repeats to fill aquariums larger than it
+ if (mBackground->GetBitmap() != nullptr)
+ {
+  int tileWidth = mBackground->GetSize().GetWidth();
+  int tileHeight = mBackground->GetSize().GetHeight();
+  auto area = visible.Intersect(wxRect(0, 0, GetWidth(), GetHeight()));
+  for (int y = area.GetTop() / tileHeight * tileHeight; y <= area.GetBottom(); y += tileHeight)
+  {
+   for (int x = area.GetLeft() / tileWidth * tileWidth; x <= area.GetRight(); x += tileWidth)
+   {
+    renderer->DrawSprite(mBackground.get(), x, y);
+   }
+  }
+ }
+
+ wxFont font(wxSize(0, 20),
+         wxFONTFAMILY_SWISS,
+         wxFONTSTYLE_NORMAL,
+         wxFONTWEIGHT_NORMAL);
+ renderer->DrawText(L"Under the Sea!", 10, 10, font, wxColour(0, 64, 0));
+
+ // Crowded aquariums are drawn with less detail, and items
+ // hidden behind decor are not drawn at all
+ auto items = ItemsIn(visible);
+ mDetail = ChooseDetail(items, visible);
+ auto hidden = FindHidden(items);
+
+ for (size_t i = 0; i < items.size(); i++)
+ {
+  if (!hidden[i])
+  {
+   mItems[items[i]]->Draw(renderer, *this);
+  }
+ }
+}
+
+/**
+ * Find the items that may overlap a rectangle.
+ *
+ * The grid of item bounds is only built again when the items have
+ * moved or changed since it was last built, which is at most once
+ * a frame. Moves made with Item::SetLocation are noticed through
+ * Item::GetMoves, so items can be placed either way.
+ *
+ * @param rect Rectangle in pixels
+ * @return Indexes of the items, in drawing order
+ */
+std::vector<size_t> Aquarium::ItemsIn(const wxRect &rect)
+{
+ if (mKineticActive)
+ {
+  // Only the items near the rectangle are moved to where
+  // they are now, then put in drawing order
+  mKinetics.Query(rect, mFound);
+  if (mIndexesDirty)
+  {
+   mIndexes.clear();
+   for (size_t i = 0; i < mItems.size(); i++)
+   {
+    mIndexes[mItems[i].get()] = i;
+   }
+   mIndexesDirty = false;
+  }
+
+  // Only the bounds of the items found are brought up to date
+  vector<size_t> items;
+  mBounds.resize(mItems.size());
+  for (auto item : mFound)
+  {
+   auto i = mIndexes[item];
+   mBounds[i] = item->GetBounds();
+   items.push_back(i);
+  }
+
+  sort(items.begin(), items.end());
+  return items;
+ }
+
+ // Items moved with Item::SetLocation since it was built make it stale too
+ auto moves = Item::GetMoves();
+ if (mGridDirty || moves != mGridMoves)
+ {
+  mBounds.resize(mItems.size());
+  for (size_t i = 0; i < mItems.size(); i++)
+  {
+   mBounds[i] = mItems[i]->GetBounds();
+  }
+
+  mGrid.Build(mBounds, mSize);
+  mGridDirty = false;
+  mGridMoves = moves;
+ }
+
+ return mGrid.Query(rect);
+}
+
+/**
+ * Choose how much detail to draw items with.
+ *
+ * The more times over the item images would cover the aquarium,
+ * the less each item can be seen, so the less detail is drawn.
+ * This keeps the time to draw from growing as fast as the
+ * number of items.
+ *
+ * @param items Indexes of the items that can be seen, from ItemsIn
+ * @param visible The part of the aquarium that can be seen
+ * @return The level of detail to draw with
+ */
+Aquarium::Detail Aquarium::ChooseDetail(const std::vector<size_t> &items, const wxRect &visible) const
+{
+ double area = 0;
+ for (auto i : items)
+ {
+  area += double(mBounds[i].GetWidth()) * mBounds[i].GetHeight();
+ }
+
+ double density = area / std::max(1.0, double(visible.GetWidth()) * visible.GetHeight());
+ if (density > ImpostorDensity)
+ {
+  return Detail::Impostor;
+ }
+
+ return density > ReducedDensity ? Detail::Reduced : Detail::Full;
+}
+
+/**
+ * Work out how much memory the aquarium takes up.
+ *
+ * Sprites shared by several items are counted once. Sizes are
+ * what the containers have allocated, not just what they hold,
+ * and do not include what the allocator adds to each block. The
+ * reference counts of each item, and its entries in the tables
+ * and grids, are counted as containers.
+ *
+ * @return Memory in bytes, by what it is used for
+ */
+Aquarium::Memory Aquarium::GetMemory() const
+{
+ Memory memory;
+ unordered_set<const Sprite *> sprites = {mBackground.get()};
+ for (auto &item : mItems)
+ {
+  memory.mItems += item->GetFootprint();
+  sprites.insert(item->GetSpecies()->GetSprite());
+ }
+
+ for (auto sprite : sprites)
+ {
+  memory.mPixels += sprite->GetMemory();
+ }
+
+ // Each entry in the index table is a node with a link to the next
+ memory.mContainers = mItems.capacity() * sizeof(mItems[0]) + mItems.size() * SharedCountsSize +
+         (mBounds.capacity() + mSolidBounds.capacity() + mOccluderBounds.capacity()) * sizeof(wxRect) +
+         (mSolids.capacity() + mOccluders.capacity()) * sizeof(size_t) +
+         (mFound.capacity() + mOthers.capacity()) * sizeof(Item *) +
+         mFish.capacity() * sizeof(Fish *) +
+         mIndexes.size() * (sizeof(pair<const Item *const, size_t>) + sizeof(void *)) +
+         mIndexes.bucket_count() * sizeof(void *) +
+         mGrid.GetMemory() + mOccluderGrid.GetMemory() + mSchool.GetMemory() + mSweep.GetMemory() + mKinetics.GetMemory();
+
+ memory.mXml = mXmlMemory;
+ return memory;
+}
+
+/**
+ * Get the memory a node of an XML document and everything
+ * under it takes up
+ * @param node The node
+ * @return Size in bytes
+ */
+static size_t NodeMemory(const wxXmlNode *node)
+{
+ size_t bytes = sizeof(wxXmlNode) + (node->GetName().length() + node->GetContent().length()) * sizeof(wxChar);
+ for (auto attr = node->GetAttributes(); attr; attr = attr->GetNext())
+ {
+  bytes += sizeof(wxXmlAttribute) + (attr->GetName().length() + attr->GetValue().length()) * sizeof(wxChar);
+ }
+
+ for (auto child = node->GetChildren(); child; child = child->GetNext())
+ {
+  bytes += NodeMemory(child);
+ }
+
+ return bytes;
+}
+
+/**
+ * Get the memory an XML document takes up while it is held
+ * for a load or save
+ * @param xmlDoc The document
+ * @return Size in bytes
+ */
+size_t Aquarium::XmlMemory(const wxXmlDocument &xmlDoc)
+{
+ auto root = xmlDoc.GetRoot();
+ return sizeof(wxXmlDocument) + (root != nullptr ? NodeMemory(root) : 0);
+}
+
+/**
+ * Find the items entirely hidden behind opaque decor.
+ *
+ * Only items drawn after an item can hide it. An item is only
+ * hidden by decor whose bounds hold its top left corner, so the
+ * decor is put in a grid and each item only looks at the decor
+ * in the cell its corner is in.
+ *
+ * @param items Indexes of the items to look at, from ItemsIn
+ * @return A flag for each of items, true if it is hidden
+ */
+std::vector<bool> Aquarium::FindHidden(const std::vector<size_t> &items)
+{
+ vector<bool> hidden(items.size(), false);
+ mOccluders.clear();
+ mOccluderBounds.clear();
+ for (size_t i = 0; i < items.size(); i++)
+ {
+  if (mItems[items[i]]->IsOccluder())
+  {
+   mOccluders.push_back(i);
+   mOccluderBounds.push_back(mBounds[items[i]]);
+  }
+ }
+
+ if (mOccluders.empty())
+ {
+  return hidden;
+ }
+
+ mOccluderGrid.Build(mOccluderBounds, mSize);
+ for (size_t i = 0; i < items.size(); i++)
+ {
+  auto &bounds = mBounds[items[i]];
+  for (auto occluder : mOccluderGrid.Query(wxRect(bounds.GetTopLeft(), wxSize(1, 1))))
+  {
+   auto o = mOccluders[occluder];
+   if (o > i && mItems[items[o]]->Covers(bounds))
+   {
+    hidden[i] = true;
+    break;
+   }
+  }
+ }
+
+ return hidden;
+}
+
+/**
+ * Add an item to the aquarium
+ * We add an item and not FishBeta so we can
+ * have multiple different items
+ * @param item New item to add
+ */
+void Aquarium::Add(std::shared_ptr<Item> item)
+{
+ item->SetLocation(InitialX, InitialY);
+ mItems.push_back(item);
+ mIndexesDirty = true;
+ mGridDirty = true;
+ mGroupsDirty = true;
+ if (mKineticActive)
+ {
+  mKinetics.Add(item.get());
+ }
+
+ if (mJournal != nullptr)
+ {
+  mJournal->RecordAdd(item.get());
+ }
+}
+
+/**
+ * Add many items of one type at once, spread over the aquarium.
+ *
+ * The items are created in parallel on the worker pool, each
+ * drawing its speed and place from a random number stream of its
+ * own, so the result only depends on the seed. Storage is made
+ * once for all of them, the first item is created before the rest
+ * so they all find its species ready, and the journal gets all the
+ * adds in one write.
+ *
+ * @param type Type name the items are saved with, such as beta
+ * @param count Number of items to add
+ * @param spread Where in the aquarium the items are put
+ */
+void Aquarium::AddBulk(const wxString &type, size_t count, Spread spread)
+{
+ if (count == 0)
+ {
+  return;
+ }
+
+ auto first = mItems.size();
+ mItems.resize(first + count);
+
+ // Worker threads take their streams from a copy, so they
+ // never share the aquarium generator
+ auto firstStream = mRandom.Reserve(count);
+ const CounterRandom streams = mRandom;
+ auto size = mSize;
+
+ auto create = [&](size_t i) {
+  auto random = streams.Stream(firstStream + i);
+  sThreadRandom = &random;
+  auto item = CreateItem(type);
+  sThreadRandom = nullptr;
+
+  // Keep the whole item in the aquarium if it fits
+  auto bounds = item->GetBounds();
+  double left = bounds.GetWidth() / 2.0;
+  double top = bounds.GetHeight() / 2.0;
+  double right = std::max(left, size.GetWidth() - left);
+  double bottom = std::max(top, size.GetHeight() - top);
+
+  double x, y;
+  if (spread == Spread::Centred)
+  {
+   std::normal_distribution<> distributionX(size.GetWidth() / 2.0, size.GetWidth() / 8.0);
+   std::normal_distribution<> distributionY(size.GetHeight() / 2.0, size.GetHeight() / 8.0);
+   x = std::clamp(distributionX(random), left, right);
+   y = std::clamp(distributionY(random), top, bottom);
+  }
+  else
+  {
+   std::uniform_real_distribution<> distributionX(left, right);
+   std::uniform_real_distribution<> distributionY(top, bottom);
+   x = distributionX(random);
+   y = distributionY(random);
+  }
+
+  item->SetLocation(x, y);
+  mItems[first + i] = std::move(item);
+ };
+
+ create(0);
+ auto chunks = (count - 1 + LoadChunkSize - 1) / LoadChunkSize;
+ WorkerPool::Shared().Run(chunks, [&](size_t chunk) {
+  auto last = std::min(1 + (chunk + 1) * LoadChunkSize, count);
+  for (auto i = 1 + chunk * LoadChunkSize; i < last; i++)
+  {
+   create(i);
+  }
+ });
+
+ mIndexesDirty = true;
+ mGridDirty = true;
+ mGroupsDirty = true;
+ if (mKineticActive)
+ {
+  for (auto i = first; i < mItems.size(); i++)
+  {
+   mKinetics.Add(mItems[i].get());
+  }
+ }
+
+ if (mJournal != nullptr)
+ {
+  mJournal->RecordAdds(mItems, first);
+ }
+}
+
+/**
+ * Test an x,y click location to see if it clicked
+ * on some item in the aquarium.
+ * @param x X location in pixels
+ * @param y Y location in pixels
+ * @returns Pointer to item we clicked on or nullptr if none.
+*/
+std::shared_ptr<Item> Aquarium::HitTest(int x, int y)
+{
+ // Only the items near the location are looked at, front first
+ auto items = ItemsIn(wxRect(x, y, 1, 1));
+ for (auto i = items.rbegin(); i != items.rend(); i++)
+ {
+  if (mItems[*i]->HitTest(x, y))
+  {
+   return mItems[*i];
+  }
+ }
+
+ return nullptr;
+}
+
+/**
+ * Move the selected item to the end of the list
+ * @param item The item to move
+ */
+void Aquarium::MoveItemToEnd(std::shared_ptr<Item> item)
+{
+ auto loc = find(begin(mItems), end(mItems), item);
+ if (loc != end(mItems))
+ {
+  if (mJournal != nullptr)
+  {
+   mJournal->RecordMoveToEnd(loc - begin(mItems));
+  }
+
+  // Erase and push to the end
+  mItems.erase(loc);     // Remove from current position
+  mItems.push_back(item); // Add to the end
+  mIndexesDirty = true;
+  mGridDirty = true;
+  mGroupsDirty = true;
+ }
+}
+
+/**
+ * Remove an item from the aquarium
+ * @param item The item to remove
+ */
+void Aquarium::Remove(std::shared_ptr<Item> item)
+{
+ auto loc = find(begin(mItems), end(mItems), item);
+ if (loc != end(mItems))
+ {
+  if (mJournal != nullptr)
+  {
+   mJournal->RecordRemove(loc - begin(mItems));
+  }
+
+  mItems.erase(loc);
+  mIndexesDirty = true;
+  mGridDirty = true;
+  mGroupsDirty = true;
+  if (mKineticActive)
+  {
+   mKinetics.Remove(item.get());
+  }
+
+  auto selected = find(begin(mSelection), end(mSelection), item);
+  if (selected != end(mSelection))
+  {
+   mSelection.erase(selected);
+  }
+ }
+}
+
+/**
+ * Tell the aquarium the user has finished moving an item.
+ *
+ * The item's new location is recorded in the journal. Moves made
+ * by the animation are not journaled, only ones the user makes.
+ *
+ * @param item The item that was moved
+ */
+void Aquarium::ItemMoved(std::shared_ptr<Item> item)
+{
+ auto loc = find(begin(mItems), end(mItems), item);
+ if (loc != end(mItems) && mJournal != nullptr)
+ {
+  mJournal->RecordMove(loc - begin(mItems), item->GetX(), item->GetY());
+ }
+}
+
+/**
+ * Save the aquarium as a .aqua XML file.
+ *
+ * Open an XML file and stream the aquarium data to it.
+ *
+ * @param filename The filename of the file to save the aquarium to
+ */
+void Aquarium::Save(const wxString &filename)
+{
+ auto sequence = BeginSave(filename);
+ auto xmlDoc = XmlDocument();
+ bool saved = WriteDocument(*xmlDoc, filename);
+ EndSave(sequence, saved);
+
+ if(!saved)
+ {
+  wxMessageBox(L"Write to XML failed");
+  return;
+ }
+}
+
+/**
+ * Get ready to save the aquarium to a file.
+ *
+ * Saving to the file we are journaling to compacts the journal
+ * into the file. Saving to any other file starts a new journal
+ * that goes with that file. Call XmlDocument next to get the
+ * document to write, then EndSave once it has been written.
+ *
+ * @param filename The file the aquarium is going to be saved to
+ * @return The journal sequence number the saved file will include
+ */
+long long Aquarium::BeginSave(const wxString &filename)
+{
+ if (mJournal == nullptr || mJournal->GetFilename() != filename)
+ {
+  mJournal = make_unique<AquariumJournal>(filename);
+ }
+
+ return mJournal->GetSequence();
+}
+
+/**
+ * Finish saving the aquarium to a file.
+ *
+ * Journal records the saved file now includes are dropped.
+ * Edits made while the file was being written are kept.
+ *
+ * @param sequence The sequence number BeginSave returned
+ * @param succeeded true if the file was written
+ */
+void Aquarium::EndSave(long long sequence, bool succeeded)
+{
+ if (mJournal == nullptr)
+ {
+  return;
+ }
+
+ if (!succeeded)
+ {
+  // A journal that already goes with a file stays valid for that
+  // file. A new one never got a file to go with.
+  if (!mJournal->IsOpen())
+  {
+   mJournal = nullptr;
+  }
+
+  return;
+ }
+
+ if (!mJournal->Trim(sequence))
+ {
+  // The journal file could not be written, so stop journaling
+  // until the aquarium is saved again
+  mJournal = nullptr;
+ }
+}
+
+/**
+ * Is the journal big enough that the base file should be rewritten?
+ *
+ * Compacting once the journal holds more records than the aquarium
+ * holds items keeps the cost of rewriting the base file proportional
+ * to the number of edits made.
+ *
+ * @return true if the aquarium should be saved to GetFilename
+ */
+bool Aquarium::NeedsCompaction() const
+{
+ return mJournal != nullptr &&
+        mJournal->GetCount() > std::max(JournalCompactMinimum, mItems.size());
+}
+
+/**
+ * Set the journal edits are recorded in.
+ *
+ * The old journal is closed before the new one is resumed, since
+ * both may go with the same file. If the new journal can not be
+ * resumed, edits are not journaled until the aquarium is saved.
+ *
+ * @param journal The journal LoadItems replayed, or null to stop journaling
+ */
+void Aquarium::SetJournal(std::unique_ptr<AquariumJournal> journal)
+{
+ mJournal = nullptr;
+ if (journal != nullptr && journal->Resume())
+ {
+  mJournal = std::move(journal);
+ }
+}
+
+/**
+ * Create an XML document holding all of the items in the aquarium.
+ *
+ * This only builds the document in memory, so it is cheap compared
+ * to writing it out. The document can then be written on another thread.
+ * If edits are being journaled, the document is marked with the
+ * journal records it includes.
+ *
+ * @return The new XML document
+ */
+std::unique_ptr<wxXmlDocument> Aquarium::XmlDocument()
+{
+ auto xmlDoc = make_unique<wxXmlDocument>();
+
+ if (mJournal != nullptr)
+ {
+  mJournal->XmlMark(xmlDoc.get());
+ }
+
+ auto root = new wxXmlNode(wxXML_ELEMENT_NODE, L"aqua");
+ xmlDoc->SetRoot(root);
+
+ if (mKineticActive)
+ {
+  mKinetics.LocateAll();
+ }
+
+ // Iterate over all items and save them
+ for (auto &item : mItems)
+ {
+  item->XmlSave(root);
+ }
+
+ return xmlDoc;
+}
+
+/**
+ * Take a snapshot of the state of every item in the aquarium.
+ *
+ * This only copies a few numbers per item, so it is cheap enough to
+ * take between frames. The snapshot never changes once taken and does
+ * not refer to the items, so it can be written on another thread while
+ * the items keep moving. Items are in drawing order.
+ *
+ * @return The snapshot
+ */
+std::shared_ptr<const std::vector<ItemState>> Aquarium::Snapshot() const
+{
+ if (mKineticActive)
+ {
+  mKinetics.LocateAll();
+ }
+
+ auto snapshot = make_shared<vector<ItemState>>(mItems.size());
+ for (size_t i = 0; i < mItems.size(); i++)
+ {
+  mItems[i]->GetState((*snapshot)[i]);
+ }
+
+ return snapshot;
+}
+
+/**
+ * Write a snapshot of the aquarium to a file.
+ *
+ * The file is the same as Save writes, without a journal mark.
+ * This does not touch the aquarium, so it is safe to call from
+ * a background thread.
+ *
+ * @param snapshot Snapshot returned by Snapshot
+ * @param filename The filename to write to
+ * @param progress Optional callback to report progress to
+ * @return true if successful
+ */
+bool Aquarium::WriteSnapshot(const std::vector<ItemState> &snapshot, const wxString &filename,
+        const ProgressCallback &progress)
+{
+ wxXmlDocument xmlDoc;
+
+ auto root = new wxXmlNode(wxXML_ELEMENT_NODE, L"aqua");
+ xmlDoc.SetRoot(root);
+
+ for (auto &state : snapshot)
+ {
+  state.XmlSave(root);
+ }
+
+ return WriteXml(xmlDoc, filename, progress);
+}
+
+/**
+ * Estimate how many bytes an XML document will take when written.
+ *
+ * Only used to turn bytes written into a progress fraction,
+ * so it does not have to be exact.
+ *
+ * @param xmlDoc The document to measure
+ * @return Approximate size in bytes
+ */
+static wxFileOffset EstimateSize(const wxXmlDocument &xmlDoc)
+{
+ wxFileOffset size = 0;
+ for (auto child = xmlDoc.GetRoot()->GetChildren(); child; child = child->GetNext())
+ {
+  // <name ... />
+  size += child->GetName().length() + 4;
+  for (auto attr = child->GetAttributes(); attr; attr = attr->GetNext())
+  {
+   // name="value" plus the separating space
+   size += attr->GetName().length() + attr->GetValue().length() + 4;
+  }
+ }
+
+ return size;
+}
+
+/**
+ * Should a file be saved compressed?
+ * @param filename The filename being saved to
+ * @return true if the filename ends in .gz
+ */
+static bool IsCompressedFilename(const wxString &filename)
+{
+ return filename.Lower().EndsWith(CompressedExtension);
+}
+
+/**
+ * Does a stream hold gzip compressed data?
+ *
+ * Looks at the first bytes of the stream and puts them back,
+ * so the stream can still be read from the start.
+ *
+ * @param stream The stream to test
+ * @return true if the stream starts with the gzip magic number
+ */
+static bool IsCompressedStream(wxInputStream &stream)
+{
+ unsigned char magic[sizeof(GzipMagic)];
+ stream.Read(magic, sizeof(magic));
+ auto read = stream.LastRead();
+ stream.Ungetch(magic, read);
+
+ return read == sizeof(magic) && memcmp(magic, GzipMagic, sizeof(magic)) == 0;
+}
+
+/**
+ * Write an XML document of this aquarium to a file.
+ *
+ * The document is counted in GetMemory while it is being written.
+ * Only that count is touched, so this is safe to call from a
+ * background thread.
+ *
+ * @param xmlDoc The document to write
+ * @param filename The filename to write to
+ * @param progress Optional callback to report progress to
+ * @return true if successful
+ */
+bool Aquarium::WriteDocument(const wxXmlDocument &xmlDoc, const wxString &filename,
+        const ProgressCallback &progress)
+{
+ auto held = XmlMemory(xmlDoc);
+ mXmlMemory += held;
+ bool saved = WriteXml(xmlDoc, filename, progress);
+ mXmlMemory -= held;
+ return saved;
+}
+
+/**
+ * Write an XML document to a file.
+ *
+ * The document is written to a temporary file that replaces the
+ * destination only when the write succeeds, so a failed or cancelled
+ * save never leaves a truncated aquarium behind. This does not touch
+ * the aquarium, so it is safe to call from a background thread.
+ *
+ * A filename ending in .gz is written gzip compressed. The document
+ * streams through the compressor, so the uncompressed file is never
+ * held in memory.
+ *
+ * @param xmlDoc The document to write
+ * @param filename The filename to write to
+ * @param progress Optional callback to report progress to
+ * @return true if successful
+ */
+bool Aquarium::WriteXml(const wxXmlDocument &xmlDoc, const wxString &filename,
+        const ProgressCallback &progress)
+{
+ auto tempname = filename + L".tmp";
+
+ bool saved;
+ {
+  wxFileOutputStream file(tempname);
+  wxBufferedOutputStream buffered(file);
+
+  unique_ptr<wxZlibOutputStream> zlib;
+  wxOutputStream *output = &buffered;
+  if (IsCompressedFilename(filename))
+  {
+   zlib = make_unique<wxZlibOutputStream>(buffered, wxZ_DEFAULT_COMPRESSION, wxZLIB_GZIP);
+   output = zlib.get();
+  }
+
+  ProgressOutputStream stream(*output, EstimateSize(xmlDoc), progress);
+
+  saved = file.IsOk() &&
+          xmlDoc.Save(stream, wxXML_NO_INDENTATION) &&
+          stream.IsOk() &&
+          (zlib == nullptr || zlib->Close()) &&
+          buffered.Close() &&
+          file.Close();
+ }
+
+ if (!saved || !wxRenameFile(tempname, filename, true))
+ {
+  wxRemoveFile(tempname);
+  return false;
+ }
+
+ return true;
+}
+
+/**
+ * Load the aquarium from a .aqua XML file.
+ *
+ * Opens the XML file and reads the nodes, creating items as appropriate.
+ *
+ * @param filename The filename of the file to load the aquarium from.
+ * This code creates an XML document and loads the file into it. If it fails, it
+ * pops up an error message box and returns. Otherwise, it replaces the items
+ * in the aquarium with the ones loaded.
+ */
+void Aquarium::Load(const wxString &filename)
+{
+ vector<shared_ptr<Item>> items;
+ unique_ptr<AquariumJournal> journal;
+ if(!LoadItems(filename, items, nullptr, &journal))
+ {
+  wxMessageBox(L"Unable to load Aquarium file");
+  return;
+ }
+
+ SetItems(std::move(items));
+ SetJournal(std::move(journal));
+}
+
+/**
+ * Load the items in a .aqua XML file without adding them to the aquarium.
+ *
+ * This only changes the aquarium's count of XML memory, which is
+ * atomic, so it can run on a background thread while the current
+ * items keep animating. Parsing the file
+ * reports the first half of the progress and creating the items the
+ * second half.
+ *
+ * If journal is not null, the journal next to the file is replayed
+ * onto the items and returned in journal. The journal file is only
+ * read here; pass the journal to SetJournal to continue with it.
+ *
+ * Gzip compressed files are recognized by their contents and
+ * decompressed as they are parsed.
+ *
+ * @param filename The filename of the file to load
+ * @param items Vector the loaded items are put into
+ * @param progress Optional callback to report progress to
+ * @param journal Optional pointer that receives the file's journal
+ * @return true if successful, false if the file could not be loaded or the load was cancelled
+ */
+bool Aquarium::LoadItems(const wxString &filename, std::vector<std::shared_ptr<Item>> &items,
+        const ProgressCallback &progress, std::unique_ptr<AquariumJournal> *journal)
+{
+ wxFileInputStream file(filename);
+ if (!file.IsOk())
+ {
+  return false;
+ }
+
+ ProgressCallback parseProgress;
+ if (progress)
+ {
+  parseProgress = [&progress](double fraction) { return progress(fraction / 2); };
+ }
+
+ // Progress is counted on the file itself, so it is
+ // right for compressed files too
+ ProgressInputStream stream(file, file.GetLength(), parseProgress);
+
+ unique_ptr<wxZlibInputStream> zlib;
+ wxInputStream *input = &stream;
+ if (IsCompressedStream(stream))
+ {
+  zlib = make_unique<wxZlibInputStream>(stream, wxZLIB_GZIP);
+  input = zlib.get();
+ }
+
+ wxXmlDocument xmlDoc;
+ if(!xmlDoc.Load(*input))
+ {
+  return false;
+ }
+
+ // The document is counted in GetMemory until it is freed
+ auto held = XmlMemory(xmlDoc);
+ mXmlMemory += held;
+
+ ProgressCallback createProgress;
+ if (progress)
+ {
+  createProgress = [&progress](double fraction) { return progress(0.5 + fraction / 2); };
+ }
+
+ bool created = CreateItems(xmlDoc, items, createProgress);
+ if (created && journal != nullptr)
+ {
+  *journal = AquariumJournal::Replay(xmlDoc, filename, this, items);
+ }
+
+ mXmlMemory -= held;
+ return created;
+}
+
+/**
+ * Replace all of the items in the aquarium.
+ *
+ * The swap happens in one step, so the aquarium is never
+ * seen with a partially loaded set of items.
+ *
+ * @param items The new items, in drawing order
+ */
+void Aquarium::SetItems(std::vector<std::shared_ptr<Item>> &&items)
+{
+ mItems.swap(items);
+ mSelection.clear();
+ mIndexesDirty = true;
+ mGridDirty = true;
+ mGroupsDirty = true;
+ if (mKineticActive)
+ {
+  mKinetics.Start(mItems, mSize);
+ }
+}
+
+/**
+ * Create an item from an XML node.
+ *
+ * The item is not added to the aquarium.
+ *
+ * @param node XML node of type item
+ * @return The new item
+ */
+std::shared_ptr<Item> Aquarium::CreateItem(wxXmlNode *node)
+{
+ // Whatever the new item draws is replaced by what it loads,
+ // so it draws from a stream of its own rather than the aquarium's.
+ // That way loads and journal replays do not change what the
+ // aquarium draws afterwards, and replayed sessions stay in step.
+ CounterRandom random;
+ if (sThreadRandom == nullptr)
+ {
+  random = mRandom.Stream(LoadStreams);
+  sThreadRandom = &random;
+ }
+
+ // We have an item. What type?
+ auto item = CreateItem(node->GetAttribute(L"type"));
+ item->XmlLoad(node);
+
+ if (sThreadRandom == &random)
+ {
+  sThreadRandom = nullptr;
+ }
+
+ return item;
+}
+
+/**
+ * Create a new item of a type.
+ *
+ * The item is not added to the aquarium.
+ *
+ * @param type Type name the item is saved with, such as beta
+ * @return The new item. Unknown types get a castle.
+ */
+std::shared_ptr<Item> Aquarium::CreateItem(const wxString &type)
+{
+ if (type == FishBetaTraits::Type)
+ {
+  return make_shared<FishBeta>(this);
+ }
+ else if (type == ChestFishTraits::Type)
+ {
+  return make_shared<ChestFish>(this);
+ }
+ else if (type == DovaFishTraits::Type)
+ {
+  return make_shared<DovaFish>(this);
+ }
+
+ return make_shared<DecorCastle>(this);
+}
+
+/**
+ * Create the items saved in an XML document, in parallel.
+ *
+ * Only the items in the document are created, so any journal
+ * that goes with the file the document came from is not replayed.
+ *
+ * @param xmlDoc The document, as XmlDocument makes it
+ * @param items Vector the new items are put into, in document order
+ * @param progress Optional callback to report progress to
+ * @return true if successful, false if cancelled
+ */
+bool Aquarium::CreateItems(const wxXmlDocument &xmlDoc, std::vector<std::shared_ptr<Item>> &items,
+        const ProgressCallback &progress)
+{
+ // Get the XML document root node
+ auto root = xmlDoc.GetRoot();
+
+ //
+ // Traverse the children of the root
+ // node of the XML document in memory!!!!
+ //
+ vector<wxXmlNode *> nodes;
+ for (auto child = root->GetChildren(); child; child = child->GetNext())
+ {
+  auto name = child->GetName();
+  if(name == L"item")
+  {
+   nodes.push_back(child);
+  }
+ }
+
+ return CreateItems(nodes, items, progress);
+}
+
+/**
+ * Create the items for a list of XML nodes in parallel.
+ *
+ * The nodes are split into fixed size chunks that the worker pool
+ * creates at the same time, each into a list of its own. The lists
+ * are then joined in file order, so the drawing order matches the file.
+ * Each item draws from a random number stream of its own, keyed by
+ * the aquarium seed and where the item is in the file, so the result
+ * does not depend on which thread creates which item. The streams are
+ * kept apart from the ones Reserve hands out, so loading does not
+ * change what the aquarium draws afterwards.
+ *
+ * @param nodes XML nodes of type item, in file order
+ * @param items Vector the new items are put into, in the same order
+ * @param progress Optional callback to report progress to
+ * @return true if successful, false if cancelled
+ */
+bool Aquarium::CreateItems(const std::vector<wxXmlNode *> &nodes, std::vector<std::shared_ptr<Item>> &items,
+        const ProgressCallback &progress)
+{
+ auto chunks = (nodes.size() + LoadChunkSize - 1) / LoadChunkSize;
+
+ // Worker threads take their streams from a copy, so they
+ // never share the aquarium generator
+ const CounterRandom streams = mRandom;
+
+ vector<vector<shared_ptr<Item>>> created(chunks);
+ mutex progressMutex;
+ size_t done = 0;
+ atomic<bool> cancelled{false};
+
+ WorkerPool::Shared().Run(chunks, [&](size_t chunk) {
+  if (cancelled)
+  {
+   return;
+  }
+
+  auto first = chunk * LoadChunkSize;
+  auto last = std::min(first + LoadChunkSize, nodes.size());
+
+  auto &chunkItems = created[chunk];
+  chunkItems.reserve(last - first);
+  for (auto i = first; i < last; i++)
+  {
+   auto random = streams.Stream(LoadStreams + i);
+   sThreadRandom = &random;
+   chunkItems.push_back(CreateItem(nodes[i]));
+  }
+
+  sThreadRandom = nullptr;
+
+  if (progress)
+  {
+   lock_guard<mutex> lock(progressMutex);
+   done += last - first;
+   if (!progress(double(done) / double(nodes.size())))
+   {
+    cancelled = true;
+   }
+  }
+ });
+
+ if (cancelled)
+ {
+  return false;
+ }
+
+ items.clear();
+ items.reserve(nodes.size());
+ for (auto &chunkItems : created)
+ {
+  for (auto &item : chunkItems)
+  {
+   items.push_back(std::move(item));
+  }
+ }
+
+ return true;
+}
+
+/**
+ * Handle a node of type item.
+ * @param node XML node
+ */
+void Aquarium::XmlItem(wxXmlNode *node)
+{
+ mItems.push_back(CreateItem(node));
+ mIndexesDirty = true;
+ mGridDirty = true;
+ mGroupsDirty = true;
+ if (mKineticActive)
+ {
+  mKinetics.Add(mItems.back().get());
+ }
+}
+
+/**
+ * Clear the aquarium data.
+ *
+ * Deletes all known items in the aquarium.
+ */
+void Aquarium::Clear()
+{
+ mItems.clear();
+ mSelection.clear();
+ mIndexesDirty = true;
+ mGridDirty = true;
+ mGroupsDirty = true;
+ if (mKineticActive)
+ {
+  mKinetics.Start(mItems, mSize);
+ }
+
+ if (mJournal != nullptr)
+ {
+  mJournal->RecordClear();
+ }
+}
+
+/**
+ * Set the size of the aquarium.
+ *
+ * Items outside the new size are moved to its edge.
+ *
+ * @param size New size in pixels
+ */
+void Aquarium::SetSize(const wxSize &size)
+{
+ if (mKineticActive)
+ {
+  mKinetics.LocateAll();
+ }
+
+ mSize = size;
+ for (auto &item : mItems)
+ {
+  item->SetLocation(std::clamp(item->GetX(), 0.0, double(size.GetWidth())),
+          std::clamp(item->GetY(), 0.0, double(size.GetHeight())));
+ }
+
+ mGridDirty = true;
+
+ // The walls moved, so every item's next event did too
+ if (mKineticActive)
+ {
+  mKinetics.Start(mItems, mSize);
+ }
+}
+
+/**
+ * Put an item somewhere else, as when the user drags it.
+ *
+ * Finding and hit testing items see moves made with
+ * Item::SetLocation too, but only this also tells kinetic
+ * motion to move the item on from its new location.
+ *
+ * @param item The item
+ * @param x New X location in pixels
+ * @param y New Y location in pixels
+ */
+void Aquarium::MoveItem(const std::shared_ptr<Item> &item, double x, double y)
+{
+ item->SetLocation(x, y);
+ mGridDirty = true;
+ if (mKineticActive)
+ {
+  mKinetics.Moved(item.get());
+ }
+}
+
+/**
+ * Select the items whose bounds overlap a rectangle, in place
+ * of any selected before. Only the items in the grid cells the
+ * rectangle overlaps are looked at, though the grid is built
+ * again first if the items moved since it was last built.
+ * @param rect Rectangle in pixels. An empty one selects nothing.
+ */
+void Aquarium::Select(const wxRect &rect)
+{
+ mSelection.clear();
+ if (rect.IsEmpty())
+ {
+  return;
+ }
+
+ for (auto i : ItemsIn(rect))
+ {
+  if (mItems[i]->GetBounds().Intersects(rect))
+  {
+   mSelection.push_back(mItems[i]);
+  }
+ }
+}
+
+/**
+ * Select every item, in place of any selected before. Items
+ * outside the aquarium are selected too.
+ */
+void Aquarium::SelectAll()
+{
+ mSelection = mItems;
+}
+
+/**
+ * Is an item selected?
+ * @param item The item
+ * @return true if it is in the selection
+ */
+bool Aquarium::IsSelected(const std::shared_ptr<Item> &item) const
+{
+ return find(begin(mSelection), end(mSelection), item) != end(mSelection);
+}
+
+/**
+ * Find where the selected items are in the drawing order
+ * @return Indexes of the selected items, in increasing order
+ */
+std::vector<size_t> Aquarium::SelectionIndexes() const
+{
+ unordered_set<const Item *> selected;
+ for (auto &item : mSelection)
+ {
+  selected.insert(item.get());
+ }
+
+ vector<size_t> indexes;
+ for (size_t i = 0; i < mItems.size() && indexes.size() < selected.size(); i++)
+ {
+  if (selected.count(mItems[i].get()) != 0)
+  {
+   indexes.push_back(i);
+  }
+ }
+
+ return indexes;
+}
+
+/**
+ * Move every selected item by the same amount, as when the user
+ * drags them. Like MoveItem, this is not journaled until the
+ * user lets go and SelectionMoved is called.
+ * @param dx Distance to move in X in pixels
+ * @param dy Distance to move in Y in pixels
+ */
+void Aquarium::MoveSelection(double dx, double dy)
+{
+ for (auto &item : mSelection)
+ {
+  if (mKineticActive)
+  {
+   // Selected items out of sight may not have been moved on yet
+   mKinetics.Locate(item.get());
+  }
+
+  MoveItem(item, item->GetX() + dx, item->GetY() + dy);
+ }
+}
+
+/**
+ * Tell the aquarium the user has finished moving the selected
+ * items. Their new locations go in the journal as one record.
+ */
+void Aquarium::SelectionMoved()
+{
+ if (mJournal != nullptr && !mSelection.empty())
+ {
+  mJournal->RecordMoves(SelectionIndexes(), mItems);
+ }
+}
+
+/**
+ * Remove the selected items from the aquarium.
+ *
+ * Done in one pass over the items with one journal record,
+ * rather than one of each for every item removed.
+ */
+void Aquarium::RemoveSelection()
+{
+ if (mSelection.empty())
+ {
+  return;
+ }
+
+ auto indexes = SelectionIndexes();
+ if (mJournal != nullptr)
+ {
+  mJournal->RecordRemoves(indexes);
+ }
+
+ if (mKineticActive)
+ {
+  for (auto &item : mSelection)
+  {
+   mKinetics.Remove(item.get());
+  }
+ }
+
+ // Shift the items that stay down over the ones removed
+ size_t kept = 0;
+ auto next = indexes.begin();
+ for (size_t i = 0; i < mItems.size(); i++)
+ {
+  if (next != indexes.end() && *next == i)
+  {
+   next++;
+  }
+  else
+  {
+   mItems[kept++] = std::move(mItems[i]);
+  }
+ }
+
+ mItems.resize(kept);
+ mSelection.clear();
+ mIndexesDirty = true;
+ mGridDirty = true;
+ mGroupsDirty = true;
+}
+
+/**
+ * Move the selected items to the end of the drawing order, so
+ * they are in front of the others. They keep their order among
+ * themselves. Done in one pass with one journal record.
+ */
+void Aquarium::MoveSelectionToEnd()
+{
+ if (mSelection.empty())
+ {
+  return;
+ }
+
+ auto indexes = SelectionIndexes();
+ if (mJournal != nullptr)
+ {
+  mJournal->RecordMovesToEnd(indexes);
+ }
+
+ vector<shared_ptr<Item>> ends;
+ size_t kept = 0;
+ auto next = indexes.begin();
+ for (size_t i = 0; i < mItems.size(); i++)
+ {
+  if (next != indexes.end() && *next == i)
+  {
+   ends.push_back(std::move(mItems[i]));
+   next++;
+  }
+  else
+  {
+   mItems[kept++] = std::move(mItems[i]);
+  }
+ }
+
+ move(ends.begin(), ends.end(), mItems.begin() + kept);
+ mSelection = std::move(ends);
+ mIndexesDirty = true;
+ mGridDirty = true;
+ mGroupsDirty = true;
+}
+
+/**
+ * Turn every selected item to face the other way, with one journal record
+ */
+void Aquarium::MirrorSelection()
+{
+ if (mSelection.empty())
+ {
+  return;
+ }
+
+ if (mJournal != nullptr)
+ {
+  mJournal->RecordMirrors(SelectionIndexes());
+ }
+
+ for (auto &item : mSelection)
+ {
+  if (mKineticActive)
+  {
+   // Turn from where the item is now, then move on from there
+   mKinetics.Locate(item.get());
+   item->Mirror();
+   mKinetics.Moved(item.get());
+  }
+  else
+  {
+   item->Mirror();
+  }
+ }
+
+ mGridDirty = true;
+}
+
+/**
+ * Make fish school with their neighbours, or swim on their own
+ * @param schooling true if fish school
+ */
+void Aquarium::SetSchooling(bool schooling)
+{
+ mSchooling = schooling;
+ UpdateMotion();
+}
+
+/**
+ * Make fish bump into each other and into decor, or swim through
+ * @param collisions true if fish collide
+ */
+void Aquarium::SetCollisions(bool collisions)
+{
+ mCollisions = collisions;
+ UpdateMotion();
+}
+
+/**
+ * Use kinetic motion whenever fish neither school nor collide.
+ *
+ * Items then only move when they reach a wall or something looks
+ * at them, so items nobody can see cost nothing per frame, and
+ * a large elapsed time skips ahead exactly.
+ *
+ * @param kinetic true to use kinetic motion
+ */
+void Aquarium::SetKinetic(bool kinetic)
+{
+ mKinetic = kinetic;
+ UpdateMotion();
+}
+
+/**
+ * Start or stop kinetic motion, if whether it can be used changed
+ */
+void Aquarium::UpdateMotion()
+{
+ bool active = mKinetic && !mSchooling && !mCollisions;
+ if (active && !mKineticActive)
+ {
+  mKinetics.Start(mItems, mSize);
+ }
+ else if (!active && mKineticActive)
+ {
+  // Every item is put where it is now, to move on frame by frame
+  mKinetics.Stop();
+  mGridDirty = true;
+ }
+
+ mKineticActive = active;
+}
+
+/**
+ * Move the aquarium on by the real time since it was last moved on.
+ *
+ * The aquarium keeps its own clock, so however many views draw it,
+ * and however often they do, the fish swim at the same speed. Call
+ * this once per tick from whatever runs the simulation.
+ *
+ * @return The time the aquarium was moved on by, in seconds
+ */
+double Aquarium::Advance()
+{
+ auto now = std::chrono::steady_clock::now();
+ auto elapsed = std::chrono::duration<double>(now - mAdvanced).count();
+ mAdvanced = now;
+
+ Update(elapsed);
+ return elapsed;
+}
+
+/**
+ * Restart the clock Advance uses, so time that passed while
+ * something else drove the aquarium is not simulated again
+ */
+void Aquarium::RestartClock()
+{
+ mAdvanced = std::chrono::steady_clock::now();
+}
+
+/**
+ * Handle updates for animation
+ *
+ * With kinetic motion, only the events due by now are handled
+ * and items are moved when something looks at them.
+ *
+ * @param elapsed The time since the last update
+ */
+void Aquarium::Update(double elapsed)
+{
+ mTime += elapsed;
+
+ if (mKineticActive)
+ {
+  mKinetics.AdvanceTo(mKinetics.GetTime() + elapsed);
+  return;
+ }
+
+ GroupItems();
+ if (mSchooling)
+ {
+  // Fish steer by where their neighbours were before any of them moved
+  mSchool.Clear();
+  for (auto fish : mFish)
+  {
+   fish->JoinSchool(&mSchool);
+  }
+  mSchool.Build();
+ }
+
+ // Fish::Update is final, so this loop makes no virtual calls
+ for (auto fish : mFish)
+ {
+  fish->Update(*this, elapsed);
+ }
+
+ for (auto item : mOthers)
+ {
+  item->Update(*this, elapsed);
+ }
+
+ if (mCollisions)
+ {
+  Collide();
+ }
+
+ // The grid is built again when it is next looked at
+ mGridDirty = true;
+}
+
+/**
+ * Split the items into the fish and the rest, if they have
+ * changed since the last time. Each list keeps drawing order.
+ */
+void Aquarium::GroupItems()
+{
+ if (!mGroupsDirty)
+ {
+  return;
+ }
+
+ mFish.clear();
+ mOthers.clear();
+ for (auto &item : mItems)
+ {
+  if (auto fish = dynamic_cast<Fish*>(item.get()))
+  {
+   mFish.push_back(fish);
+  }
+  else
+  {
+   mOthers.push_back(item.get());
+  }
+ }
+
+ mGroupsDirty = false;
+}
+
+/**
+ * Make solid items that touch bounce off each other.
+ *
+ * A sweep and prune over the bounds of the solid items finds the
+ * pairs that might touch, then their images are compared to see if
+ * the solid parts really do. Items that stay put are not compared
+ * with each other.
+ */
+void Aquarium::Collide()
+{
+ mSolids.clear();
+ mSolidBounds.clear();
+ for (size_t i = 0; i < mItems.size(); i++)
+ {
+  if (mItems[i]->IsSolid())
+  {
+   mSolids.push_back(i);
+   mSolidBounds.push_back(mItems[i]->GetBounds());
+  }
+ }
+
+ for (auto &pair : mSweep.FindPairs(mSolidBounds))
+ {
+  auto &item1 = mItems[mSolids[pair.first]];
+  auto &item2 = mItems[mSolids[pair.second]];
+  double speedX1, speedY1, speedX2, speedY2;
+  bool moves1 = item1->GetSpeed(&speedX1, &speedY1);
+  bool moves2 = item2->GetSpeed(&speedX2, &speedY2);
+  wxRealPoint contact;
+  if ((!moves1 && !moves2) || !item1->Touches(*item2, &contact))
+  {
+   continue;
+  }
+
+  // Moving items push apart along the line between them. An
+  // item that stays put pushes away from where they touch.
+  if (moves1 && moves2)
+  {
+   double normalX = item1->GetX() - item2->GetX();
+   double normalY = item1->GetY() - item2->GetY();
+   item1->Bounce(normalX, normalY, speedX2, speedY2, true);
+   item2->Bounce(-normalX, -normalY, speedX1, speedY1, true);
+  }
+  else if (moves1)
+  {
+   item1->Bounce(item1->GetX() - contact.x, item1->GetY() - contact.y, 0, 0, false);
+  }
+  else
+  {
+   item2->Bounce(item2->GetX() - contact.x, item2->GetY() - contact.y, 0, 0, false);
+  }
+ }
+}
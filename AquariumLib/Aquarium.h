@@ -1,59 +1,294 @@
-/**
- * @file Aquarium.h
- * @author Evan Gasper
- *
- * The Aquarium class holding all relevant aquarium
- * information
- */
- 
-#ifndef AQUARIUM_H
-#define AQUARIUM_H
-
-#include <memory>
-#include <random>
-#include "Item.h"
-
-/**
- * Main Aquarium class used to construct, allocate, and draw
- */
-class Aquarium {
-private:
- /// The Aquarium class now has a place to remember that image it will draw as a background
- std::unique_ptr<wxBitmap> mBackground; ///< Background image being used
- /// List of all fish in the Aquarium
- std::vector<std::shared_ptr<Item>> mItems;
- /// Random number generator
- std::mt19937 mRandom;
-public:
- Aquarium();
- void OnDraw(wxDC* dc);
- void Add(std::shared_ptr<Item> item);
- std::shared_ptr<Item> HitTest(int x, int y);
- void MoveItemToEnd(std::shared_ptr<Item> item);
- void Save(const wxString& filename);
- void Load(const wxString& filename);
- void XmlItem(wxXmlNode* node);
- void Clear();
- void Update(double elapsed);
- /**
- * Get the random number generator
- * @return Pointer to the random number generator
- */
- std::mt19937 &GetRandom() {return mRandom;}
-
- /**
- * Get the width of the aquarium
- * @return Aquarium width in pixels
- */
- int GetWidth() const { return mBackground->GetWidth(); }
-
- /**
-  * Get the height of the aquarium
-  * @return Aquarium height in pixels
-  */
- int GetHeight() const { return mBackground->GetHeight(); }
-};
-
-
-
-#endif //AQUARIUM_H
+/**
+ * @file Aquarium.h
+ * @author Evan Gasper
+ *
+ * The Aquarium class holding all relevant aquarium
+ * information
+ */
+ 
+#ifndef AQUARIUM_H
+#define AQUARIUM_H
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <unordered_map>
+#include "Item.h"
+#include "Sprite.h"
+#include "AssetProvider.h"
+#include "ProgressStream.h"
+#include "AquariumJournal.h"
+#include "SpatialGrid.h"
+#include "School.h"
+#include "SweepAndPrune.h"
+#include "Kinetics.h"
+#include "CounterRandom.h"
+
+class Fish;
+
+/**
+ * Main Aquarium class used to construct, allocate, and draw
+ */
+class Aquarium {
+public:
+ /// How much detail items are drawn with
+ enum class Detail {
+  Full,         ///< Items drawn with their own images
+  Reduced,      ///< Items drawn with half size images
+  Impostor      ///< Items drawn as half size rectangles of their colour
+ };
+
+ /// Where items added in bulk are put
+ enum class Spread {
+  Uniform,      ///< Anywhere in the aquarium, all places as likely
+  Centred       ///< Bunched around the middle of the aquarium
+ };
+
+ /// Memory the aquarium takes up, by what it is used for
+ struct Memory {
+  size_t mItems = 0;        ///< The item objects
+  size_t mPixels = 0;       ///< Images, bitmaps and masks of the sprites drawn
+  size_t mContainers = 0;   ///< Lists, grids and tables of the items
+  size_t mXml = 0;          ///< XML documents loads and saves are holding now
+
+  /**
+   * Get the memory used for everything
+   * @return Size in bytes
+   */
+  size_t GetTotal() const { return mItems + mPixels + mContainers + mXml; }
+ };
+
+private:
+ /// Where the images of the background and items come from
+ std::shared_ptr<AssetProvider> mAssets;
+ /// The Aquarium class now has a place to remember that image it will draw as a background
+ std::shared_ptr<Sprite> mBackground; ///< Background image being used
+ /// List of all fish in the Aquarium
+ std::vector<std::shared_ptr<Item>> mItems;
+ /// Random number generator
+ CounterRandom mRandom;
+ /// Generator used instead of mRandom by items created on this
+ /// thread, so worker threads never share mRandom
+ static thread_local CounterRandom *sThreadRandom;
+ /// Bytes the XML documents of this aquarium's loads and saves take
+ /// up while they are held. Loads and saves run in the background.
+ std::atomic<size_t> mXmlMemory{0};
+ /// Journal of edits since the aquarium was last saved or loaded
+ std::unique_ptr<AquariumJournal> mJournal;
+ /// Detail items are drawn with this frame
+ Detail mDetail = Detail::Full;
+ /// Size of the aquarium in pixels
+ wxSize mSize;
+ /// Grid of the items, for finding the ones that can be seen
+ SpatialGrid mGrid;
+ /// Bounds of each item when the grid was built
+ std::vector<wxRect> mBounds;
+ /// True if items were added, removed or moved since mGrid was built
+ bool mGridDirty = true;
+ /// Item::GetMoves when mGrid was built
+ unsigned long long mGridMoves = 0;
+ /// Grid of the decor that hides what is behind it, for the last draw
+ SpatialGrid mOccluderGrid;
+ /// Positions of the hiding decor among the items looked at in the last draw
+ std::vector<size_t> mOccluders;
+ /// Bounds of the hiding decor, for building mOccluderGrid
+ std::vector<wxRect> mOccluderBounds;
+ /// True if fish school
+ bool mSchooling = false;
+ /// Where the schooling fish were at the start of this step
+ School mSchool;
+ /// True if fish bump into each other and into decor
+ bool mCollisions = false;
+ /// Finds solid items whose bounds overlap
+ SweepAndPrune mSweep;
+ /// Numbers of the solid items, for the last collision check
+ std::vector<size_t> mSolids;
+ /// Bounds of the solid items, for the last collision check
+ std::vector<wxRect> mSolidBounds;
+
+ /// True if kinetic motion was asked for
+ bool mKinetic = false;
+ /// True if mKinetics is moving the items. Kinetic motion is
+ /// only used while fish neither school nor collide, since
+ /// then they swim in straight lines between walls.
+ bool mKineticActive = false;
+ /// Moves items between events while kinetic motion is in use.
+ /// Where items are is worked out lazily, even by const methods.
+ mutable Kinetics mKinetics;
+ /// Simulated seconds since the aquarium was created
+ double mTime = 0;
+ /// When Advance last moved the aquarium on
+ std::chrono::steady_clock::time_point mAdvanced = std::chrono::steady_clock::now();
+
+ /// Items found by the last kinetic query
+ std::vector<Item*> mFound;
+ /// Number of each item in mItems, for putting found items in drawing order
+ std::unordered_map<const Item*, size_t> mIndexes;
+ /// True if items were added, removed or reordered since mIndexes was made
+ bool mIndexesDirty = true;
+ /// The fish, in drawing order. Fish only differ in their species, so
+ /// they are all stepped by the same non-virtual Fish::Update.
+ std::vector<Fish*> mFish;
+ /// The items that are not fish, in drawing order
+ std::vector<Item*> mOthers;
+ /// True if items were added, removed or reordered since mFish and mOthers were made
+ bool mGroupsDirty = true;
+ /// Items the user has selected
+ std::vector<std::shared_ptr<Item>> mSelection;
+
+ void Collide();
+ void UpdateMotion();
+ void GroupItems();
+ std::vector<size_t> SelectionIndexes() const;
+ static bool WriteXml(const wxXmlDocument& xmlDoc, const wxString& filename,
+         const ProgressCallback& progress);
+public:
+ explicit Aquarium(std::shared_ptr<AssetProvider> assets = nullptr);
+ void OnDraw(wxDC* dc);
+ void OnDraw(Renderer* renderer, const wxRect& visible);
+ void Add(std::shared_ptr<Item> item);
+ void AddBulk(const wxString& type, size_t count, Spread spread = Spread::Uniform);
+ std::shared_ptr<Item> HitTest(int x, int y);
+ void MoveItemToEnd(std::shared_ptr<Item> item);
+ void Remove(std::shared_ptr<Item> item);
+ void ItemMoved(std::shared_ptr<Item> item);
+ void Save(const wxString& filename);
+ void Load(const wxString& filename);
+ std::unique_ptr<wxXmlDocument> XmlDocument();
+ std::shared_ptr<const std::vector<ItemState>> Snapshot() const;
+ static bool WriteSnapshot(const std::vector<ItemState>& snapshot, const wxString& filename,
+         const ProgressCallback& progress = nullptr);
+ bool WriteDocument(const wxXmlDocument& xmlDoc, const wxString& filename,
+         const ProgressCallback& progress = nullptr);
+ bool LoadItems(const wxString& filename, std::vector<std::shared_ptr<Item>>& items,
+         const ProgressCallback& progress = nullptr,
+         std::unique_ptr<AquariumJournal>* journal = nullptr);
+ void SetItems(std::vector<std::shared_ptr<Item>>&& items);
+ void SetJournal(std::unique_ptr<AquariumJournal> journal);
+ long long BeginSave(const wxString& filename);
+ void EndSave(long long sequence, bool succeeded);
+ bool NeedsCompaction() const;
+ std::shared_ptr<Item> CreateItem(wxXmlNode* node);
+ std::shared_ptr<Item> CreateItem(const wxString& type);
+ bool CreateItems(const std::vector<wxXmlNode*>& nodes, std::vector<std::shared_ptr<Item>>& items,
+         const ProgressCallback& progress = nullptr);
+ bool CreateItems(const wxXmlDocument& xmlDoc, std::vector<std::shared_ptr<Item>>& items,
+         const ProgressCallback& progress = nullptr);
+ void XmlItem(wxXmlNode* node);
+ void Clear();
+ void Update(double elapsed);
+ double Advance();
+ void RestartClock();
+
+ /**
+  * Get how long the aquarium has been simulated for
+  * @return Simulated time in seconds
+  */
+ double GetTime() const { return mTime; }
+ std::vector<size_t> ItemsIn(const wxRect& rect);
+ Detail ChooseDetail(const std::vector<size_t>& items, const wxRect& visible) const;
+ Memory GetMemory() const;
+ static size_t XmlMemory(const wxXmlDocument& xmlDoc);
+ std::vector<bool> FindHidden(const std::vector<size_t>& items);
+ void SetSize(const wxSize& size);
+ void MoveItem(const std::shared_ptr<Item>& item, double x, double y);
+ void Select(const wxRect& rect);
+ void SelectAll();
+ bool IsSelected(const std::shared_ptr<Item>& item) const;
+ void MoveSelection(double dx, double dy);
+ void SelectionMoved();
+ void RemoveSelection();
+ void MoveSelectionToEnd();
+ void MirrorSelection();
+
+ /**
+  * Get the items the user has selected
+  * @return The selected items
+  */
+ const std::vector<std::shared_ptr<Item>>& GetSelection() const { return mSelection; }
+ void SetSchooling(bool schooling);
+ void SetCollisions(bool collisions);
+ void SetKinetic(bool kinetic);
+
+ /**
+  * Do fish school?
+  * @return true if fish school with their neighbours
+  */
+ bool IsSchooling() const { return mSchooling; }
+
+ /**
+  * Get where the schooling fish were at the start of this step
+  * @return The school, or null if fish do not school
+  */
+ const School* GetSchool() const { return mSchooling ? &mSchool : nullptr; }
+
+ /**
+  * Do fish collide?
+  * @return true if fish bump into each other and into decor
+  */
+ bool IsCollisions() const { return mCollisions; }
+
+ /**
+  * Was kinetic motion asked for?
+  * @return true if items move only when something happens to them,
+  * whenever fish neither school nor collide
+  */
+ bool IsKinetic() const { return mKinetic; }
+
+ /**
+  * Get the detail items are being drawn with
+  * @return Level of detail chosen for this frame
+  */
+ Detail GetDetail() const { return mDetail; }
+
+ /**
+  * Get the number of items
+  * @return Number of items in the aquarium
+  */
+ size_t GetCount() const { return mItems.size(); }
+
+ /**
+ * Get the random number generator
+ *
+ * Items created by a parallel load get a generator of their
+ * own rather than the aquarium's.
+ *
+ * @return Pointer to the random number generator
+ */
+ CounterRandom &GetRandom() {return sThreadRandom != nullptr ? *sThreadRandom : mRandom;}
+
+ /**
+  * Get the file edits are being journaled to
+  * @return The .aqua filename, or empty if not journaling
+  */
+ wxString GetFilename() const { return mJournal != nullptr ? mJournal->GetFilename() : wxString(); }
+
+ /**
+ * Get the width of the aquarium
+ * @return Aquarium width in pixels
+ */
+ int GetWidth() const { return mSize.GetWidth(); }
+
+ /**
+  * Get the height of the aquarium
+  * @return Aquarium height in pixels
+  */
+ int GetHeight() const { return mSize.GetHeight(); }
+
+ /**
+  * Get the size of the background image
+  * @return Background size in pixels
+  */
+ wxSize GetBackgroundSize() const { return mBackground->GetSize(); }
+
+ /**
+  * Get where the images of the background and items come from
+  * @return The asset provider
+  */
+ AssetProvider& GetAssets() const { return *mAssets; }
+};
+
+
+
+#endif //AQUARIUM_H
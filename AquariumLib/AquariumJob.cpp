@@ -0,0 +1,103 @@
+/**
+ * @file AquariumJob.cpp
+ * @author Evan Gasper
+ */
+
+#include "pch.h"
+#include "AquariumJob.h"
+
+/**
+ * Constructor
+ * @param handler Handler to notify when the job finishes, may be null
+ * @param name Description shown while the job runs
+ * @param work The work to run on the background thread
+ * @param completion Optional function to run on the UI thread when the work is done
+ */
+AquariumJob::AquariumJob(wxEvtHandler *handler, const wxString &name, Work work,
+        Completion completion) :
+    mHandler(handler), mName(name), mWork(std::move(work)), mCompletion(std::move(completion))
+{
+}
+
+/**
+ * Destructor
+ *
+ * Cancels the job and waits for the thread so the
+ * work never outlives the objects it refers to.
+ */
+AquariumJob::~AquariumJob()
+{
+ Cancel();
+ if (mThread.joinable())
+ {
+  mThread.join();
+ }
+}
+
+/**
+ * Start the job on its own thread
+ */
+void AquariumJob::Start()
+{
+ mThread = std::thread(&AquariumJob::Run, this);
+}
+
+/**
+ * Wait for the job to finish
+ * @return true if the work succeeded
+ */
+bool AquariumJob::Wait()
+{
+ if (mThread.joinable())
+ {
+  mThread.join();
+ }
+
+ return mSucceeded;
+}
+
+/**
+ * Wait for the job and run its completion function.
+ *
+ * Call this on the UI thread when the job's completion
+ * event arrives.
+ */
+void AquariumJob::Complete()
+{
+ Wait();
+ if (mCompletion)
+ {
+  mCompletion(*this);
+ }
+}
+
+/**
+ * Get a progress callback for the work function to pass on.
+ *
+ * The callback records the progress in this job and
+ * returns false once the job has been cancelled.
+ *
+ * @return Progress callback
+ */
+ProgressCallback AquariumJob::Progress()
+{
+ return [this](double progress) {
+  SetProgress(progress);
+  return !IsCancelled();
+ };
+}
+
+/**
+ * Thread function that runs the work and posts the completion event
+ */
+void AquariumJob::Run()
+{
+ mSucceeded = mWork(*this) && !mCancelled;
+ mProgress = 1;
+ mDone = true;
+
+ if (mHandler != nullptr)
+ {
+  wxQueueEvent(mHandler, new wxThreadEvent(wxEVT_THREAD));
+ }
+}
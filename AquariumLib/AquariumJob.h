@@ -0,0 +1,122 @@
+/**
+ * @file AquariumJob.h
+ * @author Evan Gasper
+ *
+ * A load or save that runs on a background thread
+ */
+
+#ifndef AQUARIUMJOB_H
+#define AQUARIUMJOB_H
+
+#include <atomic>
+#include <functional>
+#include <thread>
+#include "ProgressStream.h"
+
+/**
+ * A long running operation that runs off the UI thread.
+ *
+ * The work function runs on its own thread. It reports progress
+ * through SetProgress and should stop early once IsCancelled
+ * returns true. When it finishes, a wxEVT_THREAD event is queued
+ * to the handler, which calls Complete on the UI thread to pick up
+ * the result.
+ */
+class AquariumJob {
+public:
+ /// Work function, returns true on success
+ typedef std::function<bool(AquariumJob&)> Work;
+
+ /// Completion function, run on the UI thread once the work is done
+ typedef std::function<void(AquariumJob&)> Completion;
+
+private:
+ /// Handler notified when the job finishes, may be null
+ wxEvtHandler *mHandler;
+
+ /// Description shown while the job runs
+ wxString mName;
+
+ /// The work this job does
+ Work mWork;
+
+ /// Run by Complete once the work is done, may be empty
+ Completion mCompletion;
+
+ /// The thread running the work
+ std::thread mThread;
+
+ /// Set when the job has been asked to stop
+ std::atomic<bool> mCancelled{false};
+
+ /// Set when the work function has returned
+ std::atomic<bool> mDone{false};
+
+ /// Result of the work function
+ std::atomic<bool> mSucceeded{false};
+
+ /// Fraction of the work complete
+ std::atomic<double> mProgress{0};
+
+ void Run();
+
+public:
+ AquariumJob(wxEvtHandler *handler, const wxString &name, Work work,
+         Completion completion = nullptr);
+ ~AquariumJob();
+
+ /// Copy constructor (disabled)
+ AquariumJob(const AquariumJob &) = delete;
+
+ /// Assignment operator (disabled)
+ void operator=(const AquariumJob &) = delete;
+
+ void Start();
+ bool Wait();
+ void Complete();
+
+ /**
+  * Ask the job to stop as soon as possible
+  */
+ void Cancel() { mCancelled = true; }
+
+ /**
+  * Has the job been asked to stop?
+  * @return true if cancelled
+  */
+ bool IsCancelled() const { return mCancelled; }
+
+ /**
+  * Has the work function returned?
+  * @return true if the job is finished
+  */
+ bool IsDone() const { return mDone; }
+
+ /**
+  * Did the work succeed?
+  * @return true if the work finished successfully and was not cancelled
+  */
+ bool IsSucceeded() const { return mSucceeded; }
+
+ /**
+  * Set the fraction of the work complete
+  * @param progress Progress from 0 to 1
+  */
+ void SetProgress(double progress) { mProgress = progress; }
+
+ /**
+  * Get the fraction of the work complete
+  * @return Progress from 0 to 1
+  */
+ double GetProgress() const { return mProgress; }
+
+ ProgressCallback Progress();
+
+ /**
+  * Get the description of this job
+  * @return Job description
+  */
+ const wxString &GetName() const { return mName; }
+};
+
+#endif //AQUARIUMJOB_H
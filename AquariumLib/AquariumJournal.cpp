@@ -0,0 +1,604 @@
+/**
+ * @file AquariumJournal.cpp
+ * @author Evan Gasper
+ */
+
+#include "pch.h"
+#include "AquariumJournal.h"
+#include "Aquarium.h"
+#include "AttributeCodec.h"
+#include <algorithm>
+#include <random>
+#include <wx/filefn.h>
+#include <wx/tokenzr.h>
+
+using namespace std;
+
+/// First word of the journal file, followed by the journal id
+const wxString JournalHeader = L"aquajournal";
+
+/// Name of the processing instruction that marks the base file
+const wxString JournalMarkName = L"aqua-journal";
+
+/**
+ * Constructor for a new journal.
+ *
+ * The journal gets a new id and starts empty. Nothing is
+ * written until Trim is called once the base file is saved.
+ *
+ * @param filename The base .aqua file this journal goes with
+ */
+AquariumJournal::AquariumJournal(const wxString &filename) : mFilename(filename)
+{
+ std::random_device rd;
+ mId = wxString::Format(L"%08x%08x", rd(), rd());
+}
+
+/**
+ * Constructor for a journal that continues an existing base file
+ * @param filename The base .aqua file this journal goes with
+ * @param id The journal id the base file is marked with
+ * @param sequence The last sequence number the base file includes
+ */
+AquariumJournal::AquariumJournal(const wxString &filename, const wxString &id, long long sequence) :
+    mFilename(filename), mId(id), mSequence(sequence)
+{
+}
+
+/**
+ * Get the name of the journal file for a base file
+ * @param filename The base .aqua filename
+ * @return The journal filename
+ */
+wxString AquariumJournal::JournalFilename(const wxString &filename)
+{
+ return filename + L".journal";
+}
+
+/**
+ * Mark an XML document with this journal's id and sequence number.
+ *
+ * The mark is a processing instruction ahead of the root node,
+ * so it does not change the aquarium data itself.
+ *
+ * @param xmlDoc The document about to be saved as the base file
+ */
+void AquariumJournal::XmlMark(wxXmlDocument *xmlDoc) const
+{
+ xmlDoc->AppendToProlog(new wxXmlNode(wxXML_PI_NODE, JournalMarkName,
+         wxString::Format(L"%s %lld", mId, mSequence)));
+}
+
+/**
+ * Replay the journal for a base file onto the items loaded from it.
+ *
+ * Only records newer than the base file, from a journal with the
+ * same id, are applied. Replay stops at the first record that can
+ * not be applied, such as a line cut off by a crash, and keeps the
+ * rest of the file for Resume to set aside.
+ *
+ * This only reads the journal file, so it is safe on a background
+ * thread while another journal still has the file open. Call Resume
+ * on the returned journal before recording to it.
+ *
+ * @param xmlDoc The loaded base file
+ * @param filename The base .aqua filename
+ * @param aquarium The aquarium used to create added items
+ * @param items The items loaded from the base file, updated in place
+ * @return The journal to continue with, or null if the base file is not marked
+ */
+std::unique_ptr<AquariumJournal> AquariumJournal::Replay(const wxXmlDocument &xmlDoc,
+        const wxString &filename, Aquarium *aquarium, std::vector<std::shared_ptr<Item>> &items)
+{
+ // Find the mark in the prolog of the base file
+ wxString id;
+ long long sequence = 0;
+ for (auto node = xmlDoc.GetDocumentNode()->GetChildren(); node; node = node->GetNext())
+ {
+  if (node->GetType() == wxXML_PI_NODE && node->GetName() == JournalMarkName)
+  {
+   wxStringTokenizer tokens(node->GetContent(), L" ");
+   id = tokens.GetNextToken();
+   tokens.GetNextToken().ToLongLong(&sequence);
+  }
+ }
+
+ if (id.empty())
+ {
+  // Files saved before journaling have nothing to replay
+  return nullptr;
+ }
+
+ auto journal = make_unique<AquariumJournal>(filename, id, sequence);
+
+ auto name = JournalFilename(filename);
+ wxString contents;
+ if (wxFileExists(name))
+ {
+  wxFFile file(name, "r");
+  if (!file.IsOpened() || !file.ReadAll(&contents))
+  {
+   contents.clear();
+  }
+ }
+
+ // Only complete lines count, a crash may have cut off the last one
+ size_t start = contents.find(L'\n');
+ if (start == wxString::npos || contents.substr(0, start) != JournalHeader + L" " + id)
+ {
+  // A journal for some other save of the file
+  journal->mUnreplayed = contents;
+ }
+ else
+ {
+  for (start++; start < contents.length(); )
+  {
+   auto end = contents.find(L'\n', start);
+   if (end == wxString::npos)
+   {
+    journal->mUnreplayed = contents.substr(start);
+    break;
+   }
+
+   wxString line = contents.substr(start, end - start);
+   start = end + 1;
+
+   auto space = line.find(L' ');
+   long long recordSequence;
+   if (space == wxString::npos || !wxString(line.substr(0, space)).ToLongLong(&recordSequence))
+   {
+    journal->mUnreplayed = contents.substr(start - line.length() - 1);
+    break;
+   }
+
+   if (recordSequence <= journal->mSequence)
+   {
+    // Already in the base file
+    continue;
+   }
+
+   if (!Apply(line.substr(space + 1), aquarium, items))
+   {
+    journal->mUnreplayed = contents.substr(start - line.length() - 1);
+    break;
+   }
+
+   journal->mSequence = recordSequence;
+   journal->mRecords.emplace_back(recordSequence, line + L"\n");
+  }
+ }
+
+ return journal;
+}
+
+/**
+ * Continue journaling to the file after Replay.
+ *
+ * Any lines Replay could not apply are first appended to
+ * filename.aqua.journal.rejected, so they are never lost from disk.
+ * The journal file is then rewritten with just the records that were
+ * applied and kept open for appending.
+ *
+ * Call this on the UI thread, once any other journal that may have
+ * the same file open has been closed.
+ *
+ * @return true if successful
+ */
+bool AquariumJournal::Resume()
+{
+ if (!mUnreplayed.empty())
+ {
+  wxFFile file(JournalFilename(mFilename) + L".rejected", "a");
+  if (!file.IsOpened() || !file.Write(mUnreplayed) || !file.Close())
+  {
+   return false;
+  }
+
+  mUnreplayed.clear();
+ }
+
+ // Replay only kept records newer than the base file
+ return Trim(0);
+}
+
+/**
+ * Apply one journal record to a list of items
+ * @param record The record, without its sequence number
+ * @param aquarium The aquarium used to create added items
+ * @param items The items to apply the record to
+ * @return true if the record was applied
+ */
+bool AquariumJournal::Apply(const wxString &record, Aquarium *aquarium,
+        std::vector<std::shared_ptr<Item>> &items)
+{
+ wxStringTokenizer tokens(record, L" ");
+ auto op = tokens.GetNextToken();
+
+ if (op == L"add")
+ {
+  // The attributes the item saves itself with, as name=value
+  wxXmlNode node(wxXML_ELEMENT_NODE, L"item");
+  while (tokens.HasMoreTokens())
+  {
+   auto token = tokens.GetNextToken();
+   auto equals = token.find(L'=');
+   if (equals == wxString::npos)
+   {
+    return false;
+   }
+
+   node.AddAttribute(token.substr(0, equals), token.substr(equals + 1));
+  }
+
+  items.push_back(aquarium->CreateItem(&node));
+  return true;
+ }
+
+ if (op == L"clear")
+ {
+  items.clear();
+  return true;
+ }
+
+ // Records for edits to many items at once
+ if (op == L"moves")
+ {
+  while (tokens.HasMoreTokens())
+  {
+   unsigned long index;
+   double x, y;
+   if (!tokens.GetNextToken().ToULong(&index) || index >= items.size() ||
+       !AttributeCodec::Parse(tokens.GetNextToken(), &x) || !AttributeCodec::Parse(tokens.GetNextToken(), &y))
+   {
+    return false;
+   }
+
+   items[index]->SetLocation(x, y);
+  }
+
+  return true;
+ }
+
+ if (op == L"removes" || op == L"ends" || op == L"mirrors")
+ {
+  vector<bool> flags;
+  if (!ParseIndexes(tokens, items.size(), &flags))
+  {
+   return false;
+  }
+
+  if (op == L"removes")
+  {
+   size_t kept = 0;
+   for (size_t i = 0; i < items.size(); i++)
+   {
+    if (!flags[i])
+    {
+     items[kept++] = std::move(items[i]);
+    }
+   }
+
+   items.resize(kept);
+  }
+  else if (op == L"ends")
+  {
+   vector<shared_ptr<Item>> ends;
+   size_t kept = 0;
+   for (size_t i = 0; i < items.size(); i++)
+   {
+    if (flags[i])
+    {
+     ends.push_back(std::move(items[i]));
+    }
+    else
+    {
+     items[kept++] = std::move(items[i]);
+    }
+   }
+
+   move(ends.begin(), ends.end(), items.begin() + kept);
+  }
+  else
+  {
+   for (size_t i = 0; i < items.size(); i++)
+   {
+    if (flags[i])
+    {
+     items[i]->Mirror();
+    }
+   }
+  }
+
+  return true;
+ }
+
+ unsigned long index;
+ if (!tokens.GetNextToken().ToULong(&index) || index >= items.size())
+ {
+  return false;
+ }
+
+ if (op == L"move")
+ {
+  double x, y;
+  if (!AttributeCodec::Parse(tokens.GetNextToken(), &x) || !AttributeCodec::Parse(tokens.GetNextToken(), &y))
+  {
+   return false;
+  }
+
+  items[index]->SetLocation(x, y);
+  return true;
+ }
+
+ if (op == L"remove")
+ {
+  items.erase(items.begin() + index);
+  return true;
+ }
+
+ if (op == L"end")
+ {
+  rotate(items.begin() + index, items.begin() + index + 1, items.end());
+  return true;
+ }
+
+ return false;
+}
+
+/**
+ * Drop records the base file now includes and rewrite the journal.
+ *
+ * Call this once a base file holding everything up to sequence has
+ * been written. The journal file is replaced with one holding only
+ * the newer records, and is then kept open for appending.
+ *
+ * @param sequence The last sequence number the base file includes
+ * @return true if successful
+ */
+bool AquariumJournal::Trim(long long sequence)
+{
+ mRecords.erase(remove_if(mRecords.begin(), mRecords.end(),
+         [sequence](const std::pair<long long, wxString> &record) { return record.first <= sequence; }),
+         mRecords.end());
+
+ mFile.Close();
+
+ auto name = JournalFilename(mFilename);
+ auto tempname = name + L".tmp";
+ {
+  wxFFile file(tempname, "w");
+  if (!file.IsOpened())
+  {
+   return false;
+  }
+
+  file.Write(JournalHeader + L" " + mId + L"\n");
+  for (auto &record : mRecords)
+  {
+   file.Write(record.second);
+  }
+
+  if (!file.Close())
+  {
+   return false;
+  }
+ }
+
+ if (!wxRenameFile(tempname, name, true))
+ {
+  wxRemoveFile(tempname);
+  return false;
+ }
+
+ return mFile.Open(name, "a");
+}
+
+/**
+ * Append a record to the journal.
+ *
+ * The record is flushed right away so an edit is on disk
+ * as soon as it is made.
+ *
+ * @param record The record, without its sequence number
+ */
+void AquariumJournal::Append(const wxString &record)
+{
+ auto line = Sequence(record);
+ if (mFile.IsOpened())
+ {
+  mFile.Write(line);
+  mFile.Flush();
+ }
+}
+
+/**
+ * Give a record the next sequence number and keep it
+ * until the base file includes it
+ * @param record The record, without its sequence number
+ * @return The line to write to the journal file
+ */
+wxString AquariumJournal::Sequence(const wxString &record)
+{
+ mSequence++;
+ auto line = wxString::Format(L"%lld %s\n", mSequence, record);
+ mRecords.emplace_back(mSequence, line);
+ return line;
+}
+
+/**
+ * Record an item added to the end of the aquarium
+ * @param item The item that was added
+ */
+void AquariumJournal::RecordAdd(Item *item)
+{
+ Append(AddRecord(item));
+}
+
+/**
+ * Record many items added to the end of the aquarium at once.
+ *
+ * Each item gets a record of its own, as RecordAdd would make,
+ * but the journal file is only written and flushed once.
+ *
+ * @param items All the items in the aquarium, in drawing order
+ * @param first Index of the first item added, the rest follow it
+ */
+void AquariumJournal::RecordAdds(const std::vector<std::shared_ptr<Item>> &items, size_t first)
+{
+ wxString lines;
+ for (auto i = first; i < items.size(); i++)
+ {
+  lines += Sequence(AddRecord(items[i].get()));
+ }
+
+ if (mFile.IsOpened() && !lines.empty())
+ {
+  mFile.Write(lines);
+  mFile.Flush();
+ }
+}
+
+/**
+ * Make the record of an item added
+ * @param item The item that was added
+ * @return The record, without its sequence number
+ */
+wxString AquariumJournal::AddRecord(Item *item)
+{
+ // Record the same attributes the item saves itself with
+ wxXmlNode parent(wxXML_ELEMENT_NODE, L"aqua");
+ auto node = item->XmlSave(&parent);
+
+ wxString record = L"add";
+ for (auto attr = node->GetAttributes(); attr; attr = attr->GetNext())
+ {
+  record += L" " + attr->GetName() + L"=" + attr->GetValue();
+ }
+
+ return record;
+}
+
+/**
+ * Record an item moved to a new location
+ * @param index Index of the item in drawing order
+ * @param x New X location in pixels
+ * @param y New Y location in pixels
+ */
+void AquariumJournal::RecordMove(size_t index, double x, double y)
+{
+ Append(wxString::Format(L"move %lu ", (unsigned long)index) +
+         AttributeCodec::Format(x) + L" " + AttributeCodec::Format(y));
+}
+
+/**
+ * Record an item removed from the aquarium
+ * @param index Index of the item in drawing order
+ */
+void AquariumJournal::RecordRemove(size_t index)
+{
+ Append(wxString::Format(L"remove %lu", (unsigned long)index));
+}
+
+/**
+ * Record an item moved to the end of the drawing order
+ * @param index Index of the item before it was moved
+ */
+void AquariumJournal::RecordMoveToEnd(size_t index)
+{
+ Append(wxString::Format(L"end %lu", (unsigned long)index));
+}
+
+/**
+ * Record all items removed from the aquarium
+ */
+void AquariumJournal::RecordClear()
+{
+ Append(L"clear");
+}
+
+/**
+ * Record many items moved to new locations, as one record
+ * @param indexes Indexes of the items in drawing order
+ * @param items The items in the aquarium, in drawing order
+ */
+void AquariumJournal::RecordMoves(const std::vector<size_t> &indexes, const std::vector<std::shared_ptr<Item>> &items)
+{
+ wxString record = L"moves";
+ for (auto index : indexes)
+ {
+  record += wxString::Format(L" %lu ", (unsigned long)index) +
+          AttributeCodec::Format(items[index]->GetX()) + L" " + AttributeCodec::Format(items[index]->GetY());
+ }
+
+ Append(record);
+}
+
+/**
+ * Record many items removed from the aquarium, as one record
+ * @param indexes Indexes of the items in drawing order before they were removed
+ */
+void AquariumJournal::RecordRemoves(const std::vector<size_t> &indexes)
+{
+ Append(L"removes" + IndexList(indexes));
+}
+
+/**
+ * Record many items moved to the end of the drawing order,
+ * keeping their order, as one record
+ * @param indexes Indexes of the items before they were moved
+ */
+void AquariumJournal::RecordMovesToEnd(const std::vector<size_t> &indexes)
+{
+ Append(L"ends" + IndexList(indexes));
+}
+
+/**
+ * Record many items turned to face the other way, as one record
+ * @param indexes Indexes of the items in drawing order
+ */
+void AquariumJournal::RecordMirrors(const std::vector<size_t> &indexes)
+{
+ Append(L"mirrors" + IndexList(indexes));
+}
+
+/**
+ * Write item indexes for a record
+ * @param indexes The indexes
+ * @return The indexes, each after a space
+ */
+wxString AquariumJournal::IndexList(const std::vector<size_t> &indexes)
+{
+ wxString list;
+ for (auto index : indexes)
+ {
+  list += wxString::Format(L" %lu", (unsigned long)index);
+ }
+
+ return list;
+}
+
+/**
+ * Read the item indexes at the end of a record
+ * @param tokens The rest of the record
+ * @param count Number of items, which every index must be less than
+ * @param flags Receives a flag for each item, true if its index was read
+ * @return true if there was at least one index and all were valid
+ */
+bool AquariumJournal::ParseIndexes(wxStringTokenizer &tokens, size_t count, std::vector<bool> *flags)
+{
+ flags->assign(count, false);
+ bool any = false;
+ while (tokens.HasMoreTokens())
+ {
+  unsigned long index;
+  if (!tokens.GetNextToken().ToULong(&index) || index >= count)
+  {
+   return false;
+  }
+
+  (*flags)[index] = true;
+  any = true;
+ }
+
+ return any;
+}
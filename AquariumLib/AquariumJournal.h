@@ -0,0 +1,117 @@
+/**
+ * @file AquariumJournal.h
+ * @author Evan Gasper
+ *
+ * Append-only journal of edits made since an aquarium was saved
+ */
+
+#ifndef AQUARIUMJOURNAL_H
+#define AQUARIUMJOURNAL_H
+
+#include <memory>
+#include <vector>
+#include <wx/ffile.h>
+
+class Aquarium;
+class Item;
+class wxStringTokenizer;
+
+/**
+ * Append-only journal of edits made to an aquarium since it was saved.
+ *
+ * The journal sits next to the base .aqua file as filename.aqua.journal.
+ * Each edit appends one short line, so saving a change costs I/O
+ * proportional to the change rather than to the size of the tank.
+ * Loading replays the journal on top of the base file.
+ *
+ * Every record has a sequence number. The base file is marked with the
+ * journal id and the last sequence number it already includes, so
+ * records the base file already holds are skipped. This lets the base
+ * file be rewritten (compacted) while edits keep being journaled.
+ */
+class AquariumJournal {
+private:
+ /// The base .aqua file this journal goes with
+ wxString mFilename;
+
+ /// Identifies the base file this journal belongs to
+ wxString mId;
+
+ /// Sequence number of the last record
+ long long mSequence = 0;
+
+ /// Records not yet included in the base file, with their sequence numbers
+ std::vector<std::pair<long long, wxString>> mRecords;
+
+ /// Journal lines Replay stopped at, kept until Resume sets them aside
+ wxString mUnreplayed;
+
+ /// The journal file, open for appending once the base file exists
+ wxFFile mFile;
+
+ void Append(const wxString &record);
+ wxString Sequence(const wxString &record);
+ static wxString AddRecord(Item *item);
+ static bool Apply(const wxString &record, Aquarium *aquarium,
+         std::vector<std::shared_ptr<Item>> &items);
+
+ static wxString IndexList(const std::vector<size_t> &indexes);
+ static bool ParseIndexes(wxStringTokenizer &tokens, size_t count, std::vector<bool> *flags);
+
+public:
+ explicit AquariumJournal(const wxString &filename);
+ AquariumJournal(const wxString &filename, const wxString &id, long long sequence);
+
+ /// Copy constructor (disabled)
+ AquariumJournal(const AquariumJournal &) = delete;
+
+ /// Assignment operator (disabled)
+ void operator=(const AquariumJournal &) = delete;
+
+ static wxString JournalFilename(const wxString &filename);
+ static std::unique_ptr<AquariumJournal> Replay(const wxXmlDocument &xmlDoc,
+         const wxString &filename, Aquarium *aquarium,
+         std::vector<std::shared_ptr<Item>> &items);
+
+ bool Resume();
+
+ void XmlMark(wxXmlDocument *xmlDoc) const;
+ bool Trim(long long sequence);
+
+ void RecordAdd(Item *item);
+ void RecordAdds(const std::vector<std::shared_ptr<Item>> &items, size_t first);
+ void RecordMove(size_t index, double x, double y);
+ void RecordRemove(size_t index);
+ void RecordMoveToEnd(size_t index);
+ void RecordClear();
+ void RecordMoves(const std::vector<size_t> &indexes, const std::vector<std::shared_ptr<Item>> &items);
+ void RecordRemoves(const std::vector<size_t> &indexes);
+ void RecordMovesToEnd(const std::vector<size_t> &indexes);
+ void RecordMirrors(const std::vector<size_t> &indexes);
+
+ /**
+  * Get the base file this journal goes with
+  * @return Base .aqua filename
+  */
+ const wxString &GetFilename() const { return mFilename; }
+
+ /**
+  * Get the sequence number of the last record
+  * @return Sequence number
+  */
+ long long GetSequence() const { return mSequence; }
+
+ /**
+  * Is the journal file open for appending?
+  * @return true once the journal goes with a saved base file
+  */
+ bool IsOpen() const { return mFile.IsOpened(); }
+
+ /**
+  * Get the number of records not yet included in the base file
+  * @return Number of records
+  */
+ size_t GetCount() const { return mRecords.size(); }
+};
+
+#endif //AQUARIUMJOURNAL_H
@@ -1,210 +1,1246 @@
-/**
- * @file AquariumView.cpp
- * @author Evan Gasper
- */
-
-#include "pch.h"
-#include "AquariumView.h"
-#include "ids.h"
-#include "FishBeta.h"
-#include "DovaFish.h"
-#include "ChestFish.h"
-#include <wx/dcbuffer.h>
-#include "DecorCastle.h"
-
-/// Frame duration in milliseconds
-const int FrameDuration = 30;
-
-/**
- * Initialize the aquarium view class.
- * @param parent The parent window for this class
- */
-void AquariumView::Initialize(wxFrame* parent)
-{
- Create(parent, wxID_ANY);
- // Special Paint Background
- SetBackgroundStyle(wxBG_STYLE_PAINT);
- Bind(wxEVT_PAINT, &AquariumView::OnPaint, this);
- // Binds the parent frame
- parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnAddFishBetaFish, this, IDM_ADDFISHBETA);
- parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnAddFishDovaFish, this, IDM_ADDFISHDOVA);
- parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnAddFishChestFish, this, IDM_ADDFISHCHEST);
- parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnAddDecorCastle, this, IDM_ADDDECORCASTLE);
- parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnFileSaveAs, this, wxID_SAVEAS);
- parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnFileOpen, this, wxID_OPEN);
-
- // Create a timer and set it to the const FrameDuration
- mTimer.SetOwner(this);
- mTimer.Start(FrameDuration);
- // Binding all the mouse events
- Bind(wxEVT_LEFT_DOWN, &AquariumView::OnLeftDown, this);
- Bind(wxEVT_LEFT_UP, &AquariumView::OnLeftUp, this);
- Bind(wxEVT_MOTION, &AquariumView::OnMouseMove, this);
- Bind(wxEVT_TIMER, &AquariumView::OnTimer, this);
-
- mStopWatch.Start();
-
-}
-
-/**
- * Refresh function for animation
- * @param event
- */
-void AquariumView::OnTimer(wxTimerEvent& event)
-{
- Refresh();
-}
-
-/**
- * Paint event, draws the window.
- * @param event Paint event object
- */
-void AquariumView::OnPaint(wxPaintEvent& event)
-{
- // Compute the time that has elapsed
- // since the last call to OnPaint.
- auto newTime = mStopWatch.Time();
- auto elapsed = (double)(newTime - mTime) * 0.001;
- mTime = newTime;
-
- mAquarium.Update(elapsed);
-
- wxAutoBufferedPaintDC dc(this);
-
- wxBrush background(*wxWHITE);
- dc.SetBackground(background);
- dc.Clear();
-
- mAquarium.OnDraw(&dc);
-}
-
-/**
- * Menu hander for Add Fish>Beta Fish
- * @param event Mouse event
- */
-void AquariumView::OnAddFishBetaFish(wxCommandEvent& event)
-{
- auto fish = std::make_shared<FishBeta>(&mAquarium);
- mAquarium.Add(fish);
- Refresh();
-}
-
-/**
- * Menu handler for Add Fish > Dovahfin.
- * @param event Mouse event.
- */
-void AquariumView::OnAddFishDovaFish(wxCommandEvent& event)
-{
- auto fish = std::make_shared<DovaFish>(&mAquarium);
- mAquarium.Add(fish);
- Refresh();
-}
-
-/**
- * Menu handler for Add Fish > Chest.
- * @param event Mouse event.
- */
-void AquariumView::OnAddFishChestFish(wxCommandEvent& event)
-{
- auto fish = std::make_shared<ChestFish>(&mAquarium);
- mAquarium.Add(fish);
- Refresh();
-}
-
-/**
- * Menu handler for Add Fish > Chest.
- * @param event Mouse event.
- */
-void AquariumView::OnAddDecorCastle(wxCommandEvent& event)
-{
- auto fish = std::make_shared<DecorCastle>(&mAquarium);
- mAquarium.Add(fish);
- Refresh();
-}
-
-/**
- * Menu handler for SaveAs
- * @param event Mouse event.
- */
-void AquariumView::OnFileSaveAs(wxCommandEvent& event)
-{
- wxFileDialog saveFileDialog(this, L"Save Aquarium file", L"", L"",
-        L"Aquarium Files (*.aqua)|*.aqua", wxFD_SAVE|wxFD_OVERWRITE_PROMPT);
- if (saveFileDialog.ShowModal() == wxID_CANCEL)
- {
-  return;
- }
-
- auto filename = saveFileDialog.GetPath();
- mAquarium.Save(filename);
-}
-
-/**
- * File>Open menu handler
- * @param event Menu event
- */
-void AquariumView::OnFileOpen(wxCommandEvent& event)
-{
- wxFileDialog loadFileDialog(this, L"Load Aquarium file", L"", L"",
-         L"Aquarium Files (*.aqua)|*.aqua", wxFD_OPEN);
- if (loadFileDialog.ShowModal() == wxID_CANCEL)
- {
-  return;
- }
-
- auto filename = loadFileDialog.GetPath();
- mAquarium.Clear();
- mAquarium.Load(filename);
- Refresh();
-}
-
-/**
- * Handle the left mouse button down event.
- * @param event The mouse event triggered on left button down.
- */
-void AquariumView::OnLeftDown(wxMouseEvent &event)
-{
- mGrabbedItem = mAquarium.HitTest(event.GetX(), event.GetY());
- if (mGrabbedItem != nullptr)
- {
-  // Move grabbed item into function
-  mAquarium.MoveItemToEnd(mGrabbedItem);
-  Refresh();
- }
-}
-
-/**
- * Handle the left mouse button up event.
- * @param event The mouse event triggered on left button up.
- */
-void AquariumView::OnLeftUp(wxMouseEvent &event)
-{
- OnMouseMove(event);
-}
-
-/**
- * Handle the mouse move event.
- * @param event The mouse event triggered during mouse movement.
- */
-void AquariumView::OnMouseMove(wxMouseEvent &event)
-{
- // See if an item is currently being moved by the mouse
- if (mGrabbedItem != nullptr)
- {
-  // If an item is being moved, we only continue to
-  // move it while the left button is down.
-  if (event.LeftIsDown())
-  {
-   mGrabbedItem->SetLocation(event.GetX(), event.GetY());
-  }
-  else
-  {
-   // When the left button is released, we release the
-   // item.
-   mGrabbedItem = nullptr;
-  }
-
-  // Force the screen to redraw
-  Refresh();
- }
-}
\ No newline at end of file
+/**
+ * @file AquariumView.cpp
+ * @author Evan Gasper
+ */
+
+#include "pch.h"
+#include "AquariumView.h"
+#include "ids.h"
+#include "FishBeta.h"
+#include "DovaFish.h"
+#include "ChestFish.h"
+#include <wx/dcbuffer.h>
+#include "DecorCastle.h"
+#include "WorkerPool.h"
+#include "DcRenderer.h"
+#include "GraphicsRenderer.h"
+#include <wx/stdpaths.h>
+#include <wx/filename.h>
+#include <wx/filefn.h>
+#include <random>
+#include <algorithm>
+#include <cmath>
+#include <chrono>
+
+/// Change in zoom for each step in or out
+const double ZoomStep = 1.25;
+
+/// Smallest zoom, for looking at the whole of a large tank
+const double MinZoom = 1.0 / 32;
+
+/// Largest zoom
+const double MaxZoom = 8;
+
+/// How many backgrounds wide and high a large tank is
+const int LargeTankScale = 8;
+
+/// Time between showing how long frames take to draw, in milliseconds
+const long DrawTimeInterval = 1000;
+
+/// Time between autosaves in milliseconds
+const long AutosaveInterval = 60000;
+
+/// Name of the autosave file in the user data directory,
+/// followed by the tank number for tanks after the first
+const wchar_t *AutosaveName = L"autosave";
+
+/// Extension of the autosave files
+const wchar_t *AutosaveExtension = L".aqua.gz";
+
+/**
+ * Destructor
+ *
+ * Waits for an autosave being written to stop. The autosave is
+ * only there to recover from a crash, so it is removed when the
+ * program closes normally.
+ */
+AquariumView::~AquariumView()
+{
+ if (mAutosave.valid())
+ {
+  *mAutosaveCancelled = true;
+  mAutosave.wait();
+ }
+
+ if (mOwner)
+ {
+  wxRemoveFile(AutosaveFilename());
+ }
+}
+
+/**
+ * Initialize the aquarium view class.
+ *
+ * The menu events are bound to the view itself. The frame
+ * passes them on to whichever view is current.
+ *
+ * @param parent The parent window for this class
+ * @param tank Number of this tank in the frame, from 0
+ * @param aquarium Aquarium owned by another view to show, or
+ * null for the view to have an aquarium of its own
+ */
+void AquariumView::Initialize(wxFrame* parent, int tank, std::shared_ptr<Aquarium> aquarium)
+{
+ Create(parent, wxID_ANY);
+ mFrame = parent;
+ mTank = tank;
+ mOwner = aquarium == nullptr;
+ mAquarium = mOwner ? std::make_shared<Aquarium>() : aquarium;
+ mRenderer = Renderer::Create(DcRenderer::Name);
+ // Special Paint Background
+ SetBackgroundStyle(wxBG_STYLE_PAINT);
+ Bind(wxEVT_PAINT, &AquariumView::OnPaint, this);
+ // Binds the menu events
+ Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnAddFishBetaFish, this, IDM_ADDFISHBETA);
+ Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnAddFishDovaFish, this, IDM_ADDFISHDOVA);
+ Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnAddFishChestFish, this, IDM_ADDFISHCHEST);
+ Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnAddDecorCastle, this, IDM_ADDDECORCASTLE);
+ Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnAddMany, this, IDM_ADDMANY100, IDM_ADDMANY10000);
+ Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnFileSaveAs, this, wxID_SAVEAS);
+ Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnFileOpen, this, wxID_OPEN);
+ Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnCancelJob, this, IDM_CANCELJOB);
+ Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnZoomIn, this, IDM_ZOOMIN);
+ Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnZoomOut, this, IDM_ZOOMOUT);
+ Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnZoomReset, this, IDM_ZOOMRESET);
+ Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnLargeTank, this, IDM_LARGETANK);
+ Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnSchooling, this, IDM_SCHOOLING);
+ Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnCollisions, this, IDM_COLLISIONS);
+ Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnKinetic, this, IDM_KINETIC);
+ Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnRenderer, this, IDM_RENDERDC, IDM_RENDERGRAPHICS);
+ Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnMemory, this, IDM_MEMORY);
+ Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnDelete, this, IDM_DELETE);
+ Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnBringToFront, this, IDM_BRINGTOFRONT);
+ Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnMirror, this, IDM_MIRROR);
+ Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnSelectAll, this, IDM_SELECTALL);
+
+ // Menu items that are only available while no load or save is running
+ Bind(wxEVT_UPDATE_UI, &AquariumView::OnUpdateNoLoad, this, IDM_ADDFISHBETA, IDM_ADDDECORCASTLE);
+ Bind(wxEVT_UPDATE_UI, &AquariumView::OnUpdateNoLoad, this, IDM_ADDMANY100, IDM_ADDMANY10000);
+ Bind(wxEVT_UPDATE_UI, &AquariumView::OnUpdateNoJob, this, wxID_SAVEAS);
+ Bind(wxEVT_UPDATE_UI, &AquariumView::OnUpdateNoJob, this, wxID_OPEN);
+ Bind(wxEVT_UPDATE_UI, &AquariumView::OnUpdateCancelJob, this, IDM_CANCELJOB);
+ Bind(wxEVT_UPDATE_UI, &AquariumView::OnUpdateLargeTank, this, IDM_LARGETANK);
+ Bind(wxEVT_UPDATE_UI, &AquariumView::OnUpdateSchooling, this, IDM_SCHOOLING);
+ Bind(wxEVT_UPDATE_UI, &AquariumView::OnUpdateCollisions, this, IDM_COLLISIONS);
+ Bind(wxEVT_UPDATE_UI, &AquariumView::OnUpdateKinetic, this, IDM_KINETIC);
+ Bind(wxEVT_UPDATE_UI, &AquariumView::OnUpdateRenderer, this, IDM_RENDERDC, IDM_RENDERGRAPHICS);
+ Bind(wxEVT_UPDATE_UI, &AquariumView::OnUpdateSelection, this, IDM_DELETE, IDM_SELECTALL);
+ Bind(wxEVT_THREAD, &AquariumView::OnJobDone, this);
+
+ // Binding all the mouse events
+ Bind(wxEVT_LEFT_DOWN, &AquariumView::OnLeftDown, this);
+ Bind(wxEVT_LEFT_UP, &AquariumView::OnLeftUp, this);
+ Bind(wxEVT_MOTION, &AquariumView::OnMouseMove, this);
+ Bind(wxEVT_RIGHT_DOWN, &AquariumView::OnRightDown, this);
+ Bind(wxEVT_MOUSEWHEEL, &AquariumView::OnMouseWheel, this);
+
+ mStopWatch.Start();
+}
+
+/**
+ * Offer to recover the aquarium if the last session
+ * ended without closing normally.
+ */
+void AquariumView::Recover()
+{
+ auto autosave = AutosaveFilename();
+ if (wxFileExists(autosave))
+ {
+  if (wxMessageBox(L"The aquarium was not closed normally. Recover it?",
+          L"Recover Aquarium", wxYES_NO | wxICON_QUESTION, this) == wxYES)
+  {
+   StartLoad(autosave);
+  }
+  else
+  {
+   wxRemoveFile(autosave);
+  }
+ }
+}
+
+/**
+ * Start recording the session to a file.
+ *
+ * The aquarium random number generator is reseeded with a seed
+ * saved in the recording, so replaying it makes the same fish.
+ *
+ * @param filename The file to record to
+ * @return true if the file could be created
+ */
+bool AquariumView::Record(const wxString& filename)
+{
+ auto seed = std::random_device()();
+ auto recorder = std::make_unique<SessionRecorder>();
+ if (!recorder->Open(filename, seed))
+ {
+  return false;
+ }
+
+ mAquarium->GetRandom().seed(seed);
+ mRecorder = std::move(recorder);
+ return true;
+}
+
+/**
+ * Publish each frame of the aquarium into shared memory,
+ * for other programs to read with WorldReader
+ * @param name Name of the shared memory
+ * @return true if the shared memory could be created
+ */
+bool AquariumView::Export(const wxString& name)
+{
+ auto exporter = std::make_unique<WorldExport>();
+ if (!exporter->Open(name.ToStdString()))
+ {
+  return false;
+ }
+
+ mExport = std::move(exporter);
+ return true;
+}
+
+/**
+ * Replay a recorded session in the view.
+ *
+ * Each frame replays one recorded frame instead of following the
+ * clock. The mouse and the menus that change the aquarium are
+ * ignored until the replay ends.
+ *
+ * @param filename The recorded session
+ * @return true if the file is a session recording
+ */
+bool AquariumView::Replay(const wxString& filename)
+{
+ auto player = std::make_unique<SessionPlayer>();
+ if (!player->Open(filename))
+ {
+  return false;
+ }
+
+ // Nothing else may change the aquarium during the replay
+ mJob = nullptr;
+ mLoading = false;
+ mGrabbedItem = nullptr;
+ mDraggingSelection = false;
+ mBanding = false;
+
+ player->Start(mAquarium.get());
+ mPlayer = std::move(player);
+ return true;
+}
+
+/**
+ * Get the name of the file the aquarium is autosaved to
+ *
+ * Each tank in the frame has its own file, so they
+ * can be recovered separately.
+ *
+ * @return Full path of the autosave file
+ */
+wxString AquariumView::AutosaveFilename() const
+{
+ auto dir = wxStandardPaths::Get().GetUserDataDir();
+ if (!wxFileName::DirExists(dir))
+ {
+  wxFileName::Mkdir(dir, wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL);
+ }
+
+ wxString name = AutosaveName;
+ if (mTank > 0)
+ {
+  name += wxString::Format(L"-%d", mTank + 1);
+ }
+
+ return dir + wxFileName::GetPathSeparator() + name + AutosaveExtension;
+}
+
+/**
+ * Autosave the aquarium in the background.
+ *
+ * Only a snapshot of the item state is taken here, which is quick
+ * enough not to delay a frame. The snapshot is turned into XML and
+ * written by the worker pool while the aquarium keeps animating.
+ * An autosave is skipped if the last one is still being written.
+ */
+void AquariumView::Autosave()
+{
+ if (mAutosave.valid() &&
+     mAutosave.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+ {
+  return;
+ }
+
+ auto snapshot = mAquarium->Snapshot();
+ auto filename = AutosaveFilename();
+ auto cancelled = std::make_shared<std::atomic<bool>>(false);
+ auto task = std::make_shared<std::packaged_task<bool()>>([snapshot, filename, cancelled]() {
+  return Aquarium::WriteSnapshot(*snapshot, filename, [cancelled](double) { return !*cancelled; });
+ });
+
+ mAutosave = task->get_future();
+ mAutosaveCancelled = cancelled;
+ WorkerPool::Shared().Submit([task]() { (*task)(); });
+}
+
+/**
+ * Advance the aquarium to the current time.
+ *
+ * The frame calls this for every view at once on the worker pool,
+ * so it only touches this view's aquarium and session, and never
+ * the window. Tick does the rest on the UI thread afterwards.
+ * Views that do not own their aquarium leave it alone.
+ */
+void AquariumView::Step()
+{
+ if (!mOwner)
+ {
+  return;
+ }
+
+ if (mPlayer != nullptr)
+ {
+  // Replays use the recorded frames rather than the clock
+  if (!mReplayFinished && !mPlayer->PlayFrame(mAquarium.get()))
+  {
+   mReplayFinished = true;
+  }
+ }
+ else
+ {
+  auto elapsed = mAquarium->Advance();
+  if (mRecorder != nullptr)
+  {
+   mRecorder->RecordFrame(elapsed);
+  }
+ }
+
+ // A snapshot puts every item where it is now, which kinetic
+ // motion otherwise puts off, so only take one for a reader
+ if (mExport != nullptr && mExport->IsWanted())
+ {
+  mExport->Publish(*mAquarium->Snapshot(), mAquarium->GetTime());
+ }
+}
+
+/**
+ * Refresh function for animation, called on the UI
+ * thread after every view has been stepped
+ */
+void AquariumView::Tick()
+{
+ if (mStopWatch.Time() - mRefreshTime >= mRefreshInterval)
+ {
+  mRefreshTime = mStopWatch.Time();
+  Refresh();
+ }
+
+ if (!mOwner)
+ {
+  return;
+ }
+
+ if (mReplayFinished)
+ {
+  SetStatus(wxString::Format(L"Replay finished after %ld frames", mPlayer->GetFrames()));
+  mPlayer = nullptr;
+  mReplayFinished = false;
+
+  // The clock takes over from the recording
+  mAquarium->RestartClock();
+ }
+
+ // Fold a long journal back into the file it goes with
+ if (mJob == nullptr && mAquarium->NeedsCompaction())
+ {
+  StartSave(L"Compacting", mAquarium->GetFilename());
+ }
+
+ // Autosaves wait for a load, so they never save the
+ // aquarium that is about to be replaced
+ if (!mLoading && mStopWatch.Time() - mAutosaveTime >= AutosaveInterval)
+ {
+  mAutosaveTime = mStopWatch.Time();
+  Autosave();
+ }
+
+ if (mJob != nullptr)
+ {
+  SetStatus(wxString::Format(L"%s... %d%%",
+          mJob->GetName(), int(mJob->GetProgress() * 100)));
+ }
+}
+
+/**
+ * Set whether the view zooms so the whole aquarium fits it,
+ * however large the window or the aquarium is
+ * @param fitting True to fit the aquarium to the window
+ */
+void AquariumView::SetFitting(bool fitting)
+{
+ mFitting = fitting;
+ Refresh();
+}
+
+/**
+ * Show a status in the frame, if this is the view the menus act on
+ * @param status The status to show
+ */
+void AquariumView::SetStatus(const wxString &status)
+{
+ if (mFrame != nullptr && mCurrent)
+ {
+  mFrame->SetStatusText(status);
+ }
+}
+
+/**
+ * Set whether the menus act on this view
+ * @param current True if the menus act on this view
+ * @param outlined True to outline the view to show it is current
+ */
+void AquariumView::SetCurrent(bool current, bool outlined)
+{
+ mCurrent = current;
+ mOutlined = outlined;
+ Refresh();
+}
+
+/**
+ * Paint event, draws the window.
+ * @param event Paint event object
+ */
+void AquariumView::OnPaint(wxPaintEvent& event)
+{
+ wxAutoBufferedPaintDC dc(this);
+
+ wxBrush background(*wxWHITE);
+ dc.SetBackground(background);
+ dc.Clear();
+
+ auto size = GetClientSize();
+ if (mFitting && mAquarium->GetWidth() > 0 && mAquarium->GetHeight() > 0)
+ {
+  mZoom = std::min(double(size.GetWidth()) / mAquarium->GetWidth(),
+          double(size.GetHeight()) / mAquarium->GetHeight());
+  mPanX = 0;
+  mPanY = 0;
+ }
+
+ // Draw in aquarium coordinates through the camera, and
+ // only the part of the aquarium the window shows
+ auto origin = PanOrigin();
+ wxRect visible(origin.x, origin.y, int(ceil(size.GetWidth() / mZoom)), int(ceil(size.GetHeight() / mZoom)));
+
+ auto start = std::chrono::steady_clock::now();
+ mRenderer->Begin(&dc, mZoom, origin);
+ mAquarium->OnDraw(mRenderer.get(), visible);
+ mRenderer->End();
+ mDrawTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+ mDrawFrames++;
+
+ DrawSelection(dc);
+
+ if (mOutlined)
+ {
+  dc.SetUserScale(1, 1);
+  dc.SetLogicalOrigin(0, 0);
+  dc.SetPen(wxPen(wxColour(0, 120, 215), 4));
+  dc.SetBrush(*wxTRANSPARENT_BRUSH);
+  dc.DrawRectangle(GetClientRect());
+ }
+
+ // Show how long drawing takes, so the renderers can be compared
+ auto newTime = mStopWatch.Time();
+ if (newTime - mDrawShownTime >= DrawTimeInterval)
+ {
+  if (mJob == nullptr)
+  {
+   SetStatus(wxString::Format(L"Drawing with %s: %.2f ms per frame",
+           mRenderer->GetName(), mDrawTime * 1000 / mDrawFrames));
+  }
+
+  mDrawTime = 0;
+  mDrawFrames = 0;
+  mDrawShownTime = newTime;
+ }
+}
+
+/**
+ * Menu hander for Add Fish>Beta Fish
+ * @param event Mouse event
+ */
+void AquariumView::OnAddFishBetaFish(wxCommandEvent& event)
+{
+ AddItem(std::make_shared<FishBeta>(mAquarium.get()));
+}
+
+/**
+ * Menu handler for Add Fish > Dovahfin.
+ * @param event Mouse event.
+ */
+void AquariumView::OnAddFishDovaFish(wxCommandEvent& event)
+{
+ AddItem(std::make_shared<DovaFish>(mAquarium.get()));
+}
+
+/**
+ * Menu handler for Add Fish > Chest.
+ * @param event Mouse event.
+ */
+void AquariumView::OnAddFishChestFish(wxCommandEvent& event)
+{
+ AddItem(std::make_shared<ChestFish>(mAquarium.get()));
+}
+
+/**
+ * Menu handler for Add Fish > Chest.
+ * @param event Mouse event.
+ */
+void AquariumView::OnAddDecorCastle(wxCommandEvent& event)
+{
+ AddItem(std::make_shared<DecorCastle>(mAquarium.get()));
+}
+
+/**
+ * Menu handler for the Add Fish presets that add many fish
+ * at once, half Beta and half Dova, spread over the tank.
+ * @param event Menu event
+ */
+void AquariumView::OnAddMany(wxCommandEvent& event)
+{
+ size_t count = event.GetId() == IDM_ADDMANY100 ? 100 :
+         event.GetId() == IDM_ADDMANY1000 ? 1000 : 10000;
+
+ auto start = std::chrono::steady_clock::now();
+ for (auto type : {FishBetaTraits::Type, DovaFishTraits::Type})
+ {
+  mAquarium->AddBulk(type, count / 2);
+  if (mRecorder != nullptr)
+  {
+   mRecorder->RecordBulk(type, count / 2, uint8_t(Aquarium::Spread::Uniform));
+  }
+ }
+
+ SetStatus(wxString::Format(L"Added %lu fish in %.1f ms", (unsigned long)count,
+         std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count()));
+ Refresh();
+}
+
+/**
+ * Add an item made by one of the add menus to the aquarium
+ * @param item The new item
+ */
+void AquariumView::AddItem(std::shared_ptr<Item> item)
+{
+ mAquarium->Add(item);
+ if (mRecorder != nullptr)
+ {
+  mRecorder->RecordAdd(item.get());
+ }
+
+ Refresh();
+}
+
+/**
+ * Menu handler for SaveAs
+ * @param event Mouse event.
+ */
+void AquariumView::OnFileSaveAs(wxCommandEvent& event)
+{
+ wxFileDialog saveFileDialog(this, L"Save Aquarium file", L"", L"",
+        L"Aquarium Files (*.aqua)|*.aqua|Compressed Aquarium Files (*.aqua.gz)|*.aqua.gz",
+        wxFD_SAVE|wxFD_OVERWRITE_PROMPT);
+ if (saveFileDialog.ShowModal() == wxID_CANCEL)
+ {
+  return;
+ }
+
+ auto filename = saveFileDialog.GetPath();
+
+ // The compressed filter saves compressed even if the
+ // name typed did not have the extension
+ if (saveFileDialog.GetFilterIndex() == 1 && !filename.EndsWith(L".aqua.gz"))
+ {
+  filename += filename.EndsWith(L".aqua") ? L".gz" : L".aqua.gz";
+ }
+
+ StartSave(L"Saving", filename);
+}
+
+/**
+ * Save the aquarium in the background.
+ *
+ * The document is built right away, so it captures the aquarium
+ * as it is now, and is written to the file in the background.
+ * Edits made while it is written go into the journal.
+ *
+ * @param name Description shown in the status bar while saving
+ * @param filename The file to save to
+ */
+void AquariumView::StartSave(const wxString& name, const wxString& filename)
+{
+ auto sequence = mAquarium->BeginSave(filename);
+ std::shared_ptr<wxXmlDocument> xmlDoc = mAquarium->XmlDocument();
+ auto aquarium = mAquarium.get();
+ StartJob(name, [aquarium, xmlDoc, filename](AquariumJob& job) {
+  return aquarium->WriteDocument(*xmlDoc, filename, job.Progress());
+ }, [aquarium, sequence](AquariumJob& job) {
+  aquarium->EndSave(sequence, job.IsSucceeded());
+  if (!job.IsSucceeded() && !job.IsCancelled())
+  {
+   wxMessageBox(L"Write to XML failed");
+  }
+ });
+}
+
+/**
+ * File>Open menu handler
+ * @param event Menu event
+ */
+void AquariumView::OnFileOpen(wxCommandEvent& event)
+{
+ wxFileDialog loadFileDialog(this, L"Load Aquarium file", L"", L"",
+         L"Aquarium Files (*.aqua;*.aqua.gz)|*.aqua;*.aqua.gz", wxFD_OPEN);
+ if (loadFileDialog.ShowModal() == wxID_CANCEL)
+ {
+  return;
+ }
+
+ StartLoad(loadFileDialog.GetPath());
+}
+
+/**
+ * Load an aquarium file in the background.
+ *
+ * The file is loaded while the current aquarium keeps
+ * animating. The loaded items replace the current ones
+ * when the load finishes.
+ *
+ * @param filename The file to load
+ */
+void AquariumView::StartLoad(const wxString& filename)
+{
+ auto items = std::make_shared<std::vector<std::shared_ptr<Item>>>();
+ auto journal = std::make_shared<std::unique_ptr<AquariumJournal>>();
+ auto aquarium = mAquarium.get();
+ StartJob(L"Loading", [aquarium, items, journal, filename](AquariumJob& job) {
+  return aquarium->LoadItems(filename, *items, job.Progress(), journal.get());
+ }, [this, items, journal, filename](AquariumJob& job) {
+  mLoading = false;
+  if (job.IsSucceeded())
+  {
+   // Swap the loaded items in all at once
+   mGrabbedItem = nullptr;
+   mDraggingSelection = false;
+   mAquarium->SetItems(std::move(*items));
+   mAquarium->SetJournal(std::move(*journal));
+   if (mRecorder != nullptr)
+   {
+    mRecorder->RecordLoad(filename, *mAquarium->XmlDocument());
+   }
+
+   Refresh();
+  }
+  else if (!job.IsCancelled())
+  {
+   wxMessageBox(L"Unable to load Aquarium file");
+  }
+ });
+ mLoading = true;
+}
+
+/**
+ * Start a load or save running in the background
+ * @param name Description shown in the status bar while the job runs
+ * @param work The work to do on the background thread
+ * @param completion Function run on the UI thread when the work is done
+ */
+void AquariumView::StartJob(const wxString& name, AquariumJob::Work work,
+        AquariumJob::Completion completion)
+{
+ mJob = std::make_unique<AquariumJob>(this, name, std::move(work), std::move(completion));
+ mJob->Start();
+}
+
+/**
+ * Handle completion of a background load or save
+ * @param event Thread event posted by the job
+ */
+void AquariumView::OnJobDone(wxThreadEvent& event)
+{
+ if (mJob == nullptr || !mJob->IsDone())
+ {
+  return;
+ }
+
+ // Release the job first, so its completion can start another one
+ auto job = std::move(mJob);
+
+ SetStatus(L"");
+
+ job->Complete();
+}
+
+/**
+ * Menu handler for File>Cancel Load/Save
+ * @param event Menu event
+ */
+void AquariumView::OnCancelJob(wxCommandEvent& event)
+{
+ if (mJob != nullptr)
+ {
+  mJob->Cancel();
+ }
+}
+
+/**
+ * Update handler for menu items that cannot be used while a job runs.
+ * @param event Update event
+ */
+void AquariumView::OnUpdateNoJob(wxUpdateUIEvent& event)
+{
+ event.Enable(mJob == nullptr && mPlayer == nullptr);
+}
+
+/**
+ * Update handler for menu items that cannot be used while a load runs.
+ *
+ * Adding items draws from the aquarium random number generator,
+ * which a background load is also using, so adds wait for the load.
+ * Adds also wait for a replay to finish.
+ *
+ * @param event Update event
+ */
+void AquariumView::OnUpdateNoLoad(wxUpdateUIEvent& event)
+{
+ event.Enable(!mLoading && mPlayer == nullptr);
+}
+
+/**
+ * Update handler for File>Cancel Load/Save
+ * @param event Update event
+ */
+void AquariumView::OnUpdateCancelJob(wxUpdateUIEvent& event)
+{
+ event.Enable(mJob != nullptr);
+}
+
+/**
+ * Handle the left mouse button down event.
+ * @param event The mouse event triggered on left button down.
+ */
+void AquariumView::OnLeftDown(wxMouseEvent &event)
+{
+ if (mActivated)
+ {
+  mActivated(this);
+ }
+
+ // Items can only be dragged in the view that records the aquarium
+ if (mPlayer != nullptr || !mOwner)
+ {
+  return;
+ }
+
+ auto location = ScreenToAquarium(event.GetPosition());
+ if (mRecorder != nullptr)
+ {
+  mRecorder->RecordGrab(location.x, location.y);
+ }
+
+ // Grabbing a selected item drags the whole selection. Grabbing
+ // anything else drops the selection, and grabbing nothing starts
+ // dragging out a rectangle to select what is inside it.
+ mGrabbedItem = mAquarium->HitTest(location.x, location.y);
+ mDraggingSelection = mGrabbedItem != nullptr && mAquarium->IsSelected(mGrabbedItem);
+ if (mDraggingSelection)
+ {
+  mDraggedTo = location;
+  return;
+ }
+
+ mAquarium->Select(wxRect());
+ if (mGrabbedItem != nullptr)
+ {
+  // Move grabbed item into function
+  mAquarium->MoveItemToEnd(mGrabbedItem);
+ }
+ else
+ {
+  mBanding = true;
+  mBandStart = location;
+  mBandEnd = location;
+ }
+
+ Refresh();
+}
+
+/**
+ * Handle the left mouse button up event.
+ * @param event The mouse event triggered on left button up.
+ */
+void AquariumView::OnLeftUp(wxMouseEvent &event)
+{
+ OnMouseMove(event);
+}
+
+/**
+ * Handle the mouse move event.
+ * @param event The mouse event triggered during mouse movement.
+ */
+void AquariumView::OnMouseMove(wxMouseEvent &event)
+{
+ // Dragging with the right button pans the camera
+ if (event.RightIsDown())
+ {
+  mFitting = false;
+  mPanX += (mPanStart.x - event.GetX()) / mZoom;
+  mPanY += (mPanStart.y - event.GetY()) / mZoom;
+  mPanStart = event.GetPosition();
+  Refresh();
+ }
+
+ // Dragging over nothing drags out the selection rectangle,
+ // and releasing the button selects what is inside it
+ if (mBanding)
+ {
+  mBandEnd = ScreenToAquarium(event.GetPosition());
+  if (!event.LeftIsDown())
+  {
+   mBanding = false;
+   SelectRect(wxRect(mBandStart, mBandEnd));
+  }
+
+  Refresh();
+ }
+
+ // See if an item is currently being moved by the mouse
+ if (mGrabbedItem != nullptr)
+ {
+  // If an item is being moved, we only continue to
+  // move it while the left button is down.
+  if (event.LeftIsDown())
+  {
+   auto location = ScreenToAquarium(event.GetPosition());
+   if (mDraggingSelection)
+   {
+    mAquarium->MoveSelection(location.x - mDraggedTo.x, location.y - mDraggedTo.y);
+    mDraggedTo = location;
+   }
+   else
+   {
+    mAquarium->MoveItem(mGrabbedItem, location.x, location.y);
+   }
+
+   if (mRecorder != nullptr)
+   {
+    mRecorder->RecordDrag(location.x, location.y);
+   }
+  }
+  else
+  {
+   // When the left button is released, we release the
+   // item and record where it was dropped.
+   if (mDraggingSelection)
+   {
+    mAquarium->SelectionMoved();
+   }
+   else
+   {
+    mAquarium->ItemMoved(mGrabbedItem);
+   }
+
+   mGrabbedItem = nullptr;
+   mDraggingSelection = false;
+   if (mRecorder != nullptr)
+   {
+    mRecorder->RecordRelease();
+   }
+  }
+
+  // Force the screen to redraw
+  Refresh();
+ }
+}
+
+/**
+ * Handle the right mouse button down event, which starts panning.
+ * @param event The mouse event triggered on right button down.
+ */
+void AquariumView::OnRightDown(wxMouseEvent &event)
+{
+ if (mActivated)
+ {
+  mActivated(this);
+ }
+
+ mPanStart = event.GetPosition();
+}
+
+/**
+ * Handle the mouse wheel, which zooms around the mouse.
+ * @param event The mouse wheel event.
+ */
+void AquariumView::OnMouseWheel(wxMouseEvent &event)
+{
+ if (event.GetWheelRotation() == 0)
+ {
+  return;
+ }
+
+ ZoomAt(event.GetWheelRotation() > 0 ? ZoomStep : 1 / ZoomStep, event.GetPosition());
+}
+
+/**
+ * Menu handler for View>Zoom In
+ * @param event Menu event
+ */
+void AquariumView::OnZoomIn(wxCommandEvent &event)
+{
+ auto size = GetClientSize();
+ ZoomAt(ZoomStep, wxPoint(size.GetWidth() / 2, size.GetHeight() / 2));
+}
+
+/**
+ * Menu handler for View>Zoom Out
+ * @param event Menu event
+ */
+void AquariumView::OnZoomOut(wxCommandEvent &event)
+{
+ auto size = GetClientSize();
+ ZoomAt(1 / ZoomStep, wxPoint(size.GetWidth() / 2, size.GetHeight() / 2));
+}
+
+/**
+ * Menu handler for View>Reset View
+ * @param event Menu event
+ */
+void AquariumView::OnZoomReset(wxCommandEvent &event)
+{
+ mFitting = false;
+ mZoom = 1;
+ mPanX = 0;
+ mPanY = 0;
+ Refresh();
+}
+
+/**
+ * Menu handler for View>Large Tank
+ *
+ * Switches between an aquarium the size of the background
+ * and one many times larger than the window.
+ *
+ * @param event Menu event
+ */
+void AquariumView::OnLargeTank(wxCommandEvent &event)
+{
+ auto size = mAquarium->GetBackgroundSize();
+ if (event.IsChecked())
+ {
+  size = wxSize(size.GetWidth() * LargeTankScale, size.GetHeight() * LargeTankScale);
+ }
+
+ mAquarium->SetSize(size);
+ if (mRecorder != nullptr)
+ {
+  mRecorder->RecordResize(size);
+ }
+
+ Refresh();
+}
+
+/**
+ * Update handler for View>Large Tank
+ * @param event Update event
+ */
+void AquariumView::OnUpdateLargeTank(wxUpdateUIEvent &event)
+{
+ event.Enable(mPlayer == nullptr);
+ event.Check(mAquarium->GetWidth() > mAquarium->GetBackgroundSize().GetWidth());
+}
+
+/**
+ * Menu handler for View>Schooling
+ * @param event Menu event
+ */
+void AquariumView::OnSchooling(wxCommandEvent &event)
+{
+ mAquarium->SetSchooling(event.IsChecked());
+ if (mRecorder != nullptr)
+ {
+  mRecorder->RecordSchooling(event.IsChecked());
+ }
+}
+
+/**
+ * Update handler for View>Schooling
+ * @param event Update event
+ */
+void AquariumView::OnUpdateSchooling(wxUpdateUIEvent &event)
+{
+ event.Enable(mPlayer == nullptr);
+ event.Check(mAquarium->IsSchooling());
+}
+
+/**
+ * Menu handler for View>Collisions
+ * @param event Menu event
+ */
+void AquariumView::OnCollisions(wxCommandEvent &event)
+{
+ mAquarium->SetCollisions(event.IsChecked());
+ if (mRecorder != nullptr)
+ {
+  mRecorder->RecordCollisions(event.IsChecked());
+ }
+}
+
+/**
+ * Update handler for View>Collisions
+ * @param event Update event
+ */
+void AquariumView::OnUpdateCollisions(wxUpdateUIEvent &event)
+{
+ event.Enable(mPlayer == nullptr);
+ event.Check(mAquarium->IsCollisions());
+}
+
+/**
+ * Menu handler for View>Kinetic Motion
+ * @param event Menu event
+ */
+void AquariumView::OnKinetic(wxCommandEvent &event)
+{
+ mAquarium->SetKinetic(event.IsChecked());
+ if (mRecorder != nullptr)
+ {
+  mRecorder->RecordKinetic(event.IsChecked());
+ }
+}
+
+/**
+ * Update handler for View>Kinetic Motion
+ * @param event Update event
+ */
+void AquariumView::OnUpdateKinetic(wxUpdateUIEvent &event)
+{
+ event.Enable(mPlayer == nullptr);
+ event.Check(mAquarium->IsKinetic());
+}
+
+/**
+ * Menu handler for View>Draw with
+ * @param event Menu event
+ */
+void AquariumView::OnRenderer(wxCommandEvent &event)
+{
+ SetRenderer(event.GetId() == IDM_RENDERGRAPHICS ? GraphicsRenderer::Name : DcRenderer::Name);
+}
+
+/**
+ * Update handler for View>Draw with
+ * @param event Update event
+ */
+void AquariumView::OnUpdateRenderer(wxUpdateUIEvent &event)
+{
+ auto name = event.GetId() == IDM_RENDERGRAPHICS ? GraphicsRenderer::Name : DcRenderer::Name;
+ event.Check(mRenderer->GetName() == name);
+}
+
+/**
+ * Menu handler for View>Memory Usage
+ * @param event Menu event
+ */
+void AquariumView::OnMemory(wxCommandEvent &event)
+{
+ auto memory = mAquarium->GetMemory();
+ auto items = mAquarium->GetCount();
+ auto kb = [](size_t bytes) { return double(bytes) / 1024; };
+ wxMessageBox(wxString::Format(L"Items: %.1f KB (%.0f bytes each)\n"
+         L"Pixels: %.1f KB\n"
+         L"Containers: %.1f KB\n"
+         L"XML held by loads and saves: %.1f KB\n"
+         L"Total: %.1f KB",
+         kb(memory.mItems), items > 0 ? double(memory.mItems) / items : 0.0,
+         kb(memory.mPixels), kb(memory.mContainers), kb(memory.mXml), kb(memory.GetTotal())),
+         L"Memory Usage");
+}
+
+/**
+ * Select the items in a rectangle and record it
+ * @param rect Rectangle in aquarium pixels
+ */
+void AquariumView::SelectRect(const wxRect &rect)
+{
+ mAquarium->Select(rect);
+ if (mRecorder != nullptr)
+ {
+  mRecorder->RecordSelect(rect);
+ }
+}
+
+/**
+ * Outline the selected items and the selection rectangle
+ * being dragged out, in window pixels over the aquarium
+ * @param dc Device context the aquarium was drawn on
+ */
+void AquariumView::DrawSelection(wxDC &dc)
+{
+ auto &selection = mAquarium->GetSelection();
+ if (selection.empty() && !mBanding)
+ {
+  return;
+ }
+
+ dc.SetUserScale(1, 1);
+ dc.SetLogicalOrigin(0, 0);
+ dc.SetBrush(*wxTRANSPARENT_BRUSH);
+ auto origin = PanOrigin();
+ auto toScreen = [this, origin](const wxRect &rect) {
+  return wxRect(int((rect.GetX() - origin.x) * mZoom), int((rect.GetY() - origin.y) * mZoom),
+          int(rect.GetWidth() * mZoom), int(rect.GetHeight() * mZoom));
+ };
+
+ dc.SetPen(wxPen(wxColour(0, 120, 215), 1, wxPENSTYLE_DOT));
+ for (auto &item : selection)
+ {
+  dc.DrawRectangle(toScreen(item->GetBounds()));
+ }
+
+ if (mBanding)
+ {
+  dc.SetPen(wxPen(wxColour(0, 120, 215), 1));
+  dc.DrawRectangle(toScreen(wxRect(mBandStart, mBandEnd)));
+ }
+}
+
+/**
+ * Menu handler for Edit>Delete
+ * @param event Menu event
+ */
+void AquariumView::OnDelete(wxCommandEvent &event)
+{
+ mAquarium->RemoveSelection();
+ if (mRecorder != nullptr)
+ {
+  mRecorder->RecordDelete();
+ }
+
+ Refresh();
+}
+
+/**
+ * Menu handler for Edit>Bring to Front
+ * @param event Menu event
+ */
+void AquariumView::OnBringToFront(wxCommandEvent &event)
+{
+ mAquarium->MoveSelectionToEnd();
+ if (mRecorder != nullptr)
+ {
+  mRecorder->RecordFront();
+ }
+
+ Refresh();
+}
+
+/**
+ * Menu handler for Edit>Mirror
+ * @param event Menu event
+ */
+void AquariumView::OnMirror(wxCommandEvent &event)
+{
+ mAquarium->MirrorSelection();
+ if (mRecorder != nullptr)
+ {
+  mRecorder->RecordMirror();
+ }
+
+ Refresh();
+}
+
+/**
+ * Menu handler for Edit>Select All
+ * @param event Menu event
+ */
+void AquariumView::OnSelectAll(wxCommandEvent &event)
+{
+ mAquarium->SelectAll();
+ if (mRecorder != nullptr)
+ {
+  mRecorder->RecordSelectAll();
+ }
+
+ Refresh();
+}
+
+/**
+ * Update handler for the Edit menu.
+ *
+ * Only the view that records the aquarium edits it, and not
+ * during a replay or while a load is swapping the items out.
+ * Only Select All is available with nothing selected.
+ *
+ * @param event Update event
+ */
+void AquariumView::OnUpdateSelection(wxUpdateUIEvent &event)
+{
+ bool editable = mOwner && mPlayer == nullptr && !mLoading && mGrabbedItem == nullptr;
+ event.Enable(editable && (event.GetId() == IDM_SELECTALL || !mAquarium->GetSelection().empty()));
+}
+
+/**
+ * Choose what the aquarium is drawn with
+ * @param name Name of the renderer, see Renderer::Create
+ * @return false if there is no renderer by that name
+ */
+bool AquariumView::SetRenderer(const wxString &name)
+{
+ auto renderer = Renderer::Create(name);
+ if (renderer == nullptr)
+ {
+  return false;
+ }
+
+ mRenderer = std::move(renderer);
+ mDrawTime = 0;
+ mDrawFrames = 0;
+ Refresh();
+ return true;
+}
+
+/**
+ * Zoom the camera, keeping one point in the window still
+ * @param factor Amount to multiply the zoom by
+ * @param screen The point to keep still, in window pixels
+ */
+void AquariumView::ZoomAt(double factor, const wxPoint &screen)
+{
+ double fixedX = mPanX + screen.x / mZoom;
+ double fixedY = mPanY + screen.y / mZoom;
+ mFitting = false;
+ mZoom = std::clamp(mZoom * factor, MinZoom, MaxZoom);
+ mPanX = fixedX - screen.x / mZoom;
+ mPanY = fixedY - screen.y / mZoom;
+ Refresh();
+}
+
+/**
+ * Get the aquarium pixel drawn at the top left of the window
+ * @return The pan rounded down to whole aquarium pixels
+ */
+wxPoint AquariumView::PanOrigin() const
+{
+ return wxPoint(int(floor(mPanX)), int(floor(mPanY)));
+}
+
+/**
+ * Convert a point in the window to a point in the aquarium
+ * @param screen Point in window pixels
+ * @return The aquarium pixel drawn at that point
+ */
+wxPoint AquariumView::ScreenToAquarium(const wxPoint &screen) const
+{
+ auto origin = PanOrigin();
+ return wxPoint(int(floor(origin.x + screen.x / mZoom)), int(floor(origin.y + screen.y / mZoom)));
+}
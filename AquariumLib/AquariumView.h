@@ -1,57 +1,226 @@
-/**
- * @file AquariumView.h
- * @author Evan Gasper
- *
- * The main view of the window and app
- */
- 
-#ifndef AQUARIUMVIEW_H
-#define AQUARIUMVIEW_H
-
-#include "Aquarium.h"
-
-/**
- * Class that creates and modifies a Window Frame
- */
-class AquariumView : public wxWindow{
-private:
- /// An object that describes our aquarium
- Aquarium  mAquarium;
- /// Any item we are currently dragging
- std::shared_ptr<Item> mGrabbedItem;
- /// Timer used to refresh
- wxTimer mTimer;
- /// Stopwatch used to measure elapsed time
- wxStopWatch mStopWatch;
- /// The last stopwatch time
- long mTime = 0;
-
- /// Paint background
- void OnPaint(wxPaintEvent& event);
- /// Add a Beta Fish to Aquarium
- void OnAddFishBetaFish(wxCommandEvent& event);
- /// Add a Dovahfin to Aquarium
- void OnAddFishDovaFish(wxCommandEvent& event);
- /// Add a Chest to Aquarium
- void OnAddFishChestFish(wxCommandEvent& event);
- /// Add a Castle to Aquarium
- void OnAddDecorCastle(wxCommandEvent& event);
- /// Save file as
- void OnFileSaveAs(wxCommandEvent& event);
- void OnTimer(wxTimerEvent& event);
- void OnFileOpen(wxCommandEvent& event);
- /// Handle mouse event click
- void OnLeftDown(wxMouseEvent& event);
- /// Handle mouse event release
- void OnLeftUp(wxMouseEvent& event);
- /// Handle mouse movement
- void OnMouseMove(wxMouseEvent& event);
-
-public:
- /// Initializer
- void Initialize(wxFrame* parent);
-};
-
-
-
-#endif //AQUARIUMVIEW_H
+/**
+ * @file AquariumView.h
+ * @author Evan Gasper
+ *
+ * The main view of the window and app
+ */
+ 
+#ifndef AQUARIUMVIEW_H
+#define AQUARIUMVIEW_H
+
+#include "Aquarium.h"
+#include "AquariumJob.h"
+#include "SessionRecorder.h"
+#include "SessionPlayer.h"
+#include "Renderer.h"
+#include "WorldExport.h"
+#include <atomic>
+#include <future>
+#include <functional>
+
+/**
+ * Class that creates and modifies a Window Frame
+ *
+ * The frame can show several views, each with its own aquarium.
+ * The frame steps every aquarium at once on the worker pool, then
+ * each view paints its own on the UI thread.
+ *
+ * More views can show an aquarium another view owns, each at its
+ * own size and frame rate. Only the owner moves the aquarium on,
+ * records and saves it. The others only draw it.
+ */
+class AquariumView : public wxWindow{
+public:
+ /// Called when the user clicks in a view, with the view
+ typedef std::function<void(AquariumView*)> Activated;
+
+private:
+ /// An object that describes our aquarium
+ std::shared_ptr<Aquarium> mAquarium;
+ /// True if this view moves the aquarium on, records and saves it
+ bool mOwner = true;
+ /// Any item we are currently dragging
+ std::shared_ptr<Item> mGrabbedItem;
+ /// True if the item grabbed drags the whole selection with it
+ bool mDraggingSelection = false;
+ /// Aquarium location the selection was last dragged to
+ wxPoint mDraggedTo;
+ /// True while the mouse is dragging out a selection rectangle
+ bool mBanding = false;
+ /// Aquarium location the selection rectangle started at
+ wxPoint mBandStart;
+ /// Aquarium location the selection rectangle ends at
+ wxPoint mBandEnd;
+ /// Number of this tank in the frame, from 0
+ int mTank = 0;
+ /// Stopwatch used to measure elapsed time
+ wxStopWatch mStopWatch;
+ /// Milliseconds between refreshes, or 0 for every tick
+ long mRefreshInterval = 0;
+ /// Stopwatch time of the last refresh
+ long mRefreshTime = 0;
+ /// True to zoom so the whole aquarium fits the window
+ bool mFitting = false;
+ /// The frame we are in, used to show job progress
+ wxFrame *mFrame = nullptr;
+ /// Load or save running in the background, if any
+ std::unique_ptr<AquariumJob> mJob;
+ /// True while the background job is a load
+ bool mLoading = false;
+ /// Stopwatch time of the last autosave
+ long mAutosaveTime = 0;
+ /// Autosave being written in the background, if any
+ std::future<bool> mAutosave;
+ /// Set to stop the autosave being written
+ std::shared_ptr<std::atomic<bool>> mAutosaveCancelled;
+ /// Session being recorded, if any
+ std::unique_ptr<SessionRecorder> mRecorder;
+ /// Session being replayed, if any
+ std::unique_ptr<SessionPlayer> mPlayer;
+ /// Publishes each frame to other programs, if asked to
+ std::unique_ptr<WorldExport> mExport;
+ /// Set by Step when the replay has run out of frames
+ bool mReplayFinished = false;
+ /// True if the menus act on this view, so it shows its status
+ bool mCurrent = true;
+ /// True to draw an outline showing this is the current view
+ bool mOutlined = false;
+ /// Called when the user clicks in the view
+ Activated mActivated;
+ /// Camera zoom, window pixels per aquarium pixel
+ double mZoom = 1;
+ /// Aquarium X location at the left of the window, kept to a
+ /// fraction of a pixel so small pans add up when zoomed in
+ double mPanX = 0;
+ /// Aquarium Y location at the top of the window
+ double mPanY = 0;
+ /// Window location the mouse was last panned from
+ wxPoint mPanStart;
+ /// What the aquarium is drawn with
+ std::unique_ptr<Renderer> mRenderer;
+ /// Seconds spent drawing since the draw time was last shown
+ double mDrawTime = 0;
+ /// Frames drawn since the draw time was last shown
+ int mDrawFrames = 0;
+ /// Stopwatch time the draw time was last shown
+ long mDrawShownTime = 0;
+
+ /// Paint background
+ void OnPaint(wxPaintEvent& event);
+ /// Add a Beta Fish to Aquarium
+ void OnAddFishBetaFish(wxCommandEvent& event);
+ /// Add a Dovahfin to Aquarium
+ void OnAddFishDovaFish(wxCommandEvent& event);
+ /// Add a Chest to Aquarium
+ void OnAddFishChestFish(wxCommandEvent& event);
+ /// Add a Castle to Aquarium
+ void OnAddDecorCastle(wxCommandEvent& event);
+ void OnAddMany(wxCommandEvent& event);
+ /// Save file as
+ void OnFileSaveAs(wxCommandEvent& event);
+ void OnFileOpen(wxCommandEvent& event);
+ /// Handle mouse event click
+ void OnLeftDown(wxMouseEvent& event);
+ /// Handle mouse event release
+ void OnLeftUp(wxMouseEvent& event);
+ /// Handle mouse movement
+ void OnMouseMove(wxMouseEvent& event);
+ /// Handle right mouse button click, which starts panning
+ void OnRightDown(wxMouseEvent& event);
+ /// Handle the mouse wheel, which zooms
+ void OnMouseWheel(wxMouseEvent& event);
+ /// Zoom in
+ void OnZoomIn(wxCommandEvent& event);
+ /// Zoom out
+ void OnZoomOut(wxCommandEvent& event);
+ /// Reset the camera
+ void OnZoomReset(wxCommandEvent& event);
+ /// Toggle the large tank
+ void OnLargeTank(wxCommandEvent& event);
+ /// Check the large tank menu item while the tank is large
+ void OnUpdateLargeTank(wxUpdateUIEvent& event);
+ /// Toggle schooling
+ void OnSchooling(wxCommandEvent& event);
+ /// Check the schooling menu item while fish school
+ void OnUpdateSchooling(wxUpdateUIEvent& event);
+ /// Toggle collisions
+ void OnCollisions(wxCommandEvent& event);
+ /// Check the collisions menu item while fish collide
+ void OnUpdateCollisions(wxUpdateUIEvent& event);
+ /// Toggle kinetic motion
+ void OnKinetic(wxCommandEvent& event);
+ /// Check the kinetic motion menu item while it is asked for
+ void OnUpdateKinetic(wxUpdateUIEvent& event);
+ /// Choose what the aquarium is drawn with
+ void OnRenderer(wxCommandEvent& event);
+ /// Check the menu item for what the aquarium is drawn with
+ void OnUpdateRenderer(wxUpdateUIEvent& event);
+ /// Show what the aquarium's memory is used for
+ void OnMemory(wxCommandEvent& event);
+
+ void OnDelete(wxCommandEvent& event);
+ void OnBringToFront(wxCommandEvent& event);
+ void OnMirror(wxCommandEvent& event);
+ void OnSelectAll(wxCommandEvent& event);
+ void OnUpdateSelection(wxUpdateUIEvent& event);
+ void SelectRect(const wxRect& rect);
+ void DrawSelection(wxDC& dc);
+ /// Handle completion of a background job
+ void OnJobDone(wxThreadEvent& event);
+ /// Cancel the background job
+ void OnCancelJob(wxCommandEvent& event);
+ /// Enable menu items that cannot be used while a job runs
+ void OnUpdateNoJob(wxUpdateUIEvent& event);
+ /// Enable menu items that cannot be used while a load runs
+ void OnUpdateNoLoad(wxUpdateUIEvent& event);
+ /// Enable the cancel menu item while a job runs
+ void OnUpdateCancelJob(wxUpdateUIEvent& event);
+ void StartJob(const wxString& name, AquariumJob::Work work,
+         AquariumJob::Completion completion);
+ void StartSave(const wxString& name, const wxString& filename);
+ void StartLoad(const wxString& filename);
+ void AddItem(std::shared_ptr<Item> item);
+ void ZoomAt(double factor, const wxPoint& screen);
+ wxPoint PanOrigin() const;
+ wxPoint ScreenToAquarium(const wxPoint& screen) const;
+ void Autosave();
+ wxString AutosaveFilename() const;
+ void SetStatus(const wxString& status);
+
+public:
+ ~AquariumView();
+
+ /// Initializer
+ void Initialize(wxFrame* parent, int tank = 0, std::shared_ptr<Aquarium> aquarium = nullptr);
+ void Step();
+ void Tick();
+ void SetCurrent(bool current, bool outlined);
+ void SetFitting(bool fitting);
+
+ /**
+  * Get the aquarium this view shows
+  * @return The aquarium
+  */
+ std::shared_ptr<Aquarium> GetAquarium() const { return mAquarium; }
+
+ /**
+  * Set how often the view is refreshed
+  * @param interval Milliseconds between refreshes, or 0 for every tick
+  */
+ void SetRefreshInterval(long interval) { mRefreshInterval = interval; }
+
+ /**
+  * Set what to call when the user clicks in the view
+  * @param activated Function to call
+  */
+ void SetActivated(Activated activated) { mActivated = activated; }
+ void Recover();
+ bool Record(const wxString& filename);
+ bool Replay(const wxString& filename);
+ bool SetRenderer(const wxString& name);
+ bool Export(const wxString& name);
+};
+
+
+
+#endif //AQUARIUMVIEW_H
@@ -0,0 +1,346 @@
+/**
+ * @file AssetBundle.cpp
+ * @author Evan Gasper
+ */
+
+#include "pch.h"
+#include "AssetBundle.h"
+#include <cstring>
+#include <mutex>
+#include <wx/ffile.h>
+#include <wx/filename.h>
+#include <wx/stdpaths.h>
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+/// Name of the bundle file next to the executable
+const wxString BundleName = L"assets.aqb";
+
+/// First four bytes of every bundle, including the format version
+const char BundleMagic[4] = {'A', 'Q', 'B', '1'};
+
+/// Longest image name a bundle can hold, in UTF-8 bytes
+const size_t MaxNameLength = 64;
+
+/// Pixel data is aligned to this many bytes in the bundle
+const size_t DataAlignment = 16;
+
+/// Start of the bundle file
+struct BundleHeader {
+ char mMagic[4];          ///< BundleMagic
+ uint32_t mCount;         ///< Number of index entries that follow
+};
+
+/// One index entry in the bundle file
+struct BundleEntry {
+ char mName[MaxNameLength];   ///< Image name, UTF-8, zero padded
+ uint32_t mWidth;             ///< Width in pixels
+ uint32_t mHeight;            ///< Height in pixels
+ uint64_t mRGBOffset;         ///< File offset of the RGB plane
+ uint64_t mAlphaOffset;       ///< File offset of the alpha plane, or 0 if none
+};
+
+/**
+ * Destructor
+ */
+AssetBundle::~AssetBundle()
+{
+ Unmap();
+}
+
+/**
+ * Get the bundle shared by the whole program.
+ *
+ * The first call opens the bundle next to the executable. If there
+ * is none, the shared bundle is left closed and images are loaded
+ * from their own files.
+ *
+ * @return The shared bundle
+ */
+AssetBundle &AssetBundle::Shared()
+{
+ static AssetBundle bundle;
+ static once_flag opened;
+ call_once(opened, []() {
+  wxFileName filename(wxStandardPaths::Get().GetExecutablePath());
+  filename.SetFullName(BundleName);
+  bundle.Open(filename.GetFullPath());
+ });
+
+ return bundle;
+}
+
+/**
+ * Open a bundle file and read its index.
+ *
+ * The pixels are not read. They are paged in from the mapped
+ * file as the images are used.
+ *
+ * @param filename The bundle to open
+ * @return true if successful
+ */
+bool AssetBundle::Open(const wxString &filename)
+{
+ Unmap();
+ if (!Map(filename) || mSize < sizeof(BundleHeader))
+ {
+  Unmap();
+  return false;
+ }
+
+ auto data = static_cast<unsigned char *>(mData);
+ auto header = reinterpret_cast<const BundleHeader *>(data);
+ if (memcmp(header->mMagic, BundleMagic, sizeof(BundleMagic)) != 0 ||
+     mSize < sizeof(BundleHeader) + header->mCount * sizeof(BundleEntry))
+ {
+  Unmap();
+  return false;
+ }
+
+ auto entries = reinterpret_cast<const BundleEntry *>(data + sizeof(BundleHeader));
+ for (uint32_t i = 0; i < header->mCount; i++)
+ {
+  auto &entry = entries[i];
+  uint64_t pixels = uint64_t(entry.mWidth) * entry.mHeight;
+  if (entry.mRGBOffset + pixels * 3 > mSize ||
+      (entry.mAlphaOffset != 0 && entry.mAlphaOffset + pixels > mSize))
+  {
+   Unmap();
+   return false;
+  }
+
+  Entry image;
+  image.mWidth = int(entry.mWidth);
+  image.mHeight = int(entry.mHeight);
+  image.mRGB = data + entry.mRGBOffset;
+  image.mAlpha = entry.mAlphaOffset != 0 ? data + entry.mAlphaOffset : nullptr;
+
+  auto name = wxString::FromUTF8(entry.mName, strnlen(entry.mName, MaxNameLength));
+  mEntries[name] = image;
+ }
+
+ return true;
+}
+
+/**
+ * Map a file into memory.
+ *
+ * The mapping is private, so the pages can be written without
+ * changing the file. wxImage never writes to them, but its
+ * constructor wants pointers it could write through.
+ *
+ * @param filename The file to map
+ * @return true if successful
+ */
+bool AssetBundle::Map(const wxString &filename)
+{
+#ifdef WIN32
+ auto file = CreateFileW(filename.wc_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+         OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+ if (file == INVALID_HANDLE_VALUE)
+ {
+  return false;
+ }
+
+ LARGE_INTEGER size;
+ if (GetFileSizeEx(file, &size))
+ {
+  mSize = size_t(size.QuadPart);
+  mMapping = CreateFileMappingW(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+ }
+
+ CloseHandle(file);
+ if (mMapping == nullptr)
+ {
+  return false;
+ }
+
+ mData = MapViewOfFile(mMapping, FILE_MAP_COPY, 0, 0, 0);
+ return mData != nullptr;
+#else
+ int file = open(filename.fn_str(), O_RDONLY);
+ if (file < 0)
+ {
+  return false;
+ }
+
+ struct stat status;
+ if (fstat(file, &status) == 0 && status.st_size > 0)
+ {
+  mSize = size_t(status.st_size);
+  auto data = mmap(nullptr, mSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+  mData = data != MAP_FAILED ? data : nullptr;
+ }
+
+ close(file);
+ return mData != nullptr;
+#endif
+}
+
+/**
+ * Unmap the bundle file and forget its index
+ */
+void AssetBundle::Unmap()
+{
+ mEntries.clear();
+
+#ifdef WIN32
+ if (mData != nullptr)
+ {
+  UnmapViewOfFile(mData);
+ }
+
+ if (mMapping != nullptr)
+ {
+  CloseHandle(mMapping);
+  mMapping = nullptr;
+ }
+#else
+ if (mData != nullptr)
+ {
+  munmap(mData, mSize);
+ }
+#endif
+
+ mData = nullptr;
+ mSize = 0;
+}
+
+/**
+ * Does the bundle hold an image?
+ * @param name Image name, such as images/beta.png
+ * @return true if the image is in the bundle
+ */
+bool AssetBundle::Contains(const wxString &name) const
+{
+ return mEntries.find(name) != mEntries.end();
+}
+
+/**
+ * Get the size of an image in the bundle
+ * @param name Image name
+ * @return Size in pixels, or 0 by 0 if it is not in the bundle
+ */
+wxSize AssetBundle::GetSize(const wxString &name) const
+{
+ auto entry = mEntries.find(name);
+ if (entry == mEntries.end())
+ {
+  return wxSize(0, 0);
+ }
+
+ return wxSize(entry->second.mWidth, entry->second.mHeight);
+}
+
+/**
+ * Get an image in the bundle.
+ *
+ * The image uses the mapped pixels rather than a copy, so
+ * it must not outlive the bundle.
+ *
+ * @param name Image name
+ * @return The image, or an image that is not Ok if it is not in the bundle
+ */
+wxImage AssetBundle::GetImage(const wxString &name) const
+{
+ auto entry = mEntries.find(name);
+ if (entry == mEntries.end())
+ {
+  return wxImage();
+ }
+
+ auto &image = entry->second;
+ if (image.mAlpha != nullptr)
+ {
+  return wxImage(image.mWidth, image.mHeight, image.mRGB, image.mAlpha, true);
+ }
+
+ return wxImage(image.mWidth, image.mHeight, image.mRGB, true);
+}
+
+/**
+ * Write a bundle file.
+ * @param filename The bundle file to write
+ * @param images The images to put in it, with the names they are found by
+ * @return true if successful
+ */
+bool AssetBundle::Write(const wxString &filename, const std::vector<std::pair<wxString, wxImage>> &images)
+{
+ auto align = [](uint64_t offset) {
+  return (offset + DataAlignment - 1) / DataAlignment * DataAlignment;
+ };
+
+ BundleHeader header;
+ memcpy(header.mMagic, BundleMagic, sizeof(BundleMagic));
+ header.mCount = uint32_t(images.size());
+
+ // Lay out the pixel data after the index
+ vector<BundleEntry> entries(images.size());
+ uint64_t offset = sizeof(BundleHeader) + entries.size() * sizeof(BundleEntry);
+ for (size_t i = 0; i < images.size(); i++)
+ {
+  auto &name = images[i].first;
+  auto &image = images[i].second;
+  auto utf8 = name.ToUTF8();
+  if (!image.IsOk() || utf8.length() > MaxNameLength)
+  {
+   return false;
+  }
+
+  auto &entry = entries[i];
+  memset(&entry, 0, sizeof(entry));
+  memcpy(entry.mName, utf8.data(), utf8.length());
+  entry.mWidth = uint32_t(image.GetWidth());
+  entry.mHeight = uint32_t(image.GetHeight());
+
+  uint64_t pixels = uint64_t(entry.mWidth) * entry.mHeight;
+  entry.mRGBOffset = offset = align(offset);
+  offset += pixels * 3;
+  if (image.HasAlpha())
+  {
+   entry.mAlphaOffset = offset = align(offset);
+   offset += pixels;
+  }
+ }
+
+ wxFFile file(filename, L"wb");
+ if (!file.IsOpened())
+ {
+  return false;
+ }
+
+ bool written = file.Write(&header, sizeof(header)) == sizeof(header) &&
+                file.Write(entries.data(), entries.size() * sizeof(BundleEntry)) ==
+                entries.size() * sizeof(BundleEntry);
+
+ // Zeros written to pad up to each aligned offset
+ const char padding[DataAlignment] = {};
+ auto pad = [&file, &padding](uint64_t to) {
+  auto at = uint64_t(file.Tell());
+  return to <= at || file.Write(padding, size_t(to - at)) == to - at;
+ };
+
+ for (size_t i = 0; i < images.size() && written; i++)
+ {
+  auto &image = images[i].second;
+  auto &entry = entries[i];
+  size_t pixels = size_t(entry.mWidth) * entry.mHeight;
+
+  written = pad(entry.mRGBOffset) && file.Write(image.GetData(), pixels * 3) == pixels * 3;
+  if (written && entry.mAlphaOffset != 0)
+  {
+   written = pad(entry.mAlphaOffset) && file.Write(image.GetAlpha(), pixels) == pixels;
+  }
+ }
+
+ return file.Close() && written;
+}
@@ -0,0 +1,89 @@
+/**
+ * @file AssetBundle.h
+ * @author Evan Gasper
+ *
+ * A single file holding all of the images, already decoded
+ */
+
+#ifndef ASSETBUNDLE_H
+#define ASSETBUNDLE_H
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+/**
+ * A single file holding all of the images, already decoded.
+ *
+ * The build packs the images into the bundle with the asset packer.
+ * At run time the bundle is memory mapped and images are made
+ * straight from the mapped pixels, so starting up needs no PNG
+ * decoding and opens one file rather than one per image.
+ *
+ * Images are stored in the layout wxImage uses: an RGB plane
+ * followed by an optional alpha plane. Numbers are stored in the
+ * byte order of the machine that packed the bundle, which is
+ * always the machine the build is for.
+ */
+class AssetBundle {
+private:
+ /// Where an image is in the bundle
+ struct Entry {
+  /// Width in pixels
+  int mWidth = 0;
+
+  /// Height in pixels
+  int mHeight = 0;
+
+  /// RGB pixels, 3 bytes per pixel
+  unsigned char *mRGB = nullptr;
+
+  /// Alpha values, 1 byte per pixel, or null if none
+  unsigned char *mAlpha = nullptr;
+ };
+
+ /// Start of the mapped file
+ void *mData = nullptr;
+
+ /// Size of the mapped file in bytes
+ size_t mSize = 0;
+
+#ifdef WIN32
+ /// File mapping object for the open bundle
+ void *mMapping = nullptr;
+#endif
+
+ /// The images in the bundle, by name
+ std::map<wxString, Entry> mEntries;
+
+ bool Map(const wxString& filename);
+ void Unmap();
+
+public:
+ AssetBundle() = default;
+ ~AssetBundle();
+
+ /// Copy constructor (disabled)
+ AssetBundle(const AssetBundle &) = delete;
+
+ /// Assignment operator (disabled)
+ void operator=(const AssetBundle &) = delete;
+
+ static AssetBundle &Shared();
+
+ bool Open(const wxString& filename);
+ bool Contains(const wxString& name) const;
+ wxSize GetSize(const wxString& name) const;
+ wxImage GetImage(const wxString& name) const;
+
+ static bool Write(const wxString& filename,
+         const std::vector<std::pair<wxString, wxImage>>& images);
+
+ /**
+  * Is a bundle open?
+  * @return true if Open succeeded
+  */
+ bool IsOpen() const { return mData != nullptr; }
+};
+
+#endif //ASSETBUNDLE_H
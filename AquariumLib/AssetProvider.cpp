@@ -0,0 +1,74 @@
+/**
+ * @file AssetProvider.cpp
+ * @author Evan Gasper
+ */
+
+#include "pch.h"
+#include "AssetProvider.h"
+#include "FileAssetProvider.h"
+#include "WorkerPool.h"
+
+using namespace std;
+
+/**
+ * Get the sprite for an image.
+ *
+ * The first time an image is asked for, its sprite is created
+ * and the worker pool starts decoding it. After that, the same
+ * sprite is returned. Safe to call from any thread.
+ *
+ * @param name The image name
+ * @return The sprite, which may not be decoded yet
+ */
+std::shared_ptr<Sprite> AssetProvider::GetSprite(const wxString &name)
+{
+ lock_guard<mutex> lock(mMutex);
+ auto &sprite = mSprites[name];
+ if (sprite == nullptr)
+ {
+  sprite = make_shared<Sprite>(shared_from_this(), name);
+  if (!sprite->IsReady())
+  {
+   WorkerPool::Shared().Submit([sprite]() { sprite->Decode(); });
+  }
+ }
+
+ return sprite;
+}
+
+/**
+ * Get the species for an image and way of schooling.
+ *
+ * Every call with the same arguments returns the same species.
+ * Safe to call from any thread.
+ *
+ * @param name The image items of the species draw
+ * @param schooling How the species schools, which must outlive it, or null
+ * @return The species, which lasts as long as the provider
+ */
+const Species *AssetProvider::GetSpecies(const wxString &name, const Species::Schooling *schooling)
+{
+ // Made before taking the lock, since GetSprite takes it too
+ auto sprite = GetSprite(name);
+
+ lock_guard<mutex> lock(mMutex);
+ auto &species = mSpecies[{name, schooling}];
+ if (species == nullptr)
+ {
+  species = make_unique<Species>(sprite, schooling);
+ }
+
+ return species.get();
+}
+
+/**
+ * Get the provider shared by the whole program, which
+ * loads images from the asset bundle or image files.
+ * Aquariums not given a provider of their own use it.
+ * @return The shared provider
+ */
+std::shared_ptr<AssetProvider> AssetProvider::Shared()
+{
+ static auto provider = make_shared<FileAssetProvider>();
+ return provider;
+}
@@ -0,0 +1,73 @@
+/**
+ * @file AssetProvider.h
+ * @author Evan Gasper
+ *
+ * Where the images items draw come from
+ */
+
+#ifndef ASSETPROVIDER_H
+#define ASSETPROVIDER_H
+
+#include "Species.h"
+
+#include <map>
+#include <memory>
+#include <mutex>
+
+/**
+ * Where the images items draw come from.
+ *
+ * Every aquarium has a provider, which every item it creates
+ * gets its species and sprites from. Derived classes say how an
+ * image is found; this class shares the sprites and species made
+ * from them, so each image is decoded once per provider.
+ *
+ * Providers are always held by a shared_ptr. Sprites and species
+ * belong to the provider that made them and are only valid while
+ * it is.
+ */
+class AssetProvider : public std::enable_shared_from_this<AssetProvider> {
+private:
+ /// Protects mSprites and mSpecies, since items are created on worker threads
+ std::mutex mMutex;
+
+ /// Sprites made so far, by image name
+ std::map<wxString, std::shared_ptr<Sprite>> mSprites;
+
+ /// Species made so far, by image name and way of schooling
+ std::map<std::pair<wxString, const Species::Schooling*>, std::unique_ptr<Species>> mSpecies;
+
+protected:
+ AssetProvider() = default;
+
+public:
+ virtual ~AssetProvider() = default;
+
+ /// Copy constructor (disabled)
+ AssetProvider(const AssetProvider &) = delete;
+
+ /// Assignment operator (disabled)
+ void operator=(const AssetProvider &) = delete;
+
+ /**
+  * Get the size of an image without decoding it, if that can be done.
+  * Called from any thread.
+  * @param name The image name, a path relative to the program's directory
+  * @return Size in pixels, or wxDefaultSize if only decoding can tell
+  */
+ virtual wxSize GetSize(const wxString& name) = 0;
+
+ /**
+  * Decode an image. Called from any thread.
+  * @param name The image name, a path relative to the program's directory
+  * @return The image, which is not ok if it could not be loaded
+  */
+ virtual wxImage Load(const wxString& name) = 0;
+
+ std::shared_ptr<Sprite> GetSprite(const wxString& name);
+ const Species* GetSpecies(const wxString& name, const Species::Schooling* schooling = nullptr);
+
+ static std::shared_ptr<AssetProvider> Shared();
+};
+
+#endif //ASSETPROVIDER_H
@@ -0,0 +1,97 @@
+/**
+ * @file AttributeCodec.cpp
+ * @author Evan Gasper
+ */
+
+#include "pch.h"
+#include "AttributeCodec.h"
+#include <charconv>
+
+/**
+ * Convert a number to text
+ * @param value The number
+ * @return Shortest text that parses back to exactly value
+ */
+wxString AttributeCodec::Format(double value)
+{
+ char text[MaxLength];
+ auto result = std::to_chars(text, text + sizeof(text), value);
+ return wxString::FromAscii(text, result.ptr - text);
+}
+
+/**
+ * Convert text to a number.
+ *
+ * The whole text has to be a number. Nothing is allocated,
+ * and the locale makes no difference.
+ *
+ * @param text The text to convert
+ * @param value Receives the number, unchanged if the text is not one
+ * @return true if the text is a number
+ */
+bool AttributeCodec::Parse(const wxString &text, double *value)
+{
+ // from_chars works on narrow characters, and numbers are plain ASCII
+ char narrow[MaxLength];
+ auto length = text.length();
+ if (length == 0 || length > sizeof(narrow))
+ {
+  return false;
+ }
+
+ size_t i = 0;
+ for (auto c : text)
+ {
+  if (c > 0x7f)
+  {
+   return false;
+  }
+
+  narrow[i++] = char(c);
+ }
+
+ double parsed;
+ auto result = std::from_chars(narrow, narrow + length, parsed);
+ if (result.ec != std::errc() || result.ptr != narrow + length)
+ {
+  return false;
+ }
+
+ *value = parsed;
+ return true;
+}
+
+/**
+ * Add a number attribute to an XML node
+ * @param node The node to add the attribute to
+ * @param name Attribute name
+ * @param value The number
+ */
+void AttributeCodec::Save(wxXmlNode *node, const wxString &name, double value)
+{
+ node->AddAttribute(name, Format(value));
+}
+
+/**
+ * Get a number attribute of an XML node.
+ *
+ * The attribute text is read where it is, without copying it.
+ *
+ * @param node The node to get the attribute of
+ * @param name Attribute name
+ * @param value Value to return if the attribute is missing or not a number
+ * @return The number
+ */
+double AttributeCodec::Load(wxXmlNode *node, const wxString &name, double value)
+{
+ for (auto attr = node->GetAttributes(); attr; attr = attr->GetNext())
+ {
+  if (attr->GetName() == name)
+  {
+   Parse(attr->GetValue(), &value);
+   break;
+  }
+ }
+
+ return value;
+}
@@ -0,0 +1,31 @@
+/**
+ * @file AttributeCodec.h
+ * @author Evan Gasper
+ *
+ * Converts numbers to and from the text saved in aquarium files
+ */
+
+#ifndef ATTRIBUTECODEC_H
+#define ATTRIBUTECODEC_H
+
+/**
+ * Converts numbers to and from the text saved in aquarium files.
+ *
+ * Numbers are written in the shortest form that reads back as exactly
+ * the same value, always with a period for the decimal point whatever
+ * the locale is. Reading does not allocate and accepts only what
+ * Format writes, so a file reads the same on every machine.
+ */
+class AttributeCodec {
+public:
+ /// Longest text Format can produce, in characters
+ static const size_t MaxLength = 32;
+
+ static wxString Format(double value);
+ static bool Parse(const wxString& text, double* value);
+
+ static void Save(wxXmlNode* node, const wxString& name, double value);
+ static double Load(wxXmlNode* node, const wxString& name, double value = 0);
+};
+
+#endif //ATTRIBUTECODEC_H
@@ -1,35 +1,38 @@
-/**
- * @file ChestFish.h
- * @author Evan Gasper
- *
- * A class representing the chests
- */
- 
-#ifndef CHESTFISH_H
-#define CHESTFISH_H
-
-#include "Fish.h"
-
-/**
- * Class representing the Chest
- */
-class ChestFish : public Fish {
-private:
-
-public:
- /// Disable default constructor
- ChestFish() = delete;
- /// Disable default copy
- ChestFish(const ChestFish&) = delete;
- /// Constructor
- ChestFish(Aquarium* aquarium);
- /// Disable default Assignment
- void operator = (const ChestFish&) = delete;
-
- /// Used to determine type of fish when saving
- wxXmlNode* XmlSave(wxXmlNode* node) override;
-};
-
-
-
-#endif //CHESTFISH_H
+/**
+ * @file ChestFish.h
+ * @author Evan Gasper
+ *
+ * A class representing the chests
+ */
+ 
+#ifndef CHESTFISH_H
+#define CHESTFISH_H
+
+#include "SpeciesFish.h"
+
+/**
+ * What makes a Chest. A chest barely moves across the
+ * screen horizontally, does not move up and down
+ * and does not school.
+ */
+struct ChestFishTraits {
+ /// Type name the chest is saved with
+ static constexpr const wchar_t* Type = L"chest";
+ /// Chest filename
+ static constexpr const wchar_t* ImageName = L"images/chest1.png";
+ /// X min speed
+ static constexpr double SpeedXMin = 0.1;
+ /// X max speed
+ static constexpr double SpeedXMax = 0.2;
+ /// Y min speed
+ static constexpr double SpeedYMin = 0;
+ /// Y max speed
+ static constexpr double SpeedYMax = 0;
+ /// Chests do not school
+ static constexpr const Species::Schooling* Schooling = nullptr;
+};
+
+/// Class representing the Chest
+using ChestFish = SpeciesFish<ChestFishTraits>;
+
+#endif //CHESTFISH_H
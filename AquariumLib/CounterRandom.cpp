@@ -0,0 +1,141 @@
+/**
+ * @file CounterRandom.cpp
+ * @author Evan Gasper
+ */
+
+#include "pch.h"
+#include "CounterRandom.h"
+
+/// Multiplier of the first counter word in each round
+const uint32_t PhiloxMultiplier0 = 0xD2511F53;
+/// Multiplier of the third counter word in each round
+const uint32_t PhiloxMultiplier1 = 0xCD9E8D57;
+
+/// Amount the first key word is bumped by after each round
+const uint32_t PhiloxWeyl0 = 0x9E3779B9;
+/// Amount the second key word is bumped by after each round
+const uint32_t PhiloxWeyl1 = 0xBB67AE85;
+
+/// Number of rounds, enough for the output to pass BigCrush
+const int PhiloxRounds = 10;
+
+/**
+ * Constructor
+ * @param seed The seed, shared by every stream
+ * @param stream Stream to draw from
+ */
+CounterRandom::CounterRandom(uint64_t seed, uint64_t stream) : mStream(stream)
+{
+ this->seed(seed);
+}
+
+/**
+ * Reseed the generator.
+ *
+ * Goes back to the start of our stream, and the
+ * next streams reserved start from 0 again.
+ *
+ * @param seed The new seed
+ */
+void CounterRandom::seed(uint64_t seed)
+{
+ mKey[0] = uint32_t(seed);
+ mKey[1] = uint32_t(seed >> 32);
+ mBlock = 0;
+ mUsed = 4;
+ mReserved = 0;
+}
+
+/**
+ * Get the next number in our stream
+ * @return The number
+ */
+CounterRandom::result_type CounterRandom::operator()()
+{
+ if (mUsed == 4)
+ {
+  MakeBlock();
+ }
+
+ return mOutput[mUsed++];
+}
+
+/**
+ * Get a generator for another stream with the same seed.
+ *
+ * The generator starts at the beginning of the stream, however
+ * far this one has got, so the same stream always gives the same
+ * numbers, whichever thread draws them.
+ *
+ * @param stream Stream number
+ * @return The generator
+ */
+CounterRandom CounterRandom::Stream(uint64_t stream) const
+{
+ CounterRandom random(0, stream);
+ random.mKey[0] = mKey[0];
+ random.mKey[1] = mKey[1];
+ return random;
+}
+
+/**
+ * Reserve streams no one has drawn from since the last seed.
+ *
+ * Used to give each of a number of items a stream of its own,
+ * so they can be created in any order.
+ *
+ * @param count Number of streams
+ * @return The first stream, the rest follow it
+ */
+uint64_t CounterRandom::Reserve(uint64_t count)
+{
+ auto first = mReserved;
+ mReserved += count;
+ return first;
+}
+
+/**
+ * Make the next block of four numbers in our stream
+ */
+void CounterRandom::MakeBlock()
+{
+ uint32_t counter[4] = {uint32_t(mBlock), uint32_t(mBlock >> 32), uint32_t(mStream), uint32_t(mStream >> 32)};
+ Philox(counter, mKey, mOutput);
+ mBlock++;
+ mUsed = 0;
+}
+
+/**
+ * The Philox4x32-10 block function.
+ *
+ * Ten rounds of multiplies and exclusive ors, mixing the key
+ * into the counter, from Salmon et al., "Parallel Random Numbers:
+ * As Easy as 1, 2, 3".
+ *
+ * @param counter The four counter words
+ * @param key The two key words
+ * @param output The four words made
+ */
+void CounterRandom::Philox(const uint32_t counter[4], const uint32_t key[2], uint32_t output[4])
+{
+ uint32_t c[4] = {counter[0], counter[1], counter[2], counter[3]};
+ uint32_t k[2] = {key[0], key[1]};
+ for (int round = 0; round < PhiloxRounds; round++)
+ {
+  uint64_t product0 = uint64_t(PhiloxMultiplier0) * c[0];
+  uint64_t product1 = uint64_t(PhiloxMultiplier1) * c[2];
+  uint32_t next[4] = {uint32_t(product1 >> 32) ^ c[1] ^ k[0], uint32_t(product1),
+          uint32_t(product0 >> 32) ^ c[3] ^ k[1], uint32_t(product0)};
+  c[0] = next[0];
+  c[1] = next[1];
+  c[2] = next[2];
+  c[3] = next[3];
+  k[0] += PhiloxWeyl0;
+  k[1] += PhiloxWeyl1;
+ }
+
+ output[0] = c[0];
+ output[1] = c[1];
+ output[2] = c[2];
+ output[3] = c[3];
+}
@@ -0,0 +1,84 @@
+/**
+ * @file CounterRandom.h
+ * @author Evan Gasper
+ *
+ * Counter-based random number generator
+ */
+
+#ifndef COUNTERRANDOM_H
+#define COUNTERRANDOM_H
+
+#include <cstdint>
+#include <limits>
+
+/**
+ * Counter-based random number generator, using Philox4x32-10.
+ *
+ * Each number is a hash of the seed, a stream number and how
+ * many numbers came before it in the stream, rather than the
+ * next step of a shared state. Streams are independent of each
+ * other, so each item can be given a stream of its own and
+ * created on any thread, with the same result for the same seed.
+ *
+ * The generator can be used with the standard distributions.
+ */
+class CounterRandom {
+public:
+ /// Type of the numbers generated
+ typedef uint32_t result_type;
+
+ /// Stream the generator draws from if no other is asked for.
+ /// Streams handed out by Reserve count up from 0.
+ static const uint64_t MainStream = std::numeric_limits<uint64_t>::max();
+
+private:
+ /// The seed, split into the two Philox key words
+ uint32_t mKey[2];
+
+ /// Stream we draw from
+ uint64_t mStream;
+
+ /// Block of four numbers to make next in the stream
+ uint64_t mBlock = 0;
+
+ /// The last block made
+ uint32_t mOutput[4] = {0, 0, 0, 0};
+
+ /// Numbers of mOutput used so far
+ int mUsed = 4;
+
+ /// Streams handed out by Reserve so far
+ uint64_t mReserved = 0;
+
+ void MakeBlock();
+
+public:
+ explicit CounterRandom(uint64_t seed = 0, uint64_t stream = MainStream);
+
+ void seed(uint64_t seed);
+ result_type operator()();
+ CounterRandom Stream(uint64_t stream) const;
+ uint64_t Reserve(uint64_t count);
+
+ /**
+  * Smallest number generated
+  * @return 0
+  */
+ static constexpr result_type min() { return 0; }
+
+ /**
+  * Largest number generated
+  * @return Largest 32 bit number
+  */
+ static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+ /**
+  * Get the stream we draw from
+  * @return Stream number
+  */
+ uint64_t GetStream() const { return mStream; }
+
+ static void Philox(const uint32_t counter[4], const uint32_t key[2], uint32_t output[4]);
+};
+
+#endif //COUNTERRANDOM_H
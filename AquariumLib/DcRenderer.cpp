@@ -0,0 +1,81 @@
+/**
+ * @file DcRenderer.cpp
+ * @author Evan Gasper
+ */
+
+#include "pch.h"
+#include "DcRenderer.h"
+#include "Sprite.h"
+
+/// Name this renderer is chosen by
+const wxString DcRenderer::Name = L"dc";
+
+/**
+ * Start drawing a frame
+ * @param dc Device context to draw on
+ * @param scale How many screen pixels there are to each aquarium pixel
+ * @param origin The aquarium point at the top left of the screen
+ */
+void DcRenderer::Begin(wxDC *dc, double scale, const wxPoint &origin)
+{
+ mDC = dc;
+ mDC->SetUserScale(scale, scale);
+ mDC->SetLogicalOrigin(origin.x, origin.y);
+ mDC->SetPen(*wxTRANSPARENT_PEN);
+ mBrushColour = wxColour();
+}
+
+/**
+ * Finish drawing a frame
+ */
+void DcRenderer::End()
+{
+ mDC = nullptr;
+}
+
+/**
+ * Draw a sprite
+ * @param sprite The sprite to draw
+ * @param x Left edge in aquarium pixels
+ * @param y Top edge in aquarium pixels
+ * @param mirror True to draw the sprite mirrored left to right
+ * @param level Level of detail, 0 for full size
+ */
+void DcRenderer::DrawSprite(Sprite *sprite, int x, int y, bool mirror, int level)
+{
+ sprite->Draw(mDC, x, y, mirror, level);
+}
+
+/**
+ * Fill a rectangle with no outline
+ * @param brush The brush to fill with
+ * @param x Left edge in aquarium pixels
+ * @param y Top edge in aquarium pixels
+ * @param width Width in aquarium pixels
+ * @param height Height in aquarium pixels
+ */
+void DcRenderer::FillRectangle(const wxBrush &brush, int x, int y, int width, int height)
+{
+ if (!mBrushColour.IsOk() || brush.GetColour() != mBrushColour)
+ {
+  mDC->SetBrush(brush);
+  mBrushColour = brush.GetColour();
+ }
+
+ mDC->DrawRectangle(x, y, width, height);
+}
+
+/**
+ * Draw some text
+ * @param text The text to draw
+ * @param x Left edge in aquarium pixels
+ * @param y Top edge in aquarium pixels
+ * @param font The font to draw with
+ * @param colour The colour of the text
+ */
+void DcRenderer::DrawText(const wxString &text, int x, int y, const wxFont &font, const wxColour &colour)
+{
+ mDC->SetFont(font);
+ mDC->SetTextForeground(colour);
+ mDC->DrawText(text, x, y);
+}
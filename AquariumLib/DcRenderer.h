@@ -0,0 +1,45 @@
+/**
+ * @file DcRenderer.h
+ * @author Evan Gasper
+ *
+ * Draws the aquarium straight onto a device context
+ */
+
+#ifndef DCRENDERER_H
+#define DCRENDERER_H
+
+#include "Renderer.h"
+
+/**
+ * Draws the aquarium straight onto a device context.
+ *
+ * The camera is set on the device context as a user scale and
+ * logical origin, and each call draws right away. The brush is
+ * only changed when a rectangle needs a different one.
+ */
+class DcRenderer : public Renderer {
+private:
+ /// The device context being drawn on, between Begin and End
+ wxDC* mDC = nullptr;
+
+ /// Colour of the brush last set on mDC
+ wxColour mBrushColour;
+
+public:
+ /// Name this renderer is chosen by
+ static const wxString Name;
+
+ void Begin(wxDC* dc, double scale, const wxPoint& origin) override;
+ void End() override;
+ void DrawSprite(Sprite* sprite, int x, int y, bool mirror = false, int level = 0) override;
+ void FillRectangle(const wxBrush& brush, int x, int y, int width, int height) override;
+ void DrawText(const wxString& text, int x, int y, const wxFont& font, const wxColour& colour) override;
+
+ /**
+  * The name the renderer is chosen by
+  * @return Name
+  */
+ wxString GetName() const override { return Name; }
+};
+
+#endif //DCRENDERER_H
@@ -1,36 +1,48 @@
-/**
- * @file DecorCastle.h
- * @author Evan Gasper
- *
- * Class representing a castle
- */
- 
-#ifndef DECORCASTLE_H
-#define DECORCASTLE_H
-
-#include "Item.h"
-
-/// Castle holding information for the decoration object, castle
-class DecorCastle : public Item {
-private:
-
-public:
- /// Disable Constructor
- DecorCastle() = delete;
-
- /// Disable Copy
- DecorCastle(const DecorCastle &) = delete;
-
- /// Disable Destructor
- void operator=(const DecorCastle &) = delete;
-
- /// Constructor
- DecorCastle(Aquarium *aquarium);
-
- /// Used to determine type of fish when saving
- wxXmlNode* XmlSave(wxXmlNode* node) override;
-};
-
-
-
-#endif //DECORCASTLE_H
+/**
+ * @file DecorCastle.h
+ * @author Evan Gasper
+ *
+ * Class representing a castle
+ */
+ 
+#ifndef DECORCASTLE_H
+#define DECORCASTLE_H
+
+#include "Item.h"
+
+/// Castle holding information for the decoration object, castle
+class DecorCastle : public Item {
+private:
+
+public:
+ /// Disable Constructor
+ DecorCastle() = delete;
+
+ /// Disable Copy
+ DecorCastle(const DecorCastle &) = delete;
+
+ /// Disable Destructor
+ void operator=(const DecorCastle &) = delete;
+
+ /// Constructor
+ DecorCastle(Aquarium *aquarium);
+
+ /// Used to determine type of the castle when saving
+ void GetState(ItemState &state) const override;
+
+ /**
+  * Castles are solid, so they hide the items behind them
+  * @return true
+  */
+ bool IsOccluder() const override { return true; }
+
+ /**
+  * Fish bump into castles
+  * @return true
+  */
+ bool IsSolid() const override { return true; }
+};
+
+
+
+#endif //DECORCASTLE_H
@@ -1,39 +1,39 @@
-/**
- * @file DovaFish.h
- * @author Evan Gasper
- *
- * A class representing the DovaFish
- */
- 
-#ifndef DOVAFISH_H
-#define DOVAFISH_H
-
-#include "Item.h"
-#include "Fish.h"
-
-/**
- * Class representing the Skyrim Themed Fish
- */
-class DovaFish : public Fish{
-private:
-
-public:
- /// Disable Default constructor
- DovaFish() = delete;
-
- /// Disable Copy constructor
- DovaFish(const DovaFish &) = delete;
-
- /// Disable Assignment operator
- void operator=(const DovaFish &) = delete;
-
- /// Constructor
- DovaFish(Aquarium* aquarium);
-
- /// Used to determine type of fish when saving
- wxXmlNode* XmlSave(wxXmlNode* node) override;
-};
-
-
-
-#endif //DOVAFISH_H
+/**
+ * @file DovaFish.h
+ * @author Evan Gasper
+ *
+ * A class representing the DovaFish
+ */
+ 
+#ifndef DOVAFISH_H
+#define DOVAFISH_H
+
+#include "SpeciesFish.h"
+
+/**
+ * What makes the Skyrim Themed Fish. Dova fish swim
+ * far faster, and in tight, fast schools.
+ */
+struct DovaFishTraits {
+ /// Type name the fish is saved with
+ static constexpr const wchar_t* Type = L"dova";
+ /// DovaFish filepath
+ static constexpr const wchar_t* ImageName = L"images/dovahfin.png";
+ /// X min speed
+ static constexpr double SpeedXMin = 15;
+ /// X max speed
+ static constexpr double SpeedXMax = 30;
+ /// Y min speed
+ static constexpr double SpeedYMin = -5;
+ /// Y max speed
+ static constexpr double SpeedYMax = 5;
+ /// How dova fish school
+ static constexpr Species::Schooling Schools = {3, 2, 0.3, 15, 35};
+ /// Dova fish school
+ static constexpr const Species::Schooling* Schooling = &Schools;
+};
+
+/// Class representing the Skyrim Themed Fish
+using DovaFish = SpeciesFish<DovaFishTraits>;
+
+#endif //DOVAFISH_H
@@ -0,0 +1,65 @@
+/**
+ * @file FileAssetProvider.cpp
+ * @author Evan Gasper
+ */
+
+#include "pch.h"
+#include "FileAssetProvider.h"
+#include "AssetBundle.h"
+#include <cstring>
+#include <wx/ffile.h>
+
+/// Bytes at the start of every PNG file
+const unsigned char PngSignature[] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+
+/// Size of the PNG signature plus the start of the IHDR chunk,
+/// which holds the width and height as 32 bit big endian numbers
+const size_t PngHeaderSize = 24;
+
+/**
+ * Get the size of an image from the asset bundle, or
+ * from the header of its file if it is a PNG
+ * @param name The image name
+ * @return Size in pixels, or wxDefaultSize if only decoding can tell
+ */
+wxSize FileAssetProvider::GetSize(const wxString &name)
+{
+ auto &bundle = AssetBundle::Shared();
+ if (bundle.Contains(name))
+ {
+  return bundle.GetSize(name);
+ }
+
+ wxFFile file(name, L"rb");
+ unsigned char header[PngHeaderSize];
+ if (!file.IsOpened() || file.Read(header, sizeof(header)) != sizeof(header) ||
+     memcmp(header, PngSignature, sizeof(PngSignature)) != 0)
+ {
+  return wxDefaultSize;
+ }
+
+ auto bigEndian = [&header](size_t at) {
+  return int(header[at]) << 24 | int(header[at + 1]) << 16 | int(header[at + 2]) << 8 | int(header[at + 3]);
+ };
+
+ return wxSize(bigEndian(16), bigEndian(20));
+}
+
+/**
+ * Load an image from the asset bundle, where it is already
+ * decoded, or else decode its file
+ * @param name The image name
+ * @return The image, which is not ok if it could not be loaded
+ */
+wxImage FileAssetProvider::Load(const wxString &name)
+{
+ auto &bundle = AssetBundle::Shared();
+ if (bundle.Contains(name))
+ {
+  return bundle.GetImage(name);
+ }
+
+ wxImage image;
+ image.LoadFile(name, wxBITMAP_TYPE_ANY);
+ return image;
+}
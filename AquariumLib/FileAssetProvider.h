@@ -0,0 +1,27 @@
+/**
+ * @file FileAssetProvider.h
+ * @author Evan Gasper
+ *
+ * Provides images from the asset bundle or image files
+ */
+
+#ifndef FILEASSETPROVIDER_H
+#define FILEASSETPROVIDER_H
+
+#include "AssetProvider.h"
+
+/**
+ * Provides images from the asset bundle, or from the
+ * image files if the bundle does not have them.
+ *
+ * Image names are paths relative to the working directory.
+ */
+class FileAssetProvider : public AssetProvider {
+public:
+ FileAssetProvider() = default;
+
+ wxSize GetSize(const wxString& name) override;
+ wxImage Load(const wxString& name) override;
+};
+
+#endif //FILEASSETPROVIDER_H
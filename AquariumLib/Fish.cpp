@@ -1,107 +1,341 @@
-/**
- * @file Fish.cpp
- * @author Evan Gasper
- *
- * Fish swim around the aquarium
- */
-
-#include "pch.h"
-#include "Fish.h"
-#include "Aquarium.h"
-#include <random>
-
-/**
- * Constructor
- * @param aquarium The aquarium we are in
- * @param filename Filename for the image we use
- */
-Fish::Fish(Aquarium *aquarium, const std::wstring &filename) :
-    Item(aquarium, filename)
-{
-    std::uniform_real_distribution<> distributionX(MinSpeedX, MaxSpeedX);
-    mSpeedX = distributionX(aquarium->GetRandom());
-    std::uniform_real_distribution<> distributionY(MinSpeedY, MaxSpeedY);
-    mSpeedY = distributionY(aquarium->GetRandom());
-}
-
-
-/**
- * Handle updates in time of our fish
- *
- * This is called before we draw and allows us to
- * move our fish. We add our speed times the amount
- * of time that has elapsed.
- * @param elapsed Time elapsed since the class call
- */
-void Fish::Update(double elapsed)
-{
-    SetLocation(GetX() + mSpeedX * elapsed,
-            GetY() + mSpeedY * elapsed);
-    // Access the item image and bitmap through the protected accessors
-    wxImage* fishImage = GetItemImage();
-
-    double aquariumWidth = GetAquarium()->GetWidth();
-    double aquariumHeight = GetAquarium()->GetHeight();
-
-    double fishWidth = fishImage->GetWidth();
-    double fishHeight = fishImage->GetHeight();
-
-    if (mSpeedX > 0 && GetX() >= (aquariumWidth - 10 - fishWidth / 2))
-    {
-        mSpeedX = -mSpeedX;
-        SetMirror(true);
-    }
-    else if (mSpeedX < 0 && GetX() <= (10 + fishWidth / 2))
-    {
-        mSpeedX = -mSpeedX;
-        SetMirror(false);
-    }
-    // Prevent fish from moving out of aquarium vertically
-    if (GetY() < (10 + fishHeight) || GetY() > (aquariumHeight - 10 - fishHeight))
-    {
-        mSpeedY = -mSpeedY;  // Reverse vertical direction
-    }
-}
-
-/**
- * Saving specific values pertaining to fish
- * @param node the base XmlNode that will be appended
- * @return wxXmlNode* the pointer to the node
- */
-wxXmlNode* Fish::XmlSave(wxXmlNode* node)
-{
-    auto itemNode =  Item::XmlSave(node);
-
-    // Add speed attributes to the node
-    itemNode->AddAttribute(L"speedx", wxString::FromDouble(mSpeedX));
-    itemNode->AddAttribute(L"speedy", wxString::FromDouble(mSpeedY));
-
-    return itemNode;
-}
-
-/**
- * Loading specific values pertaining to fish
- * @param node the base XmlNode that will be loaded
- *
- */
-void Fish::XmlLoad(wxXmlNode* node)
-{
-
-    Item::XmlLoad(node);
-
-    // Load speed from xml tag
-    double speedX = 0.0;
-    double speedY = 0.0;
-    node->GetAttribute(L"speedx", L"0.0").ToDouble(&speedX);
-    node->GetAttribute(L"speedy", L"0.0").ToDouble(&speedY);
-
-    mSpeedX = speedX;
-    mSpeedY = speedY;
-
-    if (mSpeedX < 0) {
-        SetMirror(true);  // Mirror if speedX is negative
-    } else {
-        SetMirror(false); // No mirror if speedX is positive
-    }
-
-}
+/**
+ * @file Fish.cpp
+ * @author Evan Gasper
+ *
+ * Fish swim around the aquarium
+ */
+
+#include "pch.h"
+#include "Fish.h"
+#include "Aquarium.h"
+#include "AttributeCodec.h"
+#include "School.h"
+#include <random>
+#include <cmath>
+
+/// Fish closer than this fraction of the schooling
+/// radius are steered away from
+const double SeparationFraction = 0.3;
+
+/// Most neighbours a fish steers by, so crowded
+/// schools cost no more than sparse ones
+const int MaxNeighbours = 16;
+
+/// A fish this many seconds from a wall has reached it,
+/// which allows for rounding in working out where it is
+const double WallTolerance = 1e-9;
+
+/**
+ * Time until a coordinate moving at a speed reaches a limit
+ * @param at The coordinate
+ * @param speed Speed of the coordinate
+ * @param low The lower limit
+ * @param high The upper limit
+ * @return Time, zero if past the limit it is moving toward, or
+ * infinity if not moving or the limits leave no room to move
+ */
+static double TimeToLimit(double at, double speed, double low, double high)
+{
+    if (speed == 0 || low >= high)
+    {
+        return std::numeric_limits<double>::infinity();
+    }
+
+    return std::fmax(0, ((speed > 0 ? high : low) - at) / speed);
+}
+
+/**
+ * Constructor
+ * @param aquarium The aquarium we are in, which picks our speed
+ * @param species What we have in common with other fish of our kind
+ */
+Fish::Fish(Aquarium *aquarium, const Species *species) :
+    Item(species)
+{
+    std::uniform_real_distribution<> distributionX(MinSpeedX, MaxSpeedX);
+    mSpeedX = distributionX(aquarium->GetRandom());
+    std::uniform_real_distribution<> distributionY(MinSpeedY, MaxSpeedY);
+    mSpeedY = distributionY(aquarium->GetRandom());
+}
+
+
+/**
+ * Handle updates in time of our fish
+ *
+ * This is called before we draw and allows us to
+ * move our fish. We add our speed times the amount
+ * of time that has elapsed. Schooling fish steer
+ * by their neighbours first.
+ * @param aquarium The aquarium we are in
+ * @param elapsed Time elapsed since the class call
+ */
+void Fish::Update(const Aquarium &aquarium, double elapsed)
+{
+    auto school = aquarium.GetSchool();
+    auto schooling = GetSpecies()->GetSchooling();
+    if (school != nullptr && schooling != nullptr)
+    {
+        Steer(*school, *schooling, elapsed);
+    }
+
+    // Aquarium::Update already knows every fish moves
+    Place(GetX() + mSpeedX * elapsed,
+            GetY() + mSpeedY * elapsed);
+    // The image size is known before the image is decoded
+    double aquariumWidth = aquarium.GetWidth();
+    double aquariumHeight = aquarium.GetHeight();
+
+    double fishWidth = GetItemSize().GetWidth();
+    double fishHeight = GetItemSize().GetHeight();
+
+    if (mSpeedX > 0 && GetX() >= (aquariumWidth - 10 - fishWidth / 2))
+    {
+        mSpeedX = -mSpeedX;
+        SetMirror(true);
+    }
+    else if (mSpeedX < 0 && GetX() <= (10 + fishWidth / 2))
+    {
+        mSpeedX = -mSpeedX;
+        SetMirror(false);
+    }
+    // Prevent fish from moving out of aquarium vertically
+    if (GetY() < (10 + fishHeight) || GetY() > (aquariumHeight - 10 - fishHeight))
+    {
+        mSpeedY = -mSpeedY;  // Reverse vertical direction
+    }
+}
+
+/**
+ * Steer by the neighbours in the school.
+ *
+ * The usual three rules: move away from fish that are too close,
+ * match the speed of the rest, and move toward their centre.
+ * Only the first MaxNeighbours within the radius are looked at.
+ *
+ * @param school Where every schooling fish was at the start of the step
+ * @param schooling How our species schools
+ * @param elapsed Time elapsed since the last update
+ */
+void Fish::Steer(const School &school, const Species::Schooling &schooling, double elapsed)
+{
+    auto &self = school.GetMember(mSchoolIndex);
+    double radius = school.GetCellSize();
+    double separation = radius * SeparationFraction;
+
+    double awayX = 0, awayY = 0;
+    double speedX = 0, speedY = 0;
+    double centreX = 0, centreY = 0;
+    int neighbours = 0;
+    int found = 0;
+    school.Visit(self.mX, self.mY, [&](size_t index) {
+        auto &other = school.GetMember(index);
+        double dx = self.mX - other.mX;
+        double dy = self.mY - other.mY;
+        double distance = std::sqrt(dx * dx + dy * dy);
+        if (index == mSchoolIndex || distance >= radius)
+        {
+            return true;
+        }
+
+        if (distance < separation && distance > 0)
+        {
+            awayX += dx / distance * (separation - distance);
+            awayY += dy / distance * (separation - distance);
+        }
+
+        if (other.mSpecies == self.mSpecies)
+        {
+            speedX += other.mSpeedX;
+            speedY += other.mSpeedY;
+            centreX += other.mX;
+            centreY += other.mY;
+            neighbours++;
+        }
+
+        return ++found < MaxNeighbours;
+    });
+
+    double accelX = awayX * schooling.mSeparation;
+    double accelY = awayY * schooling.mSeparation;
+    if (neighbours > 0)
+    {
+        accelX += (speedX / neighbours - mSpeedX) * schooling.mAlignment +
+                (centreX / neighbours - self.mX) * schooling.mCohesion;
+        accelY += (speedY / neighbours - mSpeedY) * schooling.mAlignment +
+                (centreY / neighbours - self.mY) * schooling.mCohesion;
+    }
+
+    mSpeedX += accelX * elapsed;
+    mSpeedY += accelY * elapsed;
+
+    // Keep to the speeds the species swims at
+    double speed = std::sqrt(mSpeedX * mSpeedX + mSpeedY * mSpeedY);
+    double limited = std::fmin(std::fmax(speed, schooling.mMinSpeed), schooling.mMaxSpeed);
+    if (speed > 0 && limited != speed)
+    {
+        mSpeedX *= limited / speed;
+        mSpeedY *= limited / speed;
+    }
+
+    SetMirror(mSpeedX < 0);
+}
+
+/**
+ * Add this fish to the school, if its species schools
+ * @param school The school being built for this step
+ */
+void Fish::JoinSchool(School *school)
+{
+    auto schooling = GetSpecies()->GetSchooling();
+    if (schooling != nullptr)
+    {
+        mSchoolIndex = uint32_t(school->Add({GetX(), GetY(), mSpeedX, mSpeedY, schooling}));
+    }
+}
+
+/**
+ * Get the speed this fish swims at
+ * @param x Receives the X speed in pixels per second
+ * @param y Receives the Y speed in pixels per second
+ * @return true, since fish move by themselves
+ */
+bool Fish::GetSpeed(double *x, double *y) const
+{
+    *x = mSpeedX;
+    *y = mSpeedY;
+    return true;
+}
+
+/**
+ * Bounce off another solid item.
+ *
+ * Two fish swap the parts of their speeds toward each other,
+ * like equal balls colliding. A fish that hits something
+ * that stays put bounces straight back off it.
+ *
+ * @param normalX X of the direction away from the other item
+ * @param normalY Y of the direction away from the other item
+ * @param otherX X speed of the other item before the bump
+ * @param otherY Y speed of the other item before the bump
+ * @param otherMoves true if the other item moves by itself
+ */
+void Fish::Bounce(double normalX, double normalY, double otherX, double otherY, bool otherMoves)
+{
+    double length = std::sqrt(normalX * normalX + normalY * normalY);
+    if (length == 0)
+    {
+        return;
+    }
+
+    normalX /= length;
+    normalY /= length;
+
+    // Only bounce if moving toward the other item, so items
+    // that still overlap after a bounce are not turned back
+    double approach = (mSpeedX - otherX) * normalX + (mSpeedY - otherY) * normalY;
+    if (approach >= 0)
+    {
+        return;
+    }
+
+    double push = otherMoves ? 1 : 2;
+    mSpeedX -= push * approach * normalX;
+    mSpeedY -= push * approach * normalY;
+    SetMirror(mSpeedX < 0);
+}
+
+/**
+ * Get where this fish turns around, the same places Update does
+ * @param size Size of the aquarium in pixels
+ * @param left Receives the smallest X the fish swims to
+ * @param top Receives the smallest Y the fish swims to
+ * @param right Receives the largest X the fish swims to
+ * @param bottom Receives the largest Y the fish swims to
+ */
+void Fish::GetWalls(const wxSize &size, double *left, double *top, double *right, double *bottom) const
+{
+    double fishWidth = GetItemSize().GetWidth();
+    double fishHeight = GetItemSize().GetHeight();
+
+    *left = 10 + fishWidth / 2;
+    *right = size.GetWidth() - 10 - fishWidth / 2;
+    *top = 10 + fishHeight;
+    *bottom = size.GetHeight() - 10 - fishHeight;
+}
+
+/**
+ * Get the time until this fish next reaches a wall
+ * @param size Size of the aquarium in pixels
+ * @return Time in seconds, or infinity if it never does
+ */
+double Fish::TimeToWall(const wxSize &size) const
+{
+    double left, top, right, bottom;
+    GetWalls(size, &left, &top, &right, &bottom);
+    return std::fmin(TimeToLimit(GetX(), mSpeedX, left, right),
+            TimeToLimit(GetY(), mSpeedY, top, bottom));
+}
+
+/**
+ * Turn around at any wall this fish has reached
+ * @param size Size of the aquarium in pixels
+ */
+void Fish::TurnAtWalls(const wxSize &size)
+{
+    double left, top, right, bottom;
+    GetWalls(size, &left, &top, &right, &bottom);
+    if (TimeToLimit(GetX(), mSpeedX, left, right) <= WallTolerance)
+    {
+        mSpeedX = -mSpeedX;
+        SetMirror(mSpeedX < 0);
+    }
+
+    if (TimeToLimit(GetY(), mSpeedY, top, bottom) <= WallTolerance)
+    {
+        mSpeedY = -mSpeedY;
+    }
+}
+
+/**
+ * Turn around to swim back the way this fish came
+ */
+void Fish::Mirror()
+{
+    mSpeedX = -mSpeedX;
+    SetMirror(mSpeedX < 0);
+}
+
+/**
+ * Copying the state pertaining to fish
+ * @param state The state to fill in
+ */
+void Fish::GetState(ItemState &state) const
+{
+    Item::GetState(state);
+
+    state.mHasSpeed = true;
+    state.mSpeedX = mSpeedX;
+    state.mSpeedY = mSpeedY;
+}
+
+/**
+ * Loading specific values pertaining to fish
+ * @param node the base XmlNode that will be loaded
+ *
+ */
+void Fish::XmlLoad(wxXmlNode* node)
+{
+
+    Item::XmlLoad(node);
+
+    // Load speed from xml tag
+    mSpeedX = AttributeCodec::Load(node, L"speedx");
+    mSpeedY = AttributeCodec::Load(node, L"speedy");
+
+    if (mSpeedX < 0) {
+        SetMirror(true);  // Mirror if speedX is negative
+    } else {
+        SetMirror(false); // No mirror if speedX is positive
+    }
+
+}
@@ -1,73 +1,105 @@
-/**
- * @file Fish.h
- * @author Evan Gasper
- *
- * Base class for all FISH (not decor)
- */
- 
-#ifndef FISH_H
-#define FISH_H
-
-#include "Item.h"
-
-/// Maximum speed in the X direction in
-/// in pixels per second
-const double MaxSpeedX = 50;
-/// Minimum speed in the X direction in
-/// pixels per second
-const double MinSpeedX = 20;
-/// Maximum speed in the Y direction in
-/// in pixels per second
-const double MaxSpeedY = 15;
-/// Minimum speed in the Y direction in
-/// in pixels per second
-const double MinSpeedY = -15;
-
-/**
- * Base class for a fish
- * This applies to all of the fish, but not the decor
- * items in the aquarium.
- */
-class Fish : public Item {
-private:
- /// Fish speed in the X direction
- /// in pixels per second
- double mSpeedX;
-
- /// Fish speed in the Y direction
- /// in pixels per second
- double mSpeedY;
-
-protected:
- Fish(Aquarium* aquarium, const std::wstring& filename);
-
- /// Allow derived classes to set speed of X
- /// @param speedX the speed to set X to
- void SetSpeedX(double speedX) { mSpeedX = speedX; }
- /// Allow derived classes to set speed of Y
- /// @param speedY the speed to set Y to
- void SetSpeedY(double speedY) { mSpeedY = speedY; }
- /// Call refresh on the fish
- void Update(double elapsed);
-
-public:
- /// Default constructor (disabled)
- Fish() = delete;
-
- /// Copy constructor (disabled)
- Fish(const Fish &) = delete;
-
- /// Assignment operator
- void operator=(const Fish &) = delete;
-
- /// Upcall original save but also save fish specific info
- wxXmlNode* XmlSave(wxXmlNode* node) override;
-
- /// Call specific load for fish type to set speed
- void XmlLoad(wxXmlNode* node) override;
-
-};
-
-
-
-#endif //FISH_H
+/**
+ * @file Fish.h
+ * @author Evan Gasper
+ *
+ * Base class for all FISH (not decor)
+ */
+ 
+#ifndef FISH_H
+#define FISH_H
+
+#include "Item.h"
+
+/// Maximum speed in the X direction in
+/// in pixels per second
+const double MaxSpeedX = 50;
+/// Minimum speed in the X direction in
+/// pixels per second
+const double MinSpeedX = 20;
+/// Maximum speed in the Y direction in
+/// in pixels per second
+const double MaxSpeedY = 15;
+/// Minimum speed in the Y direction in
+/// in pixels per second
+const double MinSpeedY = -15;
+/// Distance in pixels fish look
+/// for neighbours to school with
+const double SchoolingRadius = 100;
+
+/**
+ * Base class for a fish
+ * This applies to all of the fish, but not the decor
+ * items in the aquarium. What fish do is final here, and
+ * species only add constants, see SpeciesFish.
+ */
+class Fish : public Item {
+private:
+ /// Number of this fish in the school for this step. Declared
+ /// first so it fits in the space left at the end of Item.
+ uint32_t mSchoolIndex = 0;
+
+ /// Fish speed in the X direction
+ /// in pixels per second
+ double mSpeedX;
+
+ /// Fish speed in the Y direction
+ /// in pixels per second
+ double mSpeedY;
+
+ void Steer(const School& school, const Species::Schooling& schooling, double elapsed);
+ void GetWalls(const wxSize& size, double* left, double* top, double* right, double* bottom) const;
+
+protected:
+ Fish(Aquarium* aquarium, const Species* species);
+
+ /// Allow derived classes to set speed of X
+ /// @param speedX the speed to set X to
+ void SetSpeedX(double speedX) { mSpeedX = speedX; }
+ /// Allow derived classes to set speed of Y
+ /// @param speedY the speed to set Y to
+ void SetSpeedY(double speedY) { mSpeedY = speedY; }
+
+public:
+ /// Default constructor (disabled)
+ Fish() = delete;
+
+ /// Copy constructor (disabled)
+ Fish(const Fish &) = delete;
+
+ /// Assignment operator
+ void operator=(const Fish &) = delete;
+
+ /// Call specific load for fish type to set speed
+ void XmlLoad(wxXmlNode* node) override;
+
+ /// Upcall original state but also copy fish speed
+ void GetState(ItemState &state) const override;
+
+ /// Call refresh on the fish
+ void Update(const Aquarium& aquarium, double elapsed) final;
+
+ void JoinSchool(School* school) final;
+
+ /**
+  * Fish bump into each other
+  * @return true
+  */
+ bool IsSolid() const final { return true; }
+
+ /**
+  * Get the memory this fish object takes up
+  * @return Size in bytes
+  */
+ size_t GetFootprint() const final { return sizeof(Fish); }
+
+ bool GetSpeed(double* x, double* y) const final;
+ void Bounce(double normalX, double normalY, double otherX, double otherY, bool otherMoves) final;
+ double TimeToWall(const wxSize& size) const final;
+ void TurnAtWalls(const wxSize& size) final;
+ void Mirror() final;
+
+};
+
+
+
+#endif //FISH_H
@@ -1,37 +1,39 @@
-/**
- * @file FishBeta.h
- * @author Evan Gasper
- *
- * A class representing Beta Fish
- */
- 
-#ifndef FISHBETA_H
-#define FISHBETA_H
-
-#include "Item.h"
-#include "Fish.h"
-
-/**
- * Class representing the Beta Fish
- */
-class FishBeta : public Fish {
-private:
-
-public:
-/// Disable Default constructor
-FishBeta() = delete;
-
-/// Disable Copy constructor
-FishBeta(const FishBeta &) = delete;
-
- /// Disable Assignment operator
- void operator=(const FishBeta &) = delete;
-
- /// Constructor
-FishBeta(Aquarium* aquarium);
-
- /// Used to determine type of fish when saving
- wxXmlNode* XmlSave(wxXmlNode* node) override;
-};
-
-#endif //FISHBETA_H
\ No newline at end of file
+/**
+ * @file FishBeta.h
+ * @author Evan Gasper
+ *
+ * A class representing Beta Fish
+ */
+ 
+#ifndef FISHBETA_H
+#define FISHBETA_H
+
+#include "SpeciesFish.h"
+
+/**
+ * What makes a Beta Fish. Beta fish swim slowly,
+ * keep their distance and only loosely follow each other.
+ */
+struct FishBetaTraits {
+ /// Type name the fish is saved with
+ static constexpr const wchar_t* Type = L"beta";
+ /// Fish filename
+ static constexpr const wchar_t* ImageName = L"images/beta.png";
+ /// X min speed
+ static constexpr double SpeedXMin = 1;
+ /// X max speed
+ static constexpr double SpeedXMax = 10;
+ /// Y min speed
+ static constexpr double SpeedYMin = -10;
+ /// Y max speed
+ static constexpr double SpeedYMax = 10;
+ /// How beta fish school
+ static constexpr Species::Schooling Schools = {2, 0.5, 0.05, 2, 12};
+ /// Beta fish school
+ static constexpr const Species::Schooling* Schooling = &Schools;
+};
+
+/// Class representing the Beta Fish
+using FishBeta = SpeciesFish<FishBetaTraits>;
+
+#endif //FISHBETA_H
@@ -0,0 +1,177 @@
+/**
+ * @file GraphicsRenderer.cpp
+ * @author Evan Gasper
+ */
+
+#include "pch.h"
+#include "GraphicsRenderer.h"
+#include "Sprite.h"
+
+using namespace std;
+
+/// Name this renderer is chosen by
+const wxString GraphicsRenderer::Name = L"graphics";
+
+/**
+ * Start drawing a frame
+ * @param dc Device context to draw on
+ * @param scale How many screen pixels there are to each aquarium pixel
+ * @param origin The aquarium point at the top left of the screen
+ */
+void GraphicsRenderer::Begin(wxDC *dc, double scale, const wxPoint &origin)
+{
+ // The context does its own scaling, so the device
+ // context is left drawing in screen pixels
+ dc->SetUserScale(1, 1);
+ dc->SetLogicalOrigin(0, 0);
+
+ mContext.reset(wxGraphicsContext::CreateFromUnknownDC(*dc));
+ mFallingBack = mContext == nullptr;
+ if (mFallingBack)
+ {
+  mFallback.Begin(dc, scale, origin);
+  return;
+ }
+
+ mScale = scale;
+ mContext->Scale(scale, scale);
+ mContext->Translate(-origin.x, -origin.y);
+ mContext->SetAntialiasMode(wxANTIALIAS_NONE);
+ mContext->SetPen(*wxTRANSPARENT_PEN);
+ mCommands.clear();
+}
+
+/**
+ * Finish drawing a frame
+ */
+void GraphicsRenderer::End()
+{
+ if (mFallingBack)
+ {
+  mFallback.End();
+  return;
+ }
+
+ Flush();
+
+ // Deleting the context puts what it drew on the device context
+ mContext.reset();
+}
+
+/**
+ * Queue drawing a sprite.
+ *
+ * The level of detail is lowered by as much as the camera is
+ * zoomed out, and the smaller bitmap is stretched back to the
+ * size the sprite takes up in the aquarium.
+ *
+ * @param sprite The sprite to draw
+ * @param x Left edge in aquarium pixels
+ * @param y Top edge in aquarium pixels
+ * @param mirror True to draw the sprite mirrored left to right
+ * @param level Level of detail, 0 for full size
+ */
+void GraphicsRenderer::DrawSprite(Sprite *sprite, int x, int y, bool mirror, int level)
+{
+ if (mFallingBack)
+ {
+  mFallback.DrawSprite(sprite, x, y, mirror, level);
+  return;
+ }
+
+ auto bitmap = sprite->GetBitmap(mirror, level + Sprite::LevelForScale(mScale));
+ if (bitmap == nullptr)
+ {
+  // Still being decoded
+  return;
+ }
+
+ auto size = sprite->GetSize(level);
+ mCommands.push_back({bitmap, wxNullBrush, x, y, size.GetWidth(), size.GetHeight()});
+}
+
+/**
+ * Queue filling a rectangle with no outline
+ * @param brush The brush to fill with
+ * @param x Left edge in aquarium pixels
+ * @param y Top edge in aquarium pixels
+ * @param width Width in aquarium pixels
+ * @param height Height in aquarium pixels
+ */
+void GraphicsRenderer::FillRectangle(const wxBrush &brush, int x, int y, int width, int height)
+{
+ if (mFallingBack)
+ {
+  mFallback.FillRectangle(brush, x, y, width, height);
+  return;
+ }
+
+ mCommands.push_back({nullptr, brush, x, y, width, height});
+}
+
+/**
+ * Draw some text on top of everything queued so far
+ * @param text The text to draw
+ * @param x Left edge in aquarium pixels
+ * @param y Top edge in aquarium pixels
+ * @param font The font to draw with
+ * @param colour The colour of the text
+ */
+void GraphicsRenderer::DrawText(const wxString &text, int x, int y, const wxFont &font, const wxColour &colour)
+{
+ if (mFallingBack)
+ {
+  mFallback.DrawText(text, x, y, font, colour);
+  return;
+ }
+
+ Flush();
+ mContext->SetFont(font, colour);
+ mContext->DrawText(text, x, y);
+}
+
+/**
+ * Send the queued draws to the context, in order
+ */
+void GraphicsRenderer::Flush()
+{
+ wxColour brushColour;
+ size_t i = 0;
+ while (i < mCommands.size())
+ {
+  auto &command = mCommands[i];
+  if (command.mBitmap != nullptr)
+  {
+   auto &converted = mBitmaps[command.mBitmap];
+   if (converted.IsNull())
+   {
+    converted = mContext->CreateBitmap(*command.mBitmap);
+   }
+
+   mContext->DrawBitmap(converted, command.mX, command.mY, command.mWidth, command.mHeight);
+   i++;
+   continue;
+  }
+
+  // Every rectangle up to the next bitmap or brush
+  // change is filled as one path
+  auto colour = command.mBrush.GetColour();
+  if (!brushColour.IsOk() || colour != brushColour)
+  {
+   mContext->SetBrush(command.mBrush);
+   brushColour = colour;
+  }
+
+  auto path = mContext->CreatePath();
+  for (; i < mCommands.size() && mCommands[i].mBitmap == nullptr &&
+         mCommands[i].mBrush.GetColour() == colour; i++)
+  {
+   path.AddRectangle(mCommands[i].mX, mCommands[i].mY, mCommands[i].mWidth, mCommands[i].mHeight);
+  }
+
+  // Impostors can overlap, so the overlaps are filled too
+  mContext->FillPath(path, wxWINDING_RULE);
+ }
+
+ mCommands.clear();
+}
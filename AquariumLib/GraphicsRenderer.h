@@ -0,0 +1,80 @@
+/**
+ * @file GraphicsRenderer.h
+ * @author Evan Gasper
+ *
+ * Draws the aquarium through a wxGraphicsContext
+ */
+
+#ifndef GRAPHICSRENDERER_H
+#define GRAPHICSRENDERER_H
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include <wx/graphics.h>
+#include "Renderer.h"
+#include "DcRenderer.h"
+
+/**
+ * Draws the aquarium through a wxGraphicsContext.
+ *
+ * The camera is set on the context once per frame. Draws are
+ * queued and sent to the context in one pass when the frame ends,
+ * or when text has to go on top of them. Runs of rectangles with
+ * the same brush are filled as a single path, and the brush is
+ * only set when it changes.
+ *
+ * Sprite bitmaps are converted for the context the first time they
+ * are drawn and kept, so later frames only draw them.
+ */
+class GraphicsRenderer : public Renderer {
+private:
+ /// A queued draw, of a bitmap if mBitmap is set or else a rectangle
+ struct Command {
+  const wxBitmap* mBitmap; ///< Bitmap to draw, or null for a rectangle
+  wxBrush mBrush;          ///< Brush to fill a rectangle with
+  int mX;                  ///< Left edge in aquarium pixels
+  int mY;                  ///< Top edge in aquarium pixels
+  int mWidth;              ///< Width in aquarium pixels
+  int mHeight;             ///< Height in aquarium pixels
+ };
+
+ /// The context being drawn on, between Begin and End
+ std::unique_ptr<wxGraphicsContext> mContext;
+
+ /// Draws straight onto the device context if a
+ /// graphics context could not be created for it
+ DcRenderer mFallback;
+
+ /// True if this frame is being drawn by mFallback
+ bool mFallingBack = false;
+
+ /// Screen pixels to each aquarium pixel this frame
+ double mScale = 1;
+
+ /// Draws waiting to be sent to mContext
+ std::vector<Command> mCommands;
+
+ /// Bitmaps converted for the context, by the sprite bitmap they came from
+ std::unordered_map<const wxBitmap*, wxGraphicsBitmap> mBitmaps;
+
+ void Flush();
+
+public:
+ /// Name this renderer is chosen by
+ static const wxString Name;
+
+ void Begin(wxDC* dc, double scale, const wxPoint& origin) override;
+ void End() override;
+ void DrawSprite(Sprite* sprite, int x, int y, bool mirror = false, int level = 0) override;
+ void FillRectangle(const wxBrush& brush, int x, int y, int width, int height) override;
+ void DrawText(const wxString& text, int x, int y, const wxFont& font, const wxColour& colour) override;
+
+ /**
+  * The name the renderer is chosen by
+  * @return Name
+  */
+ wxString GetName() const override { return Name; }
+};
+
+#endif //GRAPHICSRENDERER_H
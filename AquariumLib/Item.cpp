@@ -1,125 +1,217 @@
-/**
- * @file Item.cpp
- * @author Evan Gasper
- *
- */
-
-#include "pch.h"
-#include "Item.h"
-#include "Aquarium.h"
-
-using std::make_unique;
-
-/**
- * Constructor
- * @param aquarium The aquarium this item is a member of
- * @param filename The name of the file to display for this item
- */
-Item::Item(Aquarium *aquarium, const std::wstring &filename) : mAquarium(aquarium)
-{
- mItemImage = make_unique<wxImage>(filename, wxBITMAP_TYPE_ANY);
- mItemBitmap = make_unique<wxBitmap>(*mItemImage);
-}
-
-/**
- * Destructor
- */
-Item::~Item()
-{
-
-}
-
-/**
- * Test to see if we hit this object with a mouse.
- * @param x X position to test
- * @param y Y position to test
- * @return true if hit.
- */
-bool Item::HitTest(int x, int y)
-{
- double wid = mItemImage->GetWidth();
- double hit = mItemImage->GetHeight();
-
- // Make x and y relative to the top-left corner of the bitmap image
- // Subtracting the center makes x, y relative to the image center
- // Adding half the size makes x, y relative to theimage top corner
- double testX = x - GetX() + wid / 2;
- double testY = y - GetY() + hit / 2;
-
- // Test to see if x, y are in the image
- if (testX < 0 || testY < 0 || testX >= wid || testY >= hit)
- {
-  // We are outside the image
-  return false;
- }
-
- // Test to see if x, y are in the drawn part of the image
- // If the location is transparent, we are not in the drawn
- // part of the image
- return !mItemImage->IsTransparent((int)testX, (int)testY);
-}
-
-/**
- * Draw this fish
- * @param dc Device context to draw on
- */
-void Item::Draw(wxDC *dc)
-{
- double wid = mItemImage->GetWidth();
- double hit = mItemImage->GetHeight();
- dc->DrawBitmap(*mItemImage,
-         int(GetX() - wid / 2),
-         int(GetY() - hit / 2));
-}
-
-/**
- * Save this item to an XML node
- * @param node The parent node we are going to be a child of
- * @return wxXmlNode that we saved the item into
- */
-wxXmlNode *Item::XmlSave(wxXmlNode *node)
-{
- auto itemNode = new wxXmlNode(wxXML_ELEMENT_NODE, L"item");
- node->AddChild(itemNode);
-
- itemNode->AddAttribute(L"x", wxString::FromDouble(mX));
- itemNode->AddAttribute(L"y", wxString::FromDouble(mY));
-
- return itemNode;
-}
-
-/**
- * Load the attributes for an item node.
- *
- * This is the  base class version that loads the attributes
- * common to all items. Override this to load custom attributes
- * for specific items.
- *
- * @param node The Xml node we are loading the item from
- */
-void Item::XmlLoad(wxXmlNode *node)
-{
- node->GetAttribute(L"x", L"0").ToDouble(&mX);
- node->GetAttribute(L"y", L"0").ToDouble(&mY);
-}
-
-/**
- * Set the mirror status
- * @param m New mirror flag
- */
-void Item::SetMirror(bool m) {
- if(m != mMirror)
- {
-  // This code only executes if the mirror state changes
-  mMirror = m;
-
-  // If mMirror is true, create a mirrored bitmap
-  if (mMirror) {
-   mItemImage = make_unique<wxImage>(mItemImage->Mirror());
-   mItemBitmap = make_unique<wxBitmap>(mItemImage->Mirror());
-  } else {
-   mItemImage = make_unique<wxImage>(mItemImage->Mirror());
-   mItemBitmap = make_unique<wxBitmap>(mItemImage->Mirror());
-  }
- }
+/**
+ * @file Item.cpp
+ * @author Evan Gasper
+ *
+ */
+
+#include "pch.h"
+#include "Item.h"
+#include "Aquarium.h"
+#include "AttributeCodec.h"
+
+/// Moves made with SetLocation to any item
+std::atomic<unsigned long long> Item::sMoves{0};
+
+/**
+ * Constructor
+ *
+ * The species image is decoded in the background.
+ * The item is not drawn until it is ready.
+ *
+ * @param species What this item has in common with others of its kind
+ */
+Item::Item(const Species *species) : mSpecies(species)
+{
+}
+
+/**
+ * Destructor
+ */
+Item::~Item()
+{
+
+}
+
+/**
+ * Test to see if we hit this object with a mouse.
+ * @param x X position to test
+ * @param y Y position to test
+ * @return true if hit.
+ */
+bool Item::HitTest(int x, int y)
+{
+ double wid = GetItemSize().GetWidth();
+ double hit = GetItemSize().GetHeight();
+
+ // Make x and y relative to the top-left corner of the bitmap image
+ // Subtracting the center makes x, y relative to the image center
+ // Adding half the size makes x, y relative to theimage top corner
+ double testX = x - GetX() + wid / 2;
+ double testY = y - GetY() + hit / 2;
+
+ // Test to see if x, y are in the image
+ if (testX < 0 || testY < 0 || testX >= wid || testY >= hit)
+ {
+  // We are outside the image
+  return false;
+ }
+
+ // Test to see if x, y are in the drawn part of the image
+ // If the location is transparent, we are not in the drawn
+ // part of the image. This waits for the image if it is
+ // still being decoded.
+ return !mSpecies->GetSprite()->GetImage(mMirror).IsTransparent((int)testX, (int)testY);
+}
+
+/**
+ * Get the rectangle the item is drawn in at full detail
+ * @return Bounding rectangle in pixels
+ */
+wxRect Item::GetBounds() const
+{
+ double wid = GetItemSize().GetWidth();
+ double hit = GetItemSize().GetHeight();
+ return wxRect(int(GetX() - wid / 2), int(GetY() - hit / 2),
+         GetItemSize().GetWidth(), GetItemSize().GetHeight());
+}
+
+/**
+ * Is a rectangle entirely covered by the opaque part of this item?
+ * @param rect Rectangle in pixels
+ * @return true if nothing in rect shows through this item
+ */
+bool Item::Covers(const wxRect &rect)
+{
+ auto bounds = GetBounds();
+ wxRect relative(rect);
+ relative.Offset(-bounds.GetX(), -bounds.GetY());
+ return mSpecies->GetSprite()->IsOpaque(relative, mMirror);
+}
+
+/**
+ * Do the solid parts of this item and another overlap?
+ *
+ * This waits for either image if it is still being decoded, so
+ * items collide the same however quickly their images decode.
+ *
+ * @param other The other item
+ * @param contact Receives the centre of the overlap
+ * @return true if they overlap
+ */
+bool Item::Touches(const Item &other, wxRealPoint *contact) const
+{
+ mSpecies->GetSprite()->Decode();
+ other.mSpecies->GetSprite()->Decode();
+ return mSpecies->GetSprite()->Overlaps(GetBounds().GetTopLeft(), mMirror,
+         *other.mSpecies->GetSprite(), other.GetBounds().GetTopLeft(), other.mMirror, contact);
+}
+
+/**
+ * Draw this fish
+ *
+ * How much detail is drawn depends on how crowded the
+ * aquarium is. Items that hide others are always drawn
+ * in full detail.
+ *
+ * @param renderer Renderer to draw with
+ * @param aquarium The aquarium being drawn
+ */
+void Item::Draw(Renderer *renderer, const Aquarium &aquarium)
+{
+ auto sprite = mSpecies->GetSprite();
+ auto detail = IsOccluder() ? Aquarium::Detail::Full : aquarium.GetDetail();
+ if (detail == Aquarium::Detail::Impostor)
+ {
+  // A rectangle of the image's colour at the reduced size
+  auto brush = sprite->GetBrush();
+  if (brush != nullptr)
+  {
+   auto size = sprite->GetSize(1);
+   renderer->FillRectangle(*brush, int(GetX()) - size.GetWidth() / 2, int(GetY()) - size.GetHeight() / 2,
+           size.GetWidth(), size.GetHeight());
+  }
+
+  return;
+ }
+
+ int level = detail == Aquarium::Detail::Reduced ? 1 : 0;
+ double wid = sprite->GetSize(level).GetWidth();
+ double hit = sprite->GetSize(level).GetHeight();
+ renderer->DrawSprite(sprite,
+         int(GetX() - wid / 2),
+         int(GetY() - hit / 2),
+         mMirror, level);
+}
+
+/**
+ * Save this item to an XML node.
+ *
+ * Items are saved from the state they copy out, so saving an item
+ * and saving a snapshot of it go through the same ItemState::XmlSave.
+ * Items add what they save by overriding GetState.
+ *
+ * @param node The parent node we are going to be a child of
+ * @return wxXmlNode that we saved the item into
+ */
+wxXmlNode *Item::XmlSave(wxXmlNode *node)
+{
+ ItemState state;
+ GetState(state);
+ return state.XmlSave(node);
+}
+
+/**
+ * Copy the state of this item that gets saved.
+ *
+ * This is the base class version that copies the state
+ * common to all items. Override this to add the state of
+ * specific items, which XmlSave then saves too.
+ *
+ * @param state The state to fill in
+ */
+void Item::GetState(ItemState &state) const
+{
+ state.mX = mX;
+ state.mY = mY;
+ state.mMirror = mMirror;
+}
+
+/**
+ * Load the attributes for an item node.
+ *
+ * This is the  base class version that loads the attributes
+ * common to all items. Override this to load custom attributes
+ * for specific items.
+ *
+ * @param node The Xml node we are loading the item from
+ */
+void Item::XmlLoad(wxXmlNode *node)
+{
+ mX = AttributeCodec::Load(node, L"x");
+ mY = AttributeCodec::Load(node, L"y");
+ mMirror = node->GetAttribute(L"mirror", L"0") == L"1";
+}
+
+/**
+ * Turn the item to face the other way.
+ *
+ * This is the base class version, which just mirrors the
+ * image. Items that move override this to turn around.
+ */
+void Item::Mirror()
+{
+ SetMirror(!mMirror);
+}
+
+/**
+ * Set the mirror status
+ * @param m New mirror flag
+ */
+void Item::SetMirror(bool m) {
+ if(m != mMirror)
+ {
+  // This code only executes if the mirror state changes.
+  // The sprite holds both orientations of the image.
+  mMirror = m;
+ }
 }
\ No newline at end of file
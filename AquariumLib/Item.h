@@ -1,94 +1,193 @@
-/**
- * @file Item.h
- * @author Evan Gasper
- *
- * Base class for any item in the Aquarium
- */
-
-#ifndef ITEM_H
-#define ITEM_H
-
-class Aquarium;
-
-/**
- * Base Class representing any item in the Aquarium
- */
-class Item {
-private:
- /// The aquarium this item is contained in
- Aquarium   *mAquarium;
-
- // Item location in the aquarium
- double  mX = 0;     ///< X location for the center of the item
- double  mY = 0;     ///< Y location for the center of the item
-
- /// The underlying fish image
- std::unique_ptr<wxImage> mItemImage;
-
- /// The bitmap we can display for this fish
- std::unique_ptr<wxBitmap> mItemBitmap;
-
- bool mMirror = false;   ///< True mirrors the item image
-
-protected:
- Item(Aquarium* aquarium, const std::wstring& filename);
- /**
-  * Get the underlying wxImage for this item.
-  * @return Pointer to the wxImage object.
-  */
- wxImage* GetItemImage() const { return mItemImage.get(); }
-
-public:
- ~Item();
-
- /// Default constructor (disabled)
- Item() = delete;
-
- /// Copy constructor (disabled)
- Item(const Item &) = delete;
-
- /// Assignment operator
- void operator=(const Item &) = delete;
-
- /**
- * The X location of the item
- * @return X location in pixels
- */
- double GetX() const { return mX; }
-
- /**
-  * The Y location of the item
-  * @return Y location in pixels
-  */
- double GetY() const { return mY; }
-
- /**
-  * Set the item location
-  * @param x X location in pixels
-  * @param y Y location in pixels
-  */
- virtual void SetLocation(double x, double y) { mX = x; mY = y; }
-
- virtual void Draw(wxDC *dc);
-
- virtual wxXmlNode* XmlSave(wxXmlNode* node);
-
- virtual void XmlLoad(wxXmlNode* node);
- void SetMirror(bool m);
-
- virtual bool HitTest(int x, int y);
-
- /**
-  * Get the pointer to the Aquarium object
-  * @return Pointer to Aquarium object
-  */
- Aquarium *GetAquarium() { return mAquarium;  }
-
- /**
- * Handle updates for animation
- * @param elapsed The time since the last update
- */
- virtual void Update(double elapsed) {}
-};
-
+/**
+ * @file Item.h
+ * @author Evan Gasper
+ *
+ * Base class for any item in the Aquarium
+ */
+
+#ifndef ITEM_H
+#define ITEM_H
+
+#include "ItemState.h"
+#include "Species.h"
+#include "Renderer.h"
+
+#include <atomic>
+#include <limits>
+
+class School;
+
+class Aquarium;
+
+/**
+ * Base Class representing any item in the Aquarium.
+ *
+ * There can be a great many items, so each only holds what
+ * differs from item to item. What items of a kind share,
+ * like their image, is in their species. Items do not point
+ * back to their aquarium; it is passed to the calls that need it.
+ */
+class Item {
+private:
+ /// What this item has in common with others of its kind
+ const Species* mSpecies;
+
+ // Item location in the aquarium
+ double  mX = 0;     ///< X location for the center of the item
+ double  mY = 0;     ///< Y location for the center of the item
+
+ bool mMirror = false;   ///< True mirrors the item image
+
+ /// Counts moves made with SetLocation to any item
+ static std::atomic<unsigned long long> sMoves;
+
+protected:
+ explicit Item(const Species* species);
+ /**
+  * Get the size of the item image.
+  * @return Size in pixels
+  */
+ const wxSize& GetItemSize() const { return mSpecies->GetSprite()->GetSize(); }
+
+ /**
+  * Set the item location without counting it as a move, for
+  * moves the aquarium already knows about, like those in Update
+  * @param x X location in pixels
+  * @param y Y location in pixels
+  */
+ void Place(double x, double y) { mX = x; mY = y; }
+
+public:
+ ~Item();
+
+ /// Default constructor (disabled)
+ Item() = delete;
+
+ /// Copy constructor (disabled)
+ Item(const Item &) = delete;
+
+ /// Assignment operator
+ void operator=(const Item &) = delete;
+
+ /**
+ * The X location of the item
+ * @return X location in pixels
+ */
+ double GetX() const { return mX; }
+
+ /**
+  * The Y location of the item
+  * @return Y location in pixels
+  */
+ double GetY() const { return mY; }
+
+ /**
+  * Set the item location. The move is counted, so an
+  * aquarium holding the item sees it the next time it
+  * finds or hit tests items.
+  * @param x X location in pixels
+  * @param y Y location in pixels
+  */
+ virtual void SetLocation(double x, double y)
+ {
+  mX = x;
+  mY = y;
+  sMoves.fetch_add(1, std::memory_order_relaxed);
+ }
+
+ /**
+  * Get the number of moves made with SetLocation to any item.
+  * Caches of where items are compare this to see if they are stale.
+  * @return Number of moves so far
+  */
+ static unsigned long long GetMoves() { return sMoves.load(std::memory_order_relaxed); }
+
+ /**
+  * Get what this item has in common with others of its kind
+  * @return The species
+  */
+ const Species* GetSpecies() const { return mSpecies; }
+
+ virtual void Draw(Renderer *renderer, const Aquarium& aquarium);
+
+ wxXmlNode* XmlSave(wxXmlNode* node);
+
+ virtual void XmlLoad(wxXmlNode* node);
+
+ virtual void GetState(ItemState &state) const;
+ void SetMirror(bool m);
+ virtual void Mirror();
+
+ bool HitTest(int x, int y);
+
+ wxRect GetBounds() const;
+ bool Covers(const wxRect& rect);
+ bool Touches(const Item& other, wxRealPoint* contact) const;
+
+ /**
+  * Does this item hide what is drawn behind it? Items that do
+  * are always drawn in full detail, so what they hide is exact.
+  * @return true if the opaque parts of this item hide the items behind it
+  */
+ virtual bool IsOccluder() const { return false; }
+
+ /**
+  * Add this item to the school fish steer by, if it schools
+  * @param school The school being built for this step
+  */
+ virtual void JoinSchool(School* school) {}
+
+ /**
+  * Do fish bump into this item when collisions are on?
+  * @return true if this item is solid
+  */
+ virtual bool IsSolid() const { return false; }
+
+ /**
+  * Get the memory this item object takes up. Classes
+  * that add members to their base override this.
+  * @return Size in bytes
+  */
+ virtual size_t GetFootprint() const { return sizeof(Item); }
+
+ /**
+  * Get the speed this item moves at by itself
+  * @param x Receives the X speed in pixels per second
+  * @param y Receives the Y speed in pixels per second
+  * @return true if the item moves by itself, false if it stays put
+  */
+ virtual bool GetSpeed(double* x, double* y) const { *x = *y = 0; return false; }
+
+ /**
+  * Respond to bumping into another solid item
+  * @param normalX X of the direction away from the other item
+  * @param normalY Y of the direction away from the other item
+  * @param otherX X speed of the other item before the bump
+  * @param otherY Y speed of the other item before the bump
+  * @param otherMoves true if the other item moves by itself
+  */
+ virtual void Bounce(double normalX, double normalY, double otherX, double otherY, bool otherMoves) {}
+
+ /**
+  * Get the time until this item next reaches a wall and turns around,
+  * if it keeps moving at the speed GetSpeed returns
+  * @param size Size of the aquarium in pixels
+  * @return Time in seconds, or infinity if it never does
+  */
+ virtual double TimeToWall(const wxSize& size) const { return std::numeric_limits<double>::infinity(); }
+
+ /**
+  * Turn around at any wall this item has reached
+  * @param size Size of the aquarium in pixels
+  */
+ virtual void TurnAtWalls(const wxSize& size) {}
+
+ /**
+ * Handle updates for animation
+ * @param aquarium The aquarium this item is in
+ * @param elapsed The time since the last update
+ */
+ virtual void Update(const Aquarium& aquarium, double elapsed) {}
+};
+
 #endif //ITEM_H
\ No newline at end of file
@@ -0,0 +1,43 @@
+/**
+ * @file ItemState.cpp
+ * @author Evan Gasper
+ */
+
+#include "pch.h"
+#include "ItemState.h"
+#include "AttributeCodec.h"
+
+/**
+ * Save this state to an XML node.
+ *
+ * This is how items save themselves too, see Item::XmlSave,
+ * so a snapshot saves the same as the items it was taken from.
+ *
+ * @param node The parent node we are going to be a child of
+ * @return wxXmlNode that we saved the state into
+ */
+wxXmlNode *ItemState::XmlSave(wxXmlNode *node) const
+{
+ auto itemNode = new wxXmlNode(wxXML_ELEMENT_NODE, L"item");
+ node->AddChild(itemNode);
+
+ AttributeCodec::Save(itemNode, L"x", mX);
+ AttributeCodec::Save(itemNode, L"y", mY);
+ if (mMirror)
+ {
+  itemNode->AddAttribute(L"mirror", L"1");
+ }
+
+ if (mHasSpeed)
+ {
+  AttributeCodec::Save(itemNode, L"speedx", mSpeedX);
+  AttributeCodec::Save(itemNode, L"speedy", mSpeedY);
+ }
+
+ if (mType != nullptr)
+ {
+  itemNode->AddAttribute(L"type", mType);
+ }
+
+ return itemNode;
+}
@@ -0,0 +1,43 @@
+/**
+ * @file ItemState.h
+ * @author Evan Gasper
+ *
+ * Plain copy of the saved state of one item
+ */
+
+#ifndef ITEMSTATE_H
+#define ITEMSTATE_H
+
+/**
+ * Plain copy of the state of one item that gets saved.
+ *
+ * Copying these is cheap and they never change once taken,
+ * so a list of them can be saved on another thread while
+ * the items themselves keep moving.
+ */
+struct ItemState {
+ /// Type name saved in the file, such as beta or castle
+ const wchar_t *mType = nullptr;
+
+ /// X location for the center of the item
+ double mX = 0;
+
+ /// Y location for the center of the item
+ double mY = 0;
+
+ /// True if the item has a speed (it is a fish)
+ bool mHasSpeed = false;
+
+ /// Speed in the X direction in pixels per second
+ double mSpeedX = 0;
+
+ /// Speed in the Y direction in pixels per second
+ double mSpeedY = 0;
+
+ /// True if the image is drawn mirrored
+ bool mMirror = false;
+
+ wxXmlNode *XmlSave(wxXmlNode *node) const;
+};
+
+#endif //ITEMSTATE_H
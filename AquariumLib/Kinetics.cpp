@@ -0,0 +1,432 @@
+/**
+ * @file Kinetics.cpp
+ * @author Evan Gasper
+ */
+
+#include "pch.h"
+#include "Kinetics.h"
+#include "Item.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace std;
+
+/// How far ahead in seconds to look to see which cell an item
+/// is heading into, when it is right on the edge between two
+const double CellLookAhead = 0.001;
+
+/// Advancing the clock by more than this many seconds skips the
+/// cell events on the way, since items cross many cells by then
+const double SeekTime = 10;
+
+/**
+ * Constructor
+ * @param cellSize Width and height of each cell in pixels
+ */
+Kinetics::Kinetics(double cellSize) : mCellSize(cellSize)
+{
+}
+
+/**
+ * Start moving items from where they are now.
+ *
+ * Any items already being moved are forgotten, without
+ * working out where they are. The clock starts at zero.
+ *
+ * @param items The items
+ * @param size Size of the aquarium in pixels
+ */
+void Kinetics::Start(const std::vector<std::shared_ptr<Item>> &items, const wxSize &size)
+{
+ mSize = size;
+ mColumns = max(1, int(ceil(size.GetWidth() / mCellSize)));
+ mRows = max(1, int(ceil(size.GetHeight() / mCellSize)));
+ mCells.assign(size_t(mColumns) * mRows, {});
+ mEntries.clear();
+ mStill.clear();
+ mEvents = {};
+ mTime = 0;
+ mMargin = 0;
+
+ for (auto &item : items)
+ {
+  Add(item.get());
+ }
+}
+
+/**
+ * Stop moving items, leaving each where it is now
+ */
+void Kinetics::Stop()
+{
+ LocateAll();
+ mCells.clear();
+ mEntries.clear();
+ mStill.clear();
+ mEvents = {};
+}
+
+/**
+ * Start moving an item from where it is now
+ * @param item The item, which must stay alive until removed
+ */
+void Kinetics::Add(Item *item)
+{
+ auto bounds = item->GetBounds();
+ mMargin = max(mMargin, max(bounds.GetWidth(), bounds.GetHeight()) / 2 + 1);
+
+ double speedX, speedY;
+ if (!item->GetSpeed(&speedX, &speedY))
+ {
+  mStill.push_back(item);
+  return;
+ }
+
+ auto &entry = mEntries[item];
+ Anchor(item, entry, mTime);
+ List(item, entry, CellAt(item->GetX(), item->GetY()));
+ Schedule(item, entry);
+}
+
+/**
+ * Stop moving an item. Its location is left as it was when
+ * last worked out, so call Locate first to keep where it is now.
+ * @param item The item
+ */
+void Kinetics::Remove(Item *item)
+{
+ auto found = mEntries.find(item);
+ if (found != mEntries.end())
+ {
+  // Events already in the queue are ignored once the entry is gone
+  Unlist(found->second);
+  mEntries.erase(found);
+  return;
+ }
+
+ auto still = find(mStill.begin(), mStill.end(), item);
+ if (still != mStill.end())
+ {
+  mStill.erase(still);
+ }
+}
+
+/**
+ * Tell the kinetics an item was put somewhere else,
+ * so it moves on from its new location now
+ * @param item The item
+ */
+void Kinetics::Moved(Item *item)
+{
+ auto found = mEntries.find(item);
+ if (found != mEntries.end())
+ {
+  auto &entry = found->second;
+  Anchor(item, entry, mTime);
+  Unlist(entry);
+  List(item, entry, CellAt(item->GetX(), item->GetY()));
+  Schedule(item, entry);
+ }
+}
+
+/**
+ * Advance the clock, handling the events due by then.
+ *
+ * This is also how to seek to any later time: the cost depends on
+ * the number of times items reach walls on the way rather than the
+ * time passed.
+ *
+ * @param time New time in seconds
+ */
+void Kinetics::AdvanceTo(double time)
+{
+ if (time - mTime > SeekTime)
+ {
+  Seek(time);
+  return;
+ }
+
+ while (!mEvents.empty() && mEvents.top().mTime <= time)
+ {
+  auto event = mEvents.top();
+  mEvents.pop();
+
+  auto found = mEntries.find(event.mItem);
+  if (found != mEntries.end() && found->second.mGeneration == event.mGeneration)
+  {
+   Happen(event.mItem, found->second, event.mTime);
+  }
+ }
+
+ mTime = max(mTime, time);
+}
+
+/**
+ * Jump ahead to a time.
+ *
+ * Each item only needs to turn at the walls it reaches on the way,
+ * so those are followed one item at a time, then the cells and the
+ * queue are made over.
+ *
+ * @param time New time in seconds
+ */
+void Kinetics::Seek(double time)
+{
+ mEvents = {};
+ for (auto &cell : mCells)
+ {
+  cell.clear();
+ }
+
+ for (auto &[item, entry] : mEntries)
+ {
+  for (double wall = entry.mTime + item->TimeToWall(mSize); wall <= time; wall = entry.mTime + item->TimeToWall(mSize))
+  {
+   Locate(item, entry, wall);
+   item->TurnAtWalls(mSize);
+   Anchor(item, entry, wall);
+  }
+
+  Locate(item, entry, time);
+  Anchor(item, entry, time);
+ }
+
+ mTime = time;
+ for (auto &[item, entry] : mEntries)
+ {
+  List(item, entry, CellAt(item->GetX(), item->GetY()));
+  Schedule(item, entry);
+ }
+}
+
+/**
+ * Move an item to where it is now
+ * @param item The item
+ */
+void Kinetics::Locate(Item *item)
+{
+ auto found = mEntries.find(item);
+ if (found != mEntries.end())
+ {
+  Locate(item, found->second, mTime);
+ }
+}
+
+/**
+ * Move every item to where it is now
+ */
+void Kinetics::LocateAll()
+{
+ for (auto &[item, entry] : mEntries)
+ {
+  Locate(item, entry, mTime);
+ }
+}
+
+/**
+ * Find the items that overlap a rectangle.
+ *
+ * Only the items listed in cells near the rectangle are
+ * moved to where they are now and tested.
+ *
+ * @param rect Rectangle in pixels
+ * @param items Receives the items, in no particular order
+ */
+void Kinetics::Query(const wxRect &rect, std::vector<Item *> &items)
+{
+ items.clear();
+ if (!mCells.empty())
+ {
+  // Items are listed by their location, but their bounds
+  // reach out as far as the margin from it
+  auto first = CellAt(rect.GetLeft() - mMargin, rect.GetTop() - mMargin);
+  auto last = CellAt(rect.GetRight() + mMargin, rect.GetBottom() + mMargin);
+  for (size_t row = first / mColumns; row <= last / mColumns; row++)
+  {
+   for (size_t column = first % mColumns; column <= last % mColumns; column++)
+   {
+    for (auto item : mCells[row * mColumns + column])
+    {
+     Locate(item);
+     if (item->GetBounds().Intersects(rect))
+     {
+      items.push_back(item);
+     }
+    }
+   }
+  }
+ }
+
+ for (auto item : mStill)
+ {
+  if (item->GetBounds().Intersects(rect))
+  {
+   items.push_back(item);
+  }
+ }
+}
+
+/**
+ * Move an item to where it is at a time.
+ *
+ * The location is worked out from the entry's anchor
+ * each time, so this does not change the entry.
+ *
+ * @param item The item
+ * @param entry The item's entry
+ * @param time The time
+ */
+void Kinetics::Locate(Item *item, Entry &entry, double time)
+{
+ double speedX, speedY;
+ item->GetSpeed(&speedX, &speedY);
+ double elapsed = time - entry.mTime;
+ item->SetLocation(entry.mX + speedX * elapsed, entry.mY + speedY * elapsed);
+}
+
+/**
+ * Anchor an item's entry where the item is now, at an event
+ * @param item The item, already located at time
+ * @param entry The item's entry
+ * @param time When the event happens
+ */
+void Kinetics::Anchor(Item *item, Entry &entry, double time)
+{
+ entry.mTime = time;
+ entry.mX = item->GetX();
+ entry.mY = item->GetY();
+}
+
+/**
+ * Queue the next event for an item, which is the sooner of
+ * it reaching a wall and it leaving its cell. Any event
+ * already queued for it is no longer valid.
+ * @param item The item, located at entry.mTime
+ * @param entry The item's entry
+ */
+void Kinetics::Schedule(Item *item, Entry &entry)
+{
+ entry.mGeneration = ++mCount;
+
+ double speedX, speedY;
+ item->GetSpeed(&speedX, &speedY);
+
+ // Time until a coordinate leaves a cell. The cells
+ // along the edges go on forever.
+ const double never = numeric_limits<double>::infinity();
+ auto leave = [this, never](double at, double speed, int cell, int cells) {
+  if (speed > 0 && cell < cells - 1)
+  {
+   return max(0.0, ((cell + 1) * mCellSize - at) / speed);
+  }
+
+  if (speed < 0 && cell > 0)
+  {
+   return max(0.0, (cell * mCellSize - at) / speed);
+  }
+
+  return never;
+ };
+
+ int column = int(entry.mCell % mColumns);
+ int row = int(entry.mCell / mColumns);
+ double wait = min({item->TimeToWall(mSize),
+         leave(item->GetX(), speedX, column, mColumns),
+         leave(item->GetY(), speedY, row, mRows)});
+ if (wait < never)
+ {
+  mEvents.push({entry.mTime + wait, ++mCount, item, entry.mGeneration});
+ }
+}
+
+/**
+ * Handle an event for an item
+ * @param item The item
+ * @param entry The item's entry
+ * @param time When the event happens
+ */
+void Kinetics::Happen(Item *item, Entry &entry, double time)
+{
+ Locate(item, entry, time);
+ item->TurnAtWalls(mSize);
+ Anchor(item, entry, time);
+
+ // An item on the edge between two cells goes
+ // in the one it is moving into
+ double speedX, speedY;
+ item->GetSpeed(&speedX, &speedY);
+ auto cell = CellAt(item->GetX() + speedX * CellLookAhead, item->GetY() + speedY * CellLookAhead);
+ if (cell != entry.mCell)
+ {
+  Unlist(entry);
+  List(item, entry, cell);
+ }
+
+ Schedule(item, entry);
+}
+
+/**
+ * Find the cell a location is in. Locations outside
+ * the aquarium are in the nearest cell along the edge.
+ * @param x X location in pixels
+ * @param y Y location in pixels
+ * @return Cell number
+ */
+size_t Kinetics::CellAt(double x, double y) const
+{
+ auto column = size_t(clamp(floor(x / mCellSize), 0.0, double(mColumns - 1)));
+ auto row = size_t(clamp(floor(y / mCellSize), 0.0, double(mRows - 1)));
+ return row * mColumns + column;
+}
+
+/**
+ * Take an item out of its cell's list
+ * @param entry The item's entry
+ */
+void Kinetics::Unlist(Entry &entry)
+{
+ // The last item in the list takes its place
+ auto &cell = mCells[entry.mCell];
+ auto last = cell.back();
+ cell[entry.mSlot] = last;
+ mEntries[last].mSlot = entry.mSlot;
+ cell.pop_back();
+}
+
+/**
+ * Put an item in a cell's list
+ * @param item The item
+ * @param entry The item's entry
+ * @param cell The cell
+ */
+void Kinetics::List(Item *item, Entry &entry, size_t cell)
+{
+ entry.mCell = cell;
+ entry.mSlot = mCells[cell].size();
+ mCells[cell].push_back(item);
+}
+
+/**
+ * Get the memory the events, entries and cell lists take up.
+ *
+ * The event queue and entry table do not say how much they have
+ * allocated, so they are counted by what they hold.
+ *
+ * @return Size in bytes
+ */
+size_t Kinetics::GetMemory() const
+{
+ // Each entry in the table is a node with a link to the next
+ size_t bytes = mEvents.size() * sizeof(Event) +
+         mEntries.size() * (sizeof(pair<Item* const, Entry>) + sizeof(void*)) +
+         mEntries.bucket_count() * sizeof(void*) +
+         mCells.capacity() * sizeof(mCells[0]) +
+         mStill.capacity() * sizeof(Item*);
+ for (auto &cell : mCells)
+ {
+  bytes += cell.capacity() * sizeof(Item*);
+ }
+
+ return bytes;
+}
@@ -0,0 +1,138 @@
+/**
+ * @file Kinetics.h
+ * @author Evan Gasper
+ *
+ * Moves items only when something happens to them
+ */
+
+#ifndef KINETICS_H
+#define KINETICS_H
+
+#include <memory>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+class Item;
+
+/**
+ * Moves items only when something happens to them.
+ *
+ * Items that move by themselves swim in straight lines between
+ * walls, so where an item is at any time is its location at the
+ * last event plus its speed times the time since. Only events
+ * change that anchor, so looking at an item never changes where
+ * it goes. Rather than
+ * moving every item every frame, the next time each item reaches
+ * a wall is worked out and put in a priority queue. Advancing the
+ * clock only handles the events that are due.
+ *
+ * Items are also kept in a grid of cells by where they are, with
+ * an event for the next time each item leaves its cell. Finding
+ * the items in a rectangle only looks at the cells near it, and
+ * only works out where those items are. Items nothing looks at
+ * cost nothing until their next event, which is seconds away.
+ *
+ * Items that do not move by themselves are kept in a plain list,
+ * since there are few of them.
+ */
+class Kinetics {
+private:
+ /// Something that happens to an item: it reaches a wall or leaves its cell
+ struct Event {
+  double mTime;             ///< When it happens
+  unsigned long long mOrder;///< Breaks ties, so events happen in the same order every time
+  Item* mItem;              ///< The item it happens to
+  unsigned long long mGeneration; ///< Matches the item's entry if still valid
+
+  /**
+   * Does this event happen after another?
+   * @param other The other event
+   * @return true if this one is later
+   */
+  bool operator>(const Event& other) const
+  {
+   return mTime != other.mTime ? mTime > other.mTime : mOrder > other.mOrder;
+  }
+ };
+
+ /// What is known about an item that moves
+ struct Entry {
+  double mTime;             ///< Time of the item's last event
+  double mX;                ///< X location at mTime
+  double mY;                ///< Y location at mTime
+  size_t mCell;             ///< Cell the item is listed in
+  size_t mSlot;             ///< Place in the cell's list
+  unsigned long long mGeneration; ///< Events for older generations are ignored
+ };
+
+ /// Width and height of each cell in pixels
+ double mCellSize;
+
+ /// Size of the aquarium in pixels, where the walls are
+ wxSize mSize;
+
+ /// Number of columns of cells
+ int mColumns = 1;
+
+ /// Number of rows of cells
+ int mRows = 1;
+
+ /// The clock, in seconds
+ double mTime = 0;
+
+ /// Largest distance from an item's location to the edge of its bounds
+ int mMargin = 0;
+
+ /// Counts events and generations, so each is different
+ unsigned long long mCount = 0;
+
+ /// Events waiting to happen, soonest first
+ std::priority_queue<Event, std::vector<Event>, std::greater<Event>> mEvents;
+
+ /// Items that move
+ std::unordered_map<Item*, Entry> mEntries;
+
+ /// Items that move listed in each cell
+ std::vector<std::vector<Item*>> mCells;
+
+ /// Items that do not move
+ std::vector<Item*> mStill;
+
+ void Locate(Item* item, Entry& entry, double time);
+ void Anchor(Item* item, Entry& entry, double time);
+ void Schedule(Item* item, Entry& entry);
+ void Happen(Item* item, Entry& entry, double time);
+ void Seek(double time);
+ size_t CellAt(double x, double y) const;
+ void Unlist(Entry& entry);
+ void List(Item* item, Entry& entry, size_t cell);
+
+public:
+ explicit Kinetics(double cellSize = 256);
+
+ void Start(const std::vector<std::shared_ptr<Item>>& items, const wxSize& size);
+ void Stop();
+ void Add(Item* item);
+ void Remove(Item* item);
+ void Moved(Item* item);
+ void AdvanceTo(double time);
+ void Locate(Item* item);
+ void LocateAll();
+ void Query(const wxRect& rect, std::vector<Item*>& items);
+ size_t GetMemory() const;
+
+ /**
+  * Get the clock
+  * @return Time in seconds since Start
+  */
+ double GetTime() const { return mTime; }
+
+ /**
+  * Get the number of events waiting, including ones no longer valid
+  * @return Number of events in the queue
+  */
+ size_t GetPending() const { return mEvents.size(); }
+};
+
+#endif //KINETICS_H
@@ -1,83 +1,275 @@
-/**
- * @file MainFrame.cpp
- * @author Evan Gasper
- *
- * MainFrame window
- */
-
-#include "pch.h"
-#include "MainFrame.h"
-#include "AquariumView.h"
-#include "ids.h"
-
-
-/**
- * Initialize the MainFrame window.
- */
-void MainFrame::Initialize()
-{
- Create(nullptr, wxID_ANY, L"Aquarium", wxDefaultPosition,  wxSize( 1000,800 ));
-
- // Create a sizer that will lay out child windows vertically
- // one above each other
- auto sizer = new wxBoxSizer( wxVERTICAL );
-
- // Create the view class object as a child of MainFrame
- auto aquariumView = new AquariumView();
- aquariumView->Initialize(this);
-
- // Add it to the sizer
- sizer->Add(aquariumView,1, wxEXPAND | wxALL );
-
- // Set the sizer for this frame
- SetSizer( sizer );
-
- // Layout (place) the child windows.
- Layout();
-
- /// Create the menus
- auto menuBar = new wxMenuBar( );
- auto fileMenu = new wxMenu();
- auto helpMenu = new wxMenu();
- auto fishMenu = new wxMenu();
-
- // Top bar shows File, Add Fish, Help, Saving, Loading
- menuBar->Append(fileMenu, L"&File" );
- menuBar->Append(fishMenu, L"&Add Fish");
- menuBar->Append(helpMenu, L"&Help");
- fileMenu->Append(wxID_EXIT, "E&xit\tAlt-X", "Quit this program");
- fileMenu->Append(wxID_SAVEAS, "Save &As...\tCtrl-S", L"Save aquarium as...");
- fileMenu->Append(wxID_OPEN, "Open &File...\tCtrl-F", L"Open aquarium file...");
- fishMenu->Append(IDM_ADDFISHBETA, L"&Beta Fish", L"Add a Beta Fish");
- fishMenu->Append(IDM_ADDFISHDOVA, L"&Dova Fish", L"Add a Dova Fish");
- fishMenu->Append(IDM_ADDFISHCHEST, L"&Chest", L"Add a Chest");
- fishMenu->Append(IDM_ADDDECORCASTLE, L"&Castle", L"Add a Castle");
- helpMenu->Append(wxID_ABOUT, "&About\tF1", "Show about dialog");
-
- SetMenuBar( menuBar );
- CreateStatusBar( 1, wxSTB_SIZEGRIP, wxID_ANY );
-
- Bind(wxEVT_COMMAND_MENU_SELECTED, &MainFrame::OnExit, this, wxID_EXIT);
- Bind(wxEVT_COMMAND_MENU_SELECTED, &MainFrame::OnAbout, this, wxID_ABOUT);
-}
-
-
-/**
- * Exit menu option handlers
- * @param event
- */
-void MainFrame::OnExit(wxCommandEvent& event)
-{
- Close(true);
-}
-
-/**
- * About menu option handler
- * @param event
- */
-void MainFrame::OnAbout(wxCommandEvent& event)
-{
- wxMessageBox(L"Welcome to the Aquarium!",
-  L"About Aquarium",
-  wxOK, this);
-}
\ No newline at end of file
+/**
+ * @file MainFrame.cpp
+ * @author Evan Gasper
+ *
+ * MainFrame window
+ */
+
+#include "pch.h"
+#include "MainFrame.h"
+#include "AquariumView.h"
+#include "ids.h"
+#include "WorkerPool.h"
+#include <algorithm>
+#include <cmath>
+
+/// Frame duration in milliseconds
+const int FrameDuration = 30;
+
+/// Time between refreshes of preview windows, in milliseconds
+const long PreviewInterval = 100;
+
+/// Initial size of preview windows
+const wxSize PreviewSize(400, 300);
+
+/**
+ * Initialize the MainFrame window.
+ */
+void MainFrame::Initialize()
+{
+ Create(nullptr, wxID_ANY, L"Aquarium", wxDefaultPosition,  wxSize( 1000,800 ));
+
+ // Create the first tank, which lays out the child windows
+ AddTank();
+
+ /// Create the menus
+ auto menuBar = new wxMenuBar( );
+ auto fileMenu = new wxMenu();
+ auto helpMenu = new wxMenu();
+ auto fishMenu = new wxMenu();
+ auto viewMenu = new wxMenu();
+ auto editMenu = new wxMenu();
+
+ // Top bar shows File, Add Fish, Help, Saving, Loading
+ menuBar->Append(fileMenu, L"&File" );
+ menuBar->Append(editMenu, L"&Edit");
+ menuBar->Append(fishMenu, L"&Add Fish");
+ menuBar->Append(viewMenu, L"&View");
+ menuBar->Append(helpMenu, L"&Help");
+ fileMenu->Append(wxID_EXIT, "E&xit\tAlt-X", "Quit this program");
+ fileMenu->Append(wxID_SAVEAS, "Save &As...\tCtrl-S", L"Save aquarium as...");
+ fileMenu->Append(wxID_OPEN, "Open &File...\tCtrl-F", L"Open aquarium file...");
+ fileMenu->Append(IDM_CANCELJOB, L"&Cancel Load/Save", L"Stop the load or save in progress");
+ fileMenu->Append(IDM_ADDTANK, L"Add &Tank\tCtrl-T", L"Show another tank beside the others");
+ editMenu->Append(IDM_DELETE, L"&Delete\tDel", L"Remove the selected items");
+ editMenu->Append(IDM_BRINGTOFRONT, L"Bring to &Front\tCtrl-B", L"Draw the selected items in front of the others");
+ editMenu->Append(IDM_MIRROR, L"&Mirror\tCtrl-M", L"Turn the selected items to face the other way");
+ editMenu->AppendSeparator();
+ editMenu->Append(IDM_SELECTALL, L"Select &All\tCtrl-A", L"Select every item in the tank");
+ fishMenu->Append(IDM_ADDFISHBETA, L"&Beta Fish", L"Add a Beta Fish");
+ fishMenu->Append(IDM_ADDFISHDOVA, L"&Dova Fish", L"Add a Dova Fish");
+ fishMenu->Append(IDM_ADDFISHCHEST, L"&Chest", L"Add a Chest");
+ fishMenu->Append(IDM_ADDDECORCASTLE, L"&Castle", L"Add a Castle");
+ fishMenu->AppendSeparator();
+ fishMenu->Append(IDM_ADDMANY100, L"100 Fish", L"Add 100 fish spread over the tank");
+ fishMenu->Append(IDM_ADDMANY1000, L"1,000 Fish", L"Add 1,000 fish spread over the tank");
+ fishMenu->Append(IDM_ADDMANY10000, L"10,000 Fish", L"Add 10,000 fish spread over the tank");
+ viewMenu->Append(IDM_ZOOMIN, L"Zoom &In\tCtrl-=", L"Zoom in on the aquarium");
+ viewMenu->Append(IDM_ZOOMOUT, L"Zoom &Out\tCtrl--", L"Zoom out from the aquarium");
+ viewMenu->Append(IDM_ZOOMRESET, L"&Reset View\tCtrl-0", L"Show the aquarium at full size from the top left");
+ viewMenu->AppendSeparator();
+ viewMenu->AppendCheckItem(IDM_LARGETANK, L"&Large Tank", L"Make the aquarium many times larger than the window");
+ viewMenu->AppendCheckItem(IDM_SCHOOLING, L"&Schooling", L"Make fish school with others of their species");
+ viewMenu->AppendCheckItem(IDM_COLLISIONS, L"&Collisions", L"Make fish bump into each other and into decor");
+ viewMenu->AppendCheckItem(IDM_KINETIC, L"&Kinetic Motion", L"Only move fish when they reach a wall or can be seen");
+ viewMenu->AppendSeparator();
+ viewMenu->AppendRadioItem(IDM_RENDERDC, L"Draw with &Device Context", L"Draw straight onto the window");
+ viewMenu->AppendRadioItem(IDM_RENDERGRAPHICS, L"Draw with &Graphics Context", L"Draw through the platform's graphics library");
+ viewMenu->AppendSeparator();
+ viewMenu->Append(IDM_PREVIEW, L"Open &Preview Window", L"Show the current tank in a window of its own");
+ viewMenu->Append(IDM_MEMORY, L"&Memory Usage...", L"Show what the current tank's memory is used for");
+ helpMenu->Append(wxID_ABOUT, "&About\tF1", "Show about dialog");
+
+ SetMenuBar( menuBar );
+ CreateStatusBar( 1, wxSTB_SIZEGRIP, wxID_ANY );
+
+ Bind(wxEVT_COMMAND_MENU_SELECTED, &MainFrame::OnExit, this, wxID_EXIT);
+ Bind(wxEVT_COMMAND_MENU_SELECTED, &MainFrame::OnAbout, this, wxID_ABOUT);
+ Bind(wxEVT_COMMAND_MENU_SELECTED, &MainFrame::OnAddTank, this, IDM_ADDTANK);
+ Bind(wxEVT_COMMAND_MENU_SELECTED, &MainFrame::OnPreview, this, IDM_PREVIEW);
+
+ // Every other menu event goes to the current view
+ Bind(wxEVT_COMMAND_MENU_SELECTED, &MainFrame::OnMenu, this);
+ Bind(wxEVT_UPDATE_UI, &MainFrame::OnUpdateMenu, this);
+
+ // Create a timer and set it to the const FrameDuration
+ mTimer.SetOwner(this);
+ mTimer.Start(FrameDuration);
+ Bind(wxEVT_TIMER, &MainFrame::OnTimer, this);
+}
+
+/**
+ * Add a tank, shown in a new view beside the others
+ * @return The view showing the tank
+ */
+AquariumView *MainFrame::AddTank()
+{
+ auto view = new AquariumView();
+ view->Initialize(this, int(mViews.size()));
+ view->SetActivated([this](AquariumView *view) { SetView(view); });
+ mViews.push_back(view);
+
+ LayoutViews();
+ SetView(view);
+ return view;
+}
+
+/**
+ * Lay the views out in a grid about as wide as it is high
+ */
+void MainFrame::LayoutViews()
+{
+ int columns = int(ceil(sqrt(double(mViews.size()))));
+ int rows = int(mViews.size() + columns - 1) / columns;
+
+ // Setting a new sizer deletes the old one, but not the views
+ auto sizer = new wxGridSizer(rows, columns, 2, 2);
+ for (auto view : mViews)
+ {
+  sizer->Add(view, 1, wxEXPAND | wxALL);
+ }
+
+ SetSizer(sizer);
+
+ // Layout (place) the child windows.
+ Layout();
+}
+
+/**
+ * Make a view the one the menus act on
+ * @param view The view
+ */
+void MainFrame::SetView(AquariumView *view)
+{
+ if (view == mAquariumView)
+ {
+  return;
+ }
+
+ mAquariumView = view;
+ for (auto other : mViews)
+ {
+  other->SetCurrent(other == view, other == view && mViews.size() > 1);
+ }
+
+ if (mViews.size() > 1)
+ {
+  auto tank = std::find(mViews.begin(), mViews.end(), view) - mViews.begin();
+  SetStatusText(wxString::Format(L"Tank %d of %d", int(tank + 1), int(mViews.size())));
+ }
+}
+
+/**
+ * Step every tank, then refresh the views.
+ *
+ * The tanks are independent, so they are stepped at the same time
+ * on the worker pool, with the UI thread taking a share. Run only
+ * waits for workers that picked up a tank, so a frame never waits
+ * behind saves or image decodes queued before it, and a step that
+ * runs more work on the pool, as replaying a load does, cannot
+ * deadlock. Only the painting that follows is done one view at a
+ * time. Each tank is stepped once, however many previews show it.
+ *
+ * @param event Timer event
+ */
+void MainFrame::OnTimer(wxTimerEvent &event)
+{
+ WorkerPool::Shared().Run(mViews.size(), [this](size_t i) { mViews[i]->Step(); });
+
+ for (auto view : mViews)
+ {
+  view->Tick();
+ }
+
+ for (auto preview : mPreviews)
+ {
+  preview->Tick();
+ }
+}
+
+/**
+ * Pass a menu event on to the current view
+ * @param event Menu event
+ */
+void MainFrame::OnMenu(wxCommandEvent &event)
+{
+ if (!mAquariumView->GetEventHandler()->ProcessEventLocally(event))
+ {
+  event.Skip();
+ }
+}
+
+/**
+ * Pass a menu update event on to the current view
+ * @param event Update event
+ */
+void MainFrame::OnUpdateMenu(wxUpdateUIEvent &event)
+{
+ if (!mAquariumView->GetEventHandler()->ProcessEventLocally(event))
+ {
+  event.Skip();
+ }
+}
+
+/**
+ * Menu handler for File>Add Tank
+ * @param event Menu event
+ */
+void MainFrame::OnAddTank(wxCommandEvent &event)
+{
+ AddTank()->Recover();
+}
+
+
+/**
+ * Exit menu option handlers
+ * @param event
+ */
+void MainFrame::OnExit(wxCommandEvent& event)
+{
+ Close(true);
+}
+
+/**
+ * About menu option handler
+ * @param event
+ */
+void MainFrame::OnAbout(wxCommandEvent& event)
+{
+ wxMessageBox(L"Welcome to the Aquarium!",
+  L"About Aquarium",
+  wxOK, this);
+}
+/**
+ * Menu handler for View>Open Preview Window
+ *
+ * The preview draws the current tank scaled to fit the window,
+ * less often than the main view does.
+ *
+ * @param event Menu event
+ */
+void MainFrame::OnPreview(wxCommandEvent &event)
+{
+ auto tank = std::find(mViews.begin(), mViews.end(), mAquariumView) - mViews.begin();
+ auto window = new wxFrame(this, wxID_ANY, wxString::Format(L"Aquarium Tank %d", int(tank + 1)),
+         wxDefaultPosition, PreviewSize);
+
+ auto preview = new AquariumView();
+ preview->Initialize(window, int(tank), mAquariumView->GetAquarium());
+ preview->SetCurrent(false, false);
+ preview->SetFitting(true);
+ preview->SetRefreshInterval(PreviewInterval);
+
+ auto sizer = new wxBoxSizer(wxVERTICAL);
+ sizer->Add(preview, 1, wxEXPAND | wxALL);
+ window->SetSizer(sizer);
+ window->Layout();
+
+ mPreviews.push_back(preview);
+ window->Bind(wxEVT_CLOSE_WINDOW, [this, preview](wxCloseEvent &event) {
+  mPreviews.erase(std::find(mPreviews.begin(), mPreviews.end(), preview));
+  event.Skip();
+ });
+
+ window->Show(true);
+}
@@ -1,23 +1,68 @@
-/**
-* @file MainFrame.h
- * @author Evan Gasper
- *
- * The top-level (main) frame of the application
- */
-
-#ifndef AQUARIUM_MAINFRAME_H
-#define AQUARIUM_MAINFRAME_H
-
-/**
- * The top-level (main) frame of the application
- */
-class MainFrame : public wxFrame {
-private:
-
-public:
- void Initialize();
- void OnExit(wxCommandEvent& event);
- void OnAbout(wxCommandEvent& event);
-};
-
+/**
+* @file MainFrame.h
+ * @author Evan Gasper
+ *
+ * The top-level (main) frame of the application
+ */
+
+#ifndef AQUARIUM_MAINFRAME_H
+#define AQUARIUM_MAINFRAME_H
+
+#include <vector>
+
+class AquariumView;
+
+/**
+ * The top-level (main) frame of the application
+ *
+ * The frame shows one or more tanks in a grid. Every frame, all
+ * of the tanks are stepped at once on the worker pool, then each
+ * is painted on the UI thread. The menus act on the tank the user
+ * last clicked in.
+ *
+ * A tank can also be shown in preview windows of its own. These
+ * draw the same aquarium but never move it on.
+ */
+class MainFrame : public wxFrame {
+private:
+ /// The view the menus act on
+ AquariumView *mAquariumView = nullptr;
+
+ /// Every view, in the order they were added
+ std::vector<AquariumView*> mViews;
+
+ /// Views in preview windows, showing aquariums owned by mViews
+ std::vector<AquariumView*> mPreviews;
+
+ /// Timer that steps and refreshes the views
+ wxTimer mTimer;
+
+ void OnTimer(wxTimerEvent& event);
+ void OnMenu(wxCommandEvent& event);
+ void OnUpdateMenu(wxUpdateUIEvent& event);
+ void OnAddTank(wxCommandEvent& event);
+ void OnPreview(wxCommandEvent& event);
+ void SetView(AquariumView* view);
+ void LayoutViews();
+
+public:
+ void Initialize();
+ AquariumView* AddTank();
+
+ /**
+  * Get the view the menus act on
+  * @return The view
+  */
+ AquariumView *GetView() { return mAquariumView; }
+
+ /**
+  * Get every view, in the order they were added
+  * @return The views
+  */
+ const std::vector<AquariumView*>& GetViews() const { return mViews; }
+
+ void OnExit(wxCommandEvent& event);
+ void OnAbout(wxCommandEvent& event);
+};
+
 #endif //AQUARIUM_MAINFRAME_H
\ No newline at end of file
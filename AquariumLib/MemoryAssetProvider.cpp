@@ -0,0 +1,93 @@
+/**
+ * @file MemoryAssetProvider.cpp
+ * @author Evan Gasper
+ */
+
+#include "pch.h"
+#include "MemoryAssetProvider.h"
+
+using namespace std;
+
+/**
+ * Constructor
+ * @param placeholderSize Size in pixels of images that are made up
+ */
+MemoryAssetProvider::MemoryAssetProvider(const wxSize &placeholderSize) : mPlaceholderSize(placeholderSize)
+{
+}
+
+/**
+ * Add an image. This has to be done before anything
+ * asks for the image, since sprites are only made once.
+ * @param name The image name items ask for
+ * @param image The image
+ */
+void MemoryAssetProvider::Add(const wxString &name, const wxImage &image)
+{
+ lock_guard<mutex> lock(mImagesMutex);
+ mImages[name] = image.Copy();
+}
+
+/**
+ * Get the size of an image
+ * @param name The image name
+ * @return Size in pixels
+ */
+wxSize MemoryAssetProvider::GetSize(const wxString &name)
+{
+ lock_guard<mutex> lock(mImagesMutex);
+ auto found = mImages.find(name);
+ return found != mImages.end() ? found->second.GetSize() : mPlaceholderSize;
+}
+
+/**
+ * Get an image, making it up if it was not added
+ * @param name The image name
+ * @return A copy of the image, so threads never share its pixels
+ */
+wxImage MemoryAssetProvider::Load(const wxString &name)
+{
+ {
+  lock_guard<mutex> lock(mImagesMutex);
+  auto found = mImages.find(name);
+  if (found != mImages.end())
+  {
+   return found->second.Copy();
+  }
+ }
+
+ return MakePlaceholder(name, mPlaceholderSize);
+}
+
+/**
+ * Make up an image: an opaque ellipse filling the image on a see
+ * through background. The same name always gets the same colour.
+ * @param name The image name, which picks the colour
+ * @param size Size of the image in pixels
+ * @return The image
+ */
+wxImage MemoryAssetProvider::MakePlaceholder(const wxString &name, const wxSize &size)
+{
+ auto hash = std::hash<std::wstring>()(name.ToStdWstring());
+ unsigned char red = hash & 0xff;
+ unsigned char green = (hash >> 8) & 0xff;
+ unsigned char blue = (hash >> 16) & 0xff;
+
+ int width = size.GetWidth();
+ int height = size.GetHeight();
+ wxImage image(width, height, false);
+ image.InitAlpha();
+ for (int y = 0; y < height; y++)
+ {
+  for (int x = 0; x < width; x++)
+  {
+   // Distance from the centre, where the edge of the ellipse is 1
+   double dx = (x + 0.5) / width * 2 - 1;
+   double dy = (y + 0.5) / height * 2 - 1;
+   image.SetRGB(x, y, red, green, blue);
+   image.SetAlpha(x, y, dx * dx + dy * dy <= 1 ? wxIMAGE_ALPHA_OPAQUE : wxIMAGE_ALPHA_TRANSPARENT);
+  }
+ }
+
+ return image;
+}
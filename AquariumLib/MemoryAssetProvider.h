@@ -0,0 +1,44 @@
+/**
+ * @file MemoryAssetProvider.h
+ * @author Evan Gasper
+ *
+ * Provides images held in memory, made up if not given
+ */
+
+#ifndef MEMORYASSETPROVIDER_H
+#define MEMORYASSETPROVIDER_H
+
+#include "AssetProvider.h"
+
+/**
+ * Provides images held in memory, so nothing is read from disk.
+ *
+ * Images can be added by name. Any other image is made up: an
+ * opaque ellipse filling the placeholder size, in a colour picked
+ * from its name, on a see through background. Tests and benchmarks
+ * use this so they run the same from any directory and do not wait
+ * on files or the PNG decoder.
+ */
+class MemoryAssetProvider : public AssetProvider {
+private:
+ /// Protects mImages
+ std::mutex mImagesMutex;
+
+ /// Images added by name
+ std::map<wxString, wxImage> mImages;
+
+ /// Size of made up images in pixels
+ wxSize mPlaceholderSize;
+
+public:
+ explicit MemoryAssetProvider(const wxSize& placeholderSize = wxSize(64, 32));
+
+ void Add(const wxString& name, const wxImage& image);
+
+ wxSize GetSize(const wxString& name) override;
+ wxImage Load(const wxString& name) override;
+
+ static wxImage MakePlaceholder(const wxString& name, const wxSize& size);
+};
+
+#endif //MEMORYASSETPROVIDER_H
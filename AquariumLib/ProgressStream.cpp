@@ -0,0 +1,77 @@
+/**
+ * @file ProgressStream.cpp
+ * @author Evan Gasper
+ */
+
+#include "pch.h"
+#include "ProgressStream.h"
+
+#include <algorithm>
+
+/**
+ * Constructor
+ * @param stream The stream we read from
+ * @param length Number of bytes we expect to read
+ * @param progress Callback to report progress to
+ */
+ProgressInputStream::ProgressInputStream(wxInputStream &stream, wxFileOffset length,
+        ProgressCallback progress) :
+    wxFilterInputStream(stream), mProgress(std::move(progress)), mLength(length)
+{
+}
+
+/**
+ * Read from the underlying stream and report progress
+ * @param buffer Buffer to read into
+ * @param size Size of the buffer in bytes
+ * @return Number of bytes read
+ */
+size_t ProgressInputStream::OnSysRead(void *buffer, size_t size)
+{
+ double fraction = mLength > 0 ? std::min(1.0, double(mRead) / double(mLength)) : 0;
+ if (mProgress && !mProgress(fraction))
+ {
+  m_lasterror = wxSTREAM_READ_ERROR;
+  return 0;
+ }
+
+ m_parent_i_stream->Read(buffer, size);
+ auto read = m_parent_i_stream->LastRead();
+ m_lasterror = m_parent_i_stream->GetLastError();
+ mRead += read;
+ return read;
+}
+
+/**
+ * Constructor
+ * @param stream The stream we write to
+ * @param length Number of bytes we expect to write
+ * @param progress Callback to report progress to
+ */
+ProgressOutputStream::ProgressOutputStream(wxOutputStream &stream, wxFileOffset length,
+        ProgressCallback progress) :
+    wxFilterOutputStream(stream), mProgress(std::move(progress)), mLength(length)
+{
+}
+
+/**
+ * Write to the underlying stream and report progress
+ * @param buffer Data to write
+ * @param size Size of the data in bytes
+ * @return Number of bytes written
+ */
+size_t ProgressOutputStream::OnSysWrite(const void *buffer, size_t size)
+{
+ double fraction = mLength > 0 ? std::min(1.0, double(mWritten) / double(mLength)) : 0;
+ if (mProgress && !mProgress(fraction))
+ {
+  m_lasterror = wxSTREAM_WRITE_ERROR;
+  return 0;
+ }
+
+ m_parent_o_stream->Write(buffer, size);
+ auto written = m_parent_o_stream->LastWrite();
+ m_lasterror = m_parent_o_stream->GetLastError();
+ mWritten += written;
+ return written;
+}
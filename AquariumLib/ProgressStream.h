@@ -0,0 +1,83 @@
+/**
+ * @file ProgressStream.h
+ * @author Evan Gasper
+ *
+ * Stream filters that report how far a load or save has gone
+ */
+
+#ifndef PROGRESSSTREAM_H
+#define PROGRESSSTREAM_H
+
+#include <functional>
+#include <wx/stream.h>
+
+/**
+ * Callback used to report progress of a long operation.
+ *
+ * Receives the fraction complete (0 to 1) and returns
+ * false if the operation should be cancelled.
+ */
+typedef std::function<bool(double)> ProgressCallback;
+
+/**
+ * Input stream filter that counts the bytes read through it.
+ *
+ * Progress is reported as a fraction of the expected length.
+ * Returning false from the callback makes the next read fail,
+ * which aborts whatever is parsing the stream.
+ */
+class ProgressInputStream : public wxFilterInputStream {
+private:
+ /// Progress callback, may be empty
+ ProgressCallback mProgress;
+
+ /// Total bytes we expect to read
+ wxFileOffset mLength;
+
+ /// Bytes read so far
+ wxFileOffset mRead = 0;
+
+protected:
+ size_t OnSysRead(void* buffer, size_t size) override;
+
+public:
+ ProgressInputStream(wxInputStream& stream, wxFileOffset length, ProgressCallback progress);
+
+ /// Copy constructor (disabled)
+ ProgressInputStream(const ProgressInputStream &) = delete;
+
+ /// Assignment operator (disabled)
+ void operator=(const ProgressInputStream &) = delete;
+};
+
+/**
+ * Output stream filter that counts the bytes written through it.
+ *
+ * Progress is reported as a fraction of the expected length.
+ * Returning false from the callback makes the next write fail.
+ */
+class ProgressOutputStream : public wxFilterOutputStream {
+private:
+ /// Progress callback, may be empty
+ ProgressCallback mProgress;
+
+ /// Total bytes we expect to write
+ wxFileOffset mLength;
+
+ /// Bytes written so far
+ wxFileOffset mWritten = 0;
+
+protected:
+ size_t OnSysWrite(const void* buffer, size_t size) override;
+
+public:
+ ProgressOutputStream(wxOutputStream& stream, wxFileOffset length, ProgressCallback progress);
+
+ /// Copy constructor (disabled)
+ ProgressOutputStream(const ProgressOutputStream &) = delete;
+
+ /// Assignment operator (disabled)
+ void operator=(const ProgressOutputStream &) = delete;
+};
+
+#endif //PROGRESSSTREAM_H
@@ -0,0 +1,37 @@
+/**
+ * @file Renderer.cpp
+ * @author Evan Gasper
+ */
+
+#include "pch.h"
+#include "Renderer.h"
+#include "DcRenderer.h"
+#include "GraphicsRenderer.h"
+
+using namespace std;
+
+/**
+ * Create a renderer by name.
+ *
+ * "dc" draws straight onto the device context, the way the
+ * aquarium has always been drawn. "graphics" draws through a
+ * wxGraphicsContext, which can use the platform's accelerated
+ * drawing.
+ *
+ * @param name Name of the renderer
+ * @return The renderer, or null if there is none by that name
+ */
+std::unique_ptr<Renderer> Renderer::Create(const wxString &name)
+{
+ if (name == DcRenderer::Name)
+ {
+  return make_unique<DcRenderer>();
+ }
+
+ if (name == GraphicsRenderer::Name)
+ {
+  return make_unique<GraphicsRenderer>();
+ }
+
+ return nullptr;
+}
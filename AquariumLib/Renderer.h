@@ -0,0 +1,81 @@
+/**
+ * @file Renderer.h
+ * @author Evan Gasper
+ *
+ * Base class for the ways the aquarium can be drawn
+ */
+
+#ifndef RENDERER_H
+#define RENDERER_H
+
+#include <memory>
+
+class Sprite;
+
+/**
+ * Base class for the ways the aquarium can be drawn.
+ *
+ * The aquarium and its items draw through a renderer rather than
+ * straight onto a device context, so how the drawing reaches the
+ * screen can be chosen while the program runs. A frame is drawn
+ * between calls to Begin and End, in aquarium coordinates.
+ */
+class Renderer {
+public:
+ /// Destructor
+ virtual ~Renderer() = default;
+
+ /**
+  * Start drawing a frame.
+  * @param dc Device context to draw on
+  * @param scale How many screen pixels there are to each aquarium pixel
+  * @param origin The aquarium point at the top left of the screen
+  */
+ virtual void Begin(wxDC* dc, double scale, const wxPoint& origin) = 0;
+
+ /**
+  * Finish drawing a frame. Everything drawn since Begin
+  * is on the device context after this.
+  */
+ virtual void End() = 0;
+
+ /**
+  * Draw a sprite.
+  * @param sprite The sprite to draw
+  * @param x Left edge in aquarium pixels
+  * @param y Top edge in aquarium pixels
+  * @param mirror True to draw the sprite mirrored left to right
+  * @param level Level of detail, 0 for full size
+  */
+ virtual void DrawSprite(Sprite* sprite, int x, int y, bool mirror = false, int level = 0) = 0;
+
+ /**
+  * Fill a rectangle with no outline.
+  * @param brush The brush to fill with
+  * @param x Left edge in aquarium pixels
+  * @param y Top edge in aquarium pixels
+  * @param width Width in aquarium pixels
+  * @param height Height in aquarium pixels
+  */
+ virtual void FillRectangle(const wxBrush& brush, int x, int y, int width, int height) = 0;
+
+ /**
+  * Draw some text.
+  * @param text The text to draw
+  * @param x Left edge in aquarium pixels
+  * @param y Top edge in aquarium pixels
+  * @param font The font to draw with
+  * @param colour The colour of the text
+  */
+ virtual void DrawText(const wxString& text, int x, int y, const wxFont& font, const wxColour& colour) = 0;
+
+ /**
+  * The name the renderer is chosen by
+  * @return Name as passed to Create
+  */
+ virtual wxString GetName() const = 0;
+
+ static std::unique_ptr<Renderer> Create(const wxString& name);
+};
+
+#endif //RENDERER_H
@@ -0,0 +1,107 @@
+/**
+ * @file School.cpp
+ * @author Evan Gasper
+ */
+
+#include "pch.h"
+#include "School.h"
+#include <cmath>
+
+using namespace std;
+
+/**
+ * Constructor
+ * @param cellSize Width and height of each cell in pixels,
+ * the largest distance neighbours are looked for at
+ */
+School::School(double cellSize) : mCellSize(cellSize)
+{
+}
+
+/**
+ * Remove all of the members
+ */
+void School::Clear()
+{
+ // The vectors keep their memory, so it is reused step to step
+ mMembers.clear();
+ mOrder.clear();
+ mBucketStarts.clear();
+}
+
+/**
+ * Add a member. Build must be called after the last one is added.
+ * @param member The member to add
+ * @return Number of the member, for GetMember
+ */
+size_t School::Add(const Member &member)
+{
+ mMembers.push_back(member);
+ return mMembers.size() - 1;
+}
+
+/**
+ * Put the members into the hash.
+ *
+ * The table has at least twice as many buckets as members, so
+ * few cells share a bucket. Members are grouped by bucket with
+ * a counting sort, so this takes time in proportion to the
+ * number of members.
+ */
+void School::Build()
+{
+ size_t buckets = 1;
+ while (buckets < mMembers.size() * 2)
+ {
+  buckets *= 2;
+ }
+
+ mMemberBuckets.resize(mMembers.size());
+ mBucketStarts.assign(buckets + 1, 0);
+ for (size_t i = 0; i < mMembers.size(); i++)
+ {
+  mMemberBuckets[i] = Bucket(Cell(mMembers[i].mX), Cell(mMembers[i].mY));
+  mBucketStarts[mMemberBuckets[i] + 1]++;
+ }
+
+ for (size_t bucket = 0; bucket < buckets; bucket++)
+ {
+  mBucketStarts[bucket + 1] += mBucketStarts[bucket];
+ }
+
+ // Fill each bucket in member order, using the end of the
+ // bucket before it as the next free place
+ mOrder.resize(mMembers.size());
+ for (size_t i = 0; i < mMembers.size(); i++)
+ {
+  mOrder[mBucketStarts[mMemberBuckets[i]]++] = i;
+ }
+
+ for (size_t bucket = buckets; bucket > 0; bucket--)
+ {
+  mBucketStarts[bucket] = mBucketStarts[bucket - 1];
+ }
+ mBucketStarts[0] = 0;
+}
+
+/**
+ * Find the cell a coordinate is in
+ * @param coordinate X or Y in pixels
+ * @return Column or row of the cell
+ */
+long long School::Cell(double coordinate) const
+{
+ return (long long)floor(coordinate / mCellSize);
+}
+
+/**
+ * Find the bucket a cell is hashed to
+ * @param column Column of the cell
+ * @param row Row of the cell
+ * @return Bucket number
+ */
+size_t School::Bucket(long long column, long long row) const
+{
+ auto hash = (unsigned long long)column * 73856093ULL ^ (unsigned long long)row * 19349663ULL;
+ return size_t(hash & (mBucketStarts.size() - 2));
+}
@@ -0,0 +1,152 @@
+/**
+ * @file School.h
+ * @author Evan Gasper
+ *
+ * Where every schooling fish was at the start of a step
+ */
+
+#ifndef SCHOOL_H
+#define SCHOOL_H
+
+#include <vector>
+
+/**
+ * Where every schooling fish was at the start of a step.
+ *
+ * Fish steer by their neighbours, so the school keeps a copy of each
+ * fish's position and speed from before anything moved. That way
+ * the order fish are updated in does not matter.
+ *
+ * The members are put in a spatial hash: the aquarium is divided into
+ * square cells the size of the neighbour radius, and each cell is
+ * hashed into a table of buckets. Rebuilding it every step is one
+ * pass over the members, and finding the neighbours of a fish only
+ * looks at the nine cells around it, so the cost depends on how many
+ * fish are nearby rather than on how many there are in total. It
+ * also works for aquariums of any size.
+ */
+class School {
+public:
+ /// What neighbours need to know about a fish
+ struct Member {
+  double mX;                ///< X location in pixels
+  double mY;                ///< Y location in pixels
+  double mSpeedX;           ///< X speed in pixels per second
+  double mSpeedY;           ///< Y speed in pixels per second
+  const void* mSpecies;     ///< Fish of the same species have the same value
+ };
+
+private:
+ /// Width and height of each cell in pixels
+ double mCellSize;
+
+ /// The members, in the order they were added
+ std::vector<Member> mMembers;
+
+ /// Member numbers, grouped by bucket
+ std::vector<size_t> mOrder;
+
+ /// Where each bucket's members start in mOrder, plus one past the end
+ std::vector<size_t> mBucketStarts;
+
+ /// Bucket of each member while building
+ std::vector<size_t> mMemberBuckets;
+
+ size_t Bucket(long long column, long long row) const;
+ long long Cell(double coordinate) const;
+
+public:
+ explicit School(double cellSize);
+
+ void Clear();
+ size_t Add(const Member& member);
+ void Build();
+
+ /**
+  * Get a member
+  * @param index Number returned by Add
+  * @return The member
+  */
+ const Member& GetMember(size_t index) const { return mMembers[index]; }
+
+ /**
+  * Get the number of members
+  * @return Number of fish added since Clear
+  */
+ size_t GetSize() const { return mMembers.size(); }
+
+ /**
+  * Get the width and height of the cells
+  * @return Cell size in pixels, the largest radius Visit finds everything within
+  */
+ double GetCellSize() const { return mCellSize; }
+
+ /**
+  * Get the memory the members and buckets take up
+  * @return Size in bytes
+  */
+ size_t GetMemory() const
+ {
+  return mMembers.capacity() * sizeof(Member) +
+         (mOrder.capacity() + mBucketStarts.capacity() + mMemberBuckets.capacity()) * sizeof(size_t);
+ }
+
+ /**
+  * Visit the members near a location.
+  *
+  * Every member within the cell size of the location is visited
+  * once. Members further away that share a bucket are visited too,
+  * so the visitor has to check the distance. Only valid after Build.
+  *
+  * @param x X location in pixels
+  * @param y Y location in pixels
+  * @param visit Called with the number of each member. Returns false to stop.
+  */
+ template <class Visitor>
+ void Visit(double x, double y, Visitor visit) const
+ {
+  if (mMembers.empty())
+  {
+   return;
+  }
+
+  // The cell the location is in comes first, since its members
+  // are most likely to be close. Neighbouring cells can land in
+  // the same bucket, which must only be looked at once.
+  const int offsets[] = {0, -1, 1};
+  size_t buckets[9];
+  int count = 0;
+  auto column = Cell(x);
+  auto row = Cell(y);
+  for (auto r : offsets)
+  {
+   for (auto c : offsets)
+   {
+    auto bucket = Bucket(column + c, row + r);
+    bool seen = false;
+    for (int i = 0; i < count && !seen; i++)
+    {
+     seen = buckets[i] == bucket;
+    }
+
+    if (!seen)
+    {
+     buckets[count++] = bucket;
+    }
+   }
+  }
+
+  for (int i = 0; i < count; i++)
+  {
+   for (size_t at = mBucketStarts[buckets[i]]; at < mBucketStarts[buckets[i] + 1]; at++)
+   {
+    if (!visit(mOrder[at]))
+    {
+     return;
+    }
+   }
+  }
+ }
+};
+
+#endif //SCHOOL_H
@@ -0,0 +1,313 @@
+/**
+ * @file SessionPlayer.cpp
+ * @author Evan Gasper
+ */
+
+#include "pch.h"
+#include "SessionPlayer.h"
+#include "SessionRecorder.h"
+#include "Aquarium.h"
+#include <cstring>
+#include <wx/mstream.h>
+
+using namespace std;
+
+/**
+ * Open a recorded session
+ * @param filename The file SessionRecorder recorded to
+ * @return true if the file is a session recording
+ */
+bool SessionPlayer::Open(const wxString &filename)
+{
+ char magic[sizeof(SessionMagic)];
+ if (!mFile.Open(filename, L"rb") ||
+     !Read(magic, sizeof(magic)) ||
+     memcmp(magic, SessionMagic, sizeof(magic)) != 0 ||
+     !Read(&mSeed, sizeof(mSeed)))
+ {
+  mFile.Close();
+  return false;
+ }
+
+ mFrames = 0;
+ return true;
+}
+
+/**
+ * Read bytes from the session file
+ * @param data Where to put the bytes
+ * @param size Number of bytes
+ * @return true if all of them were read
+ */
+bool SessionPlayer::Read(void *data, size_t size)
+{
+ return mFile.IsOpened() && mFile.Read(data, size) == size;
+}
+
+/**
+ * Read a string written by SessionRecorder::WriteString
+ * @param text Receives the string
+ * @return true if successful
+ */
+bool SessionPlayer::ReadString(wxString &text)
+{
+ uint32_t length;
+ if (!Read(&length, sizeof(length)))
+ {
+  return false;
+ }
+
+ string utf8(length, '\0');
+ if (!Read(&utf8[0], length))
+ {
+  return false;
+ }
+
+ text = wxString::FromUTF8(utf8.data(), length);
+ return true;
+}
+
+/**
+ * Put an aquarium in the state the recording started from.
+ *
+ * The recording starts from an empty aquarium whose random
+ * number generator was seeded with the recorded seed.
+ *
+ * @param aquarium The aquarium to replay into
+ */
+void SessionPlayer::Start(Aquarium *aquarium)
+{
+ mGrabbedItem = nullptr;
+ mDraggingSelection = false;
+ aquarium->Clear();
+ aquarium->GetRandom().seed(mSeed);
+
+ // Recordings start with the aquarium as the program starts it
+ aquarium->SetSize(aquarium->GetBackgroundSize());
+ aquarium->SetSchooling(false);
+ aquarium->SetCollisions(false);
+ aquarium->SetKinetic(false);
+}
+
+/**
+ * Replay the events of the next frame, ending with its update.
+ *
+ * These are the same steps AquariumView takes for each event,
+ * so the aquarium ends up exactly where it did when recorded.
+ *
+ * @param aquarium The aquarium to replay into
+ * @param elapsed Optional pointer that receives the frame's elapsed time
+ * @return true if a frame was replayed, false at the end of the recording
+ */
+bool SessionPlayer::PlayFrame(Aquarium *aquarium, double *elapsed)
+{
+ SessionRecorder::Event event;
+ while (Read(&event, sizeof(event)))
+ {
+  int32_t location[2];
+  wxString text;
+  char on;
+
+  switch (event)
+  {
+  case SessionRecorder::Event::Frame:
+  {
+   double frame;
+   if (!Read(&frame, sizeof(frame)))
+   {
+    return false;
+   }
+
+   aquarium->Update(frame);
+   mFrames++;
+   if (elapsed != nullptr)
+   {
+    *elapsed = frame;
+   }
+
+   return true;
+  }
+
+  case SessionRecorder::Event::Add:
+   if (!ReadString(text))
+   {
+    return false;
+   }
+
+   aquarium->Add(aquarium->CreateItem(text));
+   break;
+
+  case SessionRecorder::Event::Bulk:
+  {
+   uint32_t count;
+   uint8_t spread;
+   if (!ReadString(text) || !Read(&count, sizeof(count)) || !Read(&spread, sizeof(spread)) ||
+       spread > uint8_t(Aquarium::Spread::Centred))
+   {
+    return false;
+   }
+
+   aquarium->AddBulk(text, count, Aquarium::Spread(spread));
+   break;
+  }
+
+  case SessionRecorder::Event::Load:
+  {
+   // The items recorded are loaded, not the file, which may have
+   // changed since. Replayed edits are not journaled to the file.
+   uint32_t length;
+   if (!ReadString(text) || !Read(&length, sizeof(length)))
+   {
+    return false;
+   }
+
+   string xml(length, '\0');
+   if (!Read(&xml[0], length))
+   {
+    return false;
+   }
+
+   wxMemoryInputStream stream(xml.data(), xml.size());
+   wxXmlDocument xmlDoc;
+   vector<shared_ptr<Item>> items;
+   if (!xmlDoc.Load(stream) || !aquarium->CreateItems(xmlDoc, items))
+   {
+    return false;
+   }
+
+   mGrabbedItem = nullptr;
+   mDraggingSelection = false;
+   aquarium->SetItems(std::move(items));
+   aquarium->SetJournal(nullptr);
+   break;
+  }
+
+  case SessionRecorder::Event::Grab:
+   if (!Read(location, sizeof(location)))
+   {
+    return false;
+   }
+
+   // Grabbing a selected item drags the whole selection.
+   // Grabbing anything else drops the selection.
+   mGrabbedItem = aquarium->HitTest(location[0], location[1]);
+   mDraggingSelection = mGrabbedItem != nullptr && aquarium->IsSelected(mGrabbedItem);
+   if (mDraggingSelection)
+   {
+    mDraggedTo[0] = location[0];
+    mDraggedTo[1] = location[1];
+   }
+   else
+   {
+    aquarium->Select(wxRect());
+    if (mGrabbedItem != nullptr)
+    {
+     aquarium->MoveItemToEnd(mGrabbedItem);
+    }
+   }
+   break;
+
+  case SessionRecorder::Event::Drag:
+   if (!Read(location, sizeof(location)))
+   {
+    return false;
+   }
+
+   if (mDraggingSelection)
+   {
+    aquarium->MoveSelection(location[0] - mDraggedTo[0], location[1] - mDraggedTo[1]);
+    mDraggedTo[0] = location[0];
+    mDraggedTo[1] = location[1];
+   }
+   else if (mGrabbedItem != nullptr)
+   {
+    aquarium->MoveItem(mGrabbedItem, location[0], location[1]);
+   }
+   break;
+
+  case SessionRecorder::Event::Release:
+   if (mDraggingSelection)
+   {
+    aquarium->SelectionMoved();
+   }
+   else if (mGrabbedItem != nullptr)
+   {
+    aquarium->ItemMoved(mGrabbedItem);
+   }
+
+   mGrabbedItem = nullptr;
+   mDraggingSelection = false;
+   break;
+
+  case SessionRecorder::Event::Resize:
+   if (!Read(location, sizeof(location)))
+   {
+    return false;
+   }
+
+   aquarium->SetSize(wxSize(location[0], location[1]));
+   break;
+
+  case SessionRecorder::Event::Schooling:
+   if (!Read(&on, sizeof(on)))
+   {
+    return false;
+   }
+
+   aquarium->SetSchooling(on != 0);
+   break;
+
+  case SessionRecorder::Event::Collisions:
+   if (!Read(&on, sizeof(on)))
+   {
+    return false;
+   }
+
+   aquarium->SetCollisions(on != 0);
+   break;
+
+  case SessionRecorder::Event::Kinetic:
+   if (!Read(&on, sizeof(on)))
+   {
+    return false;
+   }
+
+   aquarium->SetKinetic(on != 0);
+   break;
+
+  case SessionRecorder::Event::Select:
+  {
+   int32_t bounds[4];
+   if (!Read(bounds, sizeof(bounds)))
+   {
+    return false;
+   }
+
+   aquarium->Select(wxRect(bounds[0], bounds[1], bounds[2], bounds[3]));
+   break;
+  }
+
+  case SessionRecorder::Event::SelectAll:
+   aquarium->SelectAll();
+   break;
+
+  case SessionRecorder::Event::Delete:
+   aquarium->RemoveSelection();
+   break;
+
+  case SessionRecorder::Event::Front:
+   aquarium->MoveSelectionToEnd();
+   break;
+
+  case SessionRecorder::Event::Mirror:
+   aquarium->MirrorSelection();
+   break;
+
+  default:
+   // Not a session this version understands
+   return false;
+  }
+ }
+
+ return false;
+}
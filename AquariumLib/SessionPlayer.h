@@ -0,0 +1,75 @@
+/**
+ * @file SessionPlayer.h
+ * @author Evan Gasper
+ *
+ * Replays a session recorded by SessionRecorder
+ */
+
+#ifndef SESSIONPLAYER_H
+#define SESSIONPLAYER_H
+
+#include <cstdint>
+#include <memory>
+#include <wx/ffile.h>
+
+class Aquarium;
+class Item;
+
+/**
+ * Replays a session recorded by SessionRecorder.
+ *
+ * The aquarium is seeded from the recording and then driven one
+ * frame at a time with the recorded events and elapsed times, so
+ * it goes through exactly the states it did when it was recorded.
+ * It works the same with a window or without one.
+ */
+class SessionPlayer {
+private:
+ /// The session file
+ wxFFile mFile;
+
+ /// Seed the aquarium random number generator started from
+ uint32_t mSeed = 0;
+
+ /// Item the mouse is dragging in the replay, if any
+ std::shared_ptr<Item> mGrabbedItem;
+
+ /// True if the mouse is dragging the whole selection
+ bool mDraggingSelection = false;
+
+ /// Where the selection was last dragged to
+ int32_t mDraggedTo[2] = {0, 0};
+
+ /// Number of frames replayed so far
+ long mFrames = 0;
+
+ bool Read(void* data, size_t size);
+ bool ReadString(wxString& text);
+
+public:
+ SessionPlayer() = default;
+
+ /// Copy constructor (disabled)
+ SessionPlayer(const SessionPlayer &) = delete;
+
+ /// Assignment operator (disabled)
+ void operator=(const SessionPlayer &) = delete;
+
+ bool Open(const wxString& filename);
+ void Start(Aquarium* aquarium);
+ bool PlayFrame(Aquarium* aquarium, double* elapsed = nullptr);
+
+ /**
+  * Get the seed the recorded aquarium started from
+  * @return Random number generator seed
+  */
+ uint32_t GetSeed() const { return mSeed; }
+
+ /**
+  * Get the number of frames replayed so far
+  * @return Number of frames
+  */
+ long GetFrames() const { return mFrames; }
+};
+
+#endif //SESSIONPLAYER_H
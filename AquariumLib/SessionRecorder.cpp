@@ -0,0 +1,261 @@
+/**
+ * @file SessionRecorder.cpp
+ * @author Evan Gasper
+ */
+
+#include "pch.h"
+#include "SessionRecorder.h"
+#include "Item.h"
+#include <wx/mstream.h>
+#include <string>
+
+/**
+ * Start recording a session to a file
+ * @param filename The file to record to
+ * @param seed Seed the aquarium random number generator starts from
+ * @return true if the file could be created
+ */
+bool SessionRecorder::Open(const wxString &filename, uint32_t seed)
+{
+ if (!mFile.Open(filename, L"wb"))
+ {
+  return false;
+ }
+
+ Write(SessionMagic, sizeof(SessionMagic));
+ Write(&seed, sizeof(seed));
+ return true;
+}
+
+/**
+ * Write bytes to the session file, if one is open
+ * @param data Bytes to write
+ * @param size Number of bytes
+ */
+void SessionRecorder::Write(const void *data, size_t size)
+{
+ if (mFile.IsOpened())
+ {
+  mFile.Write(data, size);
+ }
+}
+
+/**
+ * Write a string as its UTF-8 length followed by the bytes
+ * @param text The string to write
+ */
+void SessionRecorder::WriteString(const wxString &text)
+{
+ auto utf8 = text.ToUTF8();
+ uint32_t length = uint32_t(utf8.length());
+ Write(&length, sizeof(length));
+ Write(utf8.data(), length);
+}
+
+/**
+ * Record one frame of animation.
+ *
+ * The file is flushed at the end of every frame, so a
+ * recording survives the program crashing.
+ *
+ * @param elapsed Time the aquarium was updated by, in seconds
+ */
+void SessionRecorder::RecordFrame(double elapsed)
+{
+ auto event = Event::Frame;
+ Write(&event, sizeof(event));
+ Write(&elapsed, sizeof(elapsed));
+
+ if (mFile.IsOpened())
+ {
+  mFile.Flush();
+ }
+}
+
+/**
+ * Record an item added to the aquarium
+ * @param item The item that was added
+ */
+void SessionRecorder::RecordAdd(Item *item)
+{
+ ItemState state;
+ item->GetState(state);
+
+ auto event = Event::Add;
+ Write(&event, sizeof(event));
+ WriteString(state.mType);
+}
+
+/**
+ * Record a file loaded into the aquarium.
+ *
+ * Loads run in the background, so this is recorded when the
+ * loaded items replace the old ones, which is the frame the
+ * replay loads them on. The items loaded are recorded, not
+ * just the filename, since the file and its journal may have
+ * changed by the time the session is replayed.
+ *
+ * @param filename The file that was loaded
+ * @param xmlDoc The items the aquarium has after the load
+ */
+void SessionRecorder::RecordLoad(const wxString &filename, const wxXmlDocument &xmlDoc)
+{
+ wxMemoryOutputStream stream;
+ xmlDoc.Save(stream, wxXML_NO_INDENTATION);
+ std::string xml(stream.GetLength(), '\0');
+ stream.CopyTo(&xml[0], xml.size());
+
+ auto event = Event::Load;
+ uint32_t length = uint32_t(xml.size());
+ Write(&event, sizeof(event));
+ WriteString(filename);
+ Write(&length, sizeof(length));
+ Write(xml.data(), length);
+}
+
+/**
+ * Record the mouse button pressed
+ * @param x X location in pixels
+ * @param y Y location in pixels
+ */
+void SessionRecorder::RecordGrab(int x, int y)
+{
+ auto event = Event::Grab;
+ int32_t location[] = {x, y};
+ Write(&event, sizeof(event));
+ Write(location, sizeof(location));
+}
+
+/**
+ * Record the grabbed item dragged
+ * @param x X location in pixels
+ * @param y Y location in pixels
+ */
+void SessionRecorder::RecordDrag(int x, int y)
+{
+ auto event = Event::Drag;
+ int32_t location[] = {x, y};
+ Write(&event, sizeof(event));
+ Write(location, sizeof(location));
+}
+
+/**
+ * Record the grabbed item released
+ */
+void SessionRecorder::RecordRelease()
+{
+ auto event = Event::Release;
+ Write(&event, sizeof(event));
+}
+
+/**
+ * Record the size of the aquarium changed
+ * @param size New size in pixels
+ */
+void SessionRecorder::RecordResize(const wxSize &size)
+{
+ auto event = Event::Resize;
+ int32_t dimensions[] = {size.GetWidth(), size.GetHeight()};
+ Write(&event, sizeof(event));
+ Write(dimensions, sizeof(dimensions));
+}
+
+/**
+ * Record schooling turned on or off
+ * @param schooling true if fish now school
+ */
+void SessionRecorder::RecordSchooling(bool schooling)
+{
+ auto event = Event::Schooling;
+ char on = schooling ? 1 : 0;
+ Write(&event, sizeof(event));
+ Write(&on, sizeof(on));
+}
+
+/**
+ * Record collisions turned on or off
+ * @param collisions true if fish now collide
+ */
+void SessionRecorder::RecordCollisions(bool collisions)
+{
+ auto event = Event::Collisions;
+ char on = collisions ? 1 : 0;
+ Write(&event, sizeof(event));
+ Write(&on, sizeof(on));
+}
+
+/**
+ * Record kinetic motion turned on or off
+ * @param kinetic true if kinetic motion is now asked for
+ */
+void SessionRecorder::RecordKinetic(bool kinetic)
+{
+ auto event = Event::Kinetic;
+ char on = kinetic ? 1 : 0;
+ Write(&event, sizeof(event));
+ Write(&on, sizeof(on));
+}
+
+/**
+ * Record the items in a rectangle selected
+ * @param rect Rectangle in pixels
+ */
+void SessionRecorder::RecordSelect(const wxRect &rect)
+{
+ auto event = Event::Select;
+ int32_t bounds[] = {rect.GetX(), rect.GetY(), rect.GetWidth(), rect.GetHeight()};
+ Write(&event, sizeof(event));
+ Write(bounds, sizeof(bounds));
+}
+
+/**
+ * Record every item selected
+ */
+void SessionRecorder::RecordSelectAll()
+{
+ auto event = Event::SelectAll;
+ Write(&event, sizeof(event));
+}
+
+/**
+ * Record the selected items removed
+ */
+void SessionRecorder::RecordDelete()
+{
+ auto event = Event::Delete;
+ Write(&event, sizeof(event));
+}
+
+/**
+ * Record the selected items moved in front of the others
+ */
+void SessionRecorder::RecordFront()
+{
+ auto event = Event::Front;
+ Write(&event, sizeof(event));
+}
+
+/**
+ * Record the selected items turned to face the other way
+ */
+void SessionRecorder::RecordMirror()
+{
+ auto event = Event::Mirror;
+ Write(&event, sizeof(event));
+}
+
+/**
+ * Record many items added at once
+ * @param type Type name of the items
+ * @param count Number of items added
+ * @param spread Where in the aquarium the items were put, an Aquarium::Spread
+ */
+void SessionRecorder::RecordBulk(const wxString &type, size_t count, uint8_t spread)
+{
+ auto event = Event::Bulk;
+ uint32_t number = uint32_t(count);
+ Write(&event, sizeof(event));
+ WriteString(type);
+ Write(&number, sizeof(number));
+ Write(&spread, sizeof(spread));
+}
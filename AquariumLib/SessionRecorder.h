@@ -0,0 +1,96 @@
+/**
+ * @file SessionRecorder.h
+ * @author Evan Gasper
+ *
+ * Records everything that changes the aquarium so it can be replayed
+ */
+
+#ifndef SESSIONRECORDER_H
+#define SESSIONRECORDER_H
+
+#include <cstdint>
+#include <wx/ffile.h>
+
+class Item;
+class wxXmlDocument;
+
+/**
+ * Records everything that changes the aquarium so it can be replayed.
+ *
+ * A session file starts with the seed of the aquarium random number
+ * generator and then holds one record per event, in the order they
+ * happened: each frame's elapsed time, items added, files loaded and
+ * the mouse grabbing, dragging and releasing items. SessionPlayer
+ * replays a session exactly, frame for frame.
+ *
+ * Numbers are stored in the byte order of the machine that made the
+ * recording, so recordings are replayed on the same kind of machine.
+ */
+class SessionRecorder {
+public:
+ /// Record types in a session file
+ enum class Event : char {
+  Frame = 'F',      ///< Elapsed time of one frame, double
+  Add = 'A',        ///< Item added, type name
+  Load = 'L',       ///< File loaded, filename and the items loaded as XML
+  Grab = 'G',       ///< Mouse pressed, int32 x and y
+  Drag = 'D',       ///< Grabbed item dragged, int32 x and y
+  Release = 'R',    ///< Grabbed item released
+  Resize = 'S',     ///< Aquarium size changed, int32 width and height
+  Schooling = 'B',  ///< Schooling turned on or off, one byte 1 or 0
+  Collisions = 'C', ///< Collisions turned on or off, one byte 1 or 0
+  Kinetic = 'K',    ///< Kinetic motion turned on or off, one byte 1 or 0
+  Select = 'E',     ///< Items in a rectangle selected, int32 x, y, width and height
+  SelectAll = 'W',  ///< Every item selected
+  Delete = 'X',     ///< Selected items removed
+  Front = 'T',      ///< Selected items moved in front of the others
+  Mirror = 'M',     ///< Selected items turned to face the other way
+  Bulk = 'N'        ///< Many items added, type name, uint32 count and one byte Aquarium::Spread
+ };
+
+private:
+ /// The session file
+ wxFFile mFile;
+
+ void Write(const void* data, size_t size);
+ void WriteString(const wxString& text);
+
+public:
+ SessionRecorder() = default;
+
+ /// Copy constructor (disabled)
+ SessionRecorder(const SessionRecorder &) = delete;
+
+ /// Assignment operator (disabled)
+ void operator=(const SessionRecorder &) = delete;
+
+ bool Open(const wxString& filename, uint32_t seed);
+
+ void RecordFrame(double elapsed);
+ void RecordAdd(Item* item);
+ void RecordLoad(const wxString& filename, const wxXmlDocument& xmlDoc);
+ void RecordGrab(int x, int y);
+ void RecordDrag(int x, int y);
+ void RecordRelease();
+ void RecordResize(const wxSize& size);
+ void RecordSchooling(bool schooling);
+ void RecordCollisions(bool collisions);
+ void RecordKinetic(bool kinetic);
+ void RecordSelect(const wxRect& rect);
+ void RecordSelectAll();
+ void RecordDelete();
+ void RecordFront();
+ void RecordMirror();
+ void RecordBulk(const wxString& type, size_t count, uint8_t spread);
+
+ /**
+  * Is a session being recorded?
+  * @return true if Open succeeded
+  */
+ bool IsOpen() const { return mFile.IsOpened(); }
+};
+
+/// First bytes of every session file, including the format version
+const char SessionMagic[] = {'A', 'Q', 'S', '2'};
+
+#endif //SESSIONRECORDER_H
@@ -0,0 +1,121 @@
+/**
+ * @file SpatialGrid.cpp
+ * @author Evan Gasper
+ */
+
+#include "pch.h"
+#include "SpatialGrid.h"
+#include <algorithm>
+
+using namespace std;
+
+/**
+ * Constructor
+ * @param cellSize Width and height of each cell in pixels
+ */
+SpatialGrid::SpatialGrid(int cellSize) : mCellSize(cellSize)
+{
+}
+
+/**
+ * Find the cells a rectangle overlaps.
+ *
+ * Anything outside the aquarium is counted as being in
+ * the nearest cell along the edge.
+ *
+ * @param rect Rectangle in pixels
+ * @param left Receives the first column
+ * @param top Receives the first row
+ * @param right Receives the last column
+ * @param bottom Receives the last row
+ */
+void SpatialGrid::CellRange(const wxRect &rect, int *left, int *top, int *right, int *bottom) const
+{
+ auto column = [this](int x) { return std::clamp(x / mCellSize, 0, mColumns - 1); };
+ auto row = [this](int y) { return std::clamp(y / mCellSize, 0, mRows - 1); };
+
+ *left = column(rect.GetLeft());
+ *top = row(rect.GetTop());
+ *right = column(rect.GetRight());
+ *bottom = row(rect.GetBottom());
+}
+
+/**
+ * Put items into the grid, replacing the ones already there
+ * @param bounds Bounds of each item, in drawing order
+ * @param size Size of the aquarium in pixels
+ */
+void SpatialGrid::Build(const std::vector<wxRect> &bounds, const wxSize &size)
+{
+ mColumns = std::max(1, (size.GetWidth() + mCellSize - 1) / mCellSize);
+ mRows = std::max(1, (size.GetHeight() + mCellSize - 1) / mCellSize);
+
+ // Keep the cell lists, so their memory is reused frame to frame
+ mCells.resize(size_t(mColumns) * mRows);
+ for (auto &cell : mCells)
+ {
+  cell.clear();
+ }
+
+ for (size_t i = 0; i < bounds.size(); i++)
+ {
+  int left, top, right, bottom;
+  CellRange(bounds[i], &left, &top, &right, &bottom);
+  for (int row = top; row <= bottom; row++)
+  {
+   for (int column = left; column <= right; column++)
+   {
+    mCells[row * mColumns + column].push_back(i);
+   }
+  }
+ }
+}
+
+/**
+ * Find the items that may overlap a rectangle.
+ *
+ * Items in the cells the rectangle overlaps are returned, so a
+ * few near the rectangle but not in it may be included.
+ *
+ * @param rect Rectangle in pixels
+ * @return Item numbers in increasing order, which is drawing order
+ */
+std::vector<size_t> SpatialGrid::Query(const wxRect &rect) const
+{
+ vector<size_t> items;
+ if (mCells.empty())
+ {
+  return items;
+ }
+
+ int left, top, right, bottom;
+ CellRange(rect, &left, &top, &right, &bottom);
+ for (int row = top; row <= bottom; row++)
+ {
+  for (int column = left; column <= right; column++)
+  {
+   auto &cell = mCells[row * mColumns + column];
+   items.insert(items.end(), cell.begin(), cell.end());
+  }
+ }
+
+ // Items overlapping several cells were found more than once
+ sort(items.begin(), items.end());
+ items.erase(unique(items.begin(), items.end()), items.end());
+ return items;
+}
+
+/**
+ * Get the memory the cell lists take up
+ * @return Size in bytes
+ */
+size_t SpatialGrid::GetMemory() const
+{
+ size_t bytes = mCells.capacity() * sizeof(mCells[0]);
+ for (auto &cell : mCells)
+ {
+  bytes += cell.capacity() * sizeof(size_t);
+ }
+
+ return bytes;
+}
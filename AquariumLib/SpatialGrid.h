@@ -0,0 +1,45 @@
+/**
+ * @file SpatialGrid.h
+ * @author Evan Gasper
+ *
+ * Finds the items in part of the aquarium without looking at all of them
+ */
+
+#ifndef SPATIALGRID_H
+#define SPATIALGRID_H
+
+#include <vector>
+
+/**
+ * Finds the items in part of the aquarium without looking at all of them.
+ *
+ * The aquarium is divided into square cells, and each cell lists the
+ * items whose bounds overlap it. A query only looks at the cells the
+ * query rectangle overlaps, so its cost depends on how many items are
+ * near the rectangle rather than on how many there are in total.
+ */
+class SpatialGrid {
+private:
+ /// Width and height of each cell in pixels
+ int mCellSize;
+
+ /// Number of columns of cells
+ int mColumns = 0;
+
+ /// Number of rows of cells
+ int mRows = 0;
+
+ /// Item numbers overlapping each cell, in increasing order
+ std::vector<std::vector<size_t>> mCells;
+
+ void CellRange(const wxRect& rect, int* left, int* top, int* right, int* bottom) const;
+
+public:
+ explicit SpatialGrid(int cellSize = 256);
+
+ void Build(const std::vector<wxRect>& bounds, const wxSize& size);
+ std::vector<size_t> Query(const wxRect& rect) const;
+ size_t GetMemory() const;
+};
+
+#endif //SPATIALGRID_H
@@ -0,0 +1,31 @@
+/**
+ * @file Species.cpp
+ * @author Evan Gasper
+ */
+
+#include "pch.h"
+#include "Species.h"
+#include "AssetProvider.h"
+
+/**
+ * Constructor. Use AssetProvider::GetSpecies rather
+ * than this, so items of a kind share their species.
+ * @param sprite The image items of this species draw
+ * @param schooling How the species schools, which must outlive it, or null
+ */
+Species::Species(std::shared_ptr<Sprite> sprite, const Schooling *schooling) :
+    mSprite(std::move(sprite)), mSchooling(schooling)
+{
+}
+
+/**
+ * Get the species for an image and way of schooling
+ * from the shared provider
+ * @param filename The image file items of the species draw
+ * @param schooling How the species schools, which must outlive it, or null
+ * @return The species, which is never deleted
+ */
+const Species *Species::Get(const std::wstring &filename, const Schooling *schooling)
+{
+ return AssetProvider::Shared()->GetSpecies(filename, schooling);
+}
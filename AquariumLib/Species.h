@@ -0,0 +1,66 @@
+/**
+ * @file Species.h
+ * @author Evan Gasper
+ *
+ * What every item using the same image has in common
+ */
+
+#ifndef SPECIES_H
+#define SPECIES_H
+
+#include "Sprite.h"
+
+/**
+ * What every item using the same image has in common.
+ *
+ * Items only hold what changes from one item to the next, like
+ * where they are and how fast they swim, and point to a species
+ * for the rest. Species are made by an asset provider the first
+ * time they are asked for and kept for as long as the provider is,
+ * so items can hold plain pointers to them.
+ */
+class Species {
+public:
+ /// How a species schools. Fish only align with and move
+ /// toward fish of their own species, but keep their
+ /// distance from every schooling fish.
+ struct Schooling {
+  double mSeparation;   ///< How hard fish turn away from fish too close, per second squared per pixel
+  double mAlignment;    ///< How fast fish match the speed of their neighbours, per second
+  double mCohesion;     ///< How hard fish are pulled toward their neighbours, per second squared
+  double mMinSpeed;     ///< Slowest speed while schooling, in pixels per second
+  double mMaxSpeed;     ///< Fastest speed while schooling, in pixels per second
+ };
+
+private:
+ /// The image, shared with other species using the same file
+ std::shared_ptr<Sprite> mSprite;
+
+ /// How the species schools, or null if it does not
+ const Schooling* mSchooling;
+
+public:
+ Species(std::shared_ptr<Sprite> sprite, const Schooling* schooling);
+
+ /// Copy constructor (disabled)
+ Species(const Species &) = delete;
+
+ /// Assignment operator (disabled)
+ void operator=(const Species &) = delete;
+
+ static const Species* Get(const std::wstring& filename, const Schooling* schooling = nullptr);
+
+ /**
+  * Get the image items of this species draw
+  * @return The sprite
+  */
+ Sprite* GetSprite() const { return mSprite.get(); }
+
+ /**
+  * Get how this species schools
+  * @return Schooling, or null if the species does not school
+  */
+ const Schooling* GetSchooling() const { return mSchooling; }
+};
+
+#endif //SPECIES_H
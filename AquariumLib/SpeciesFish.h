@@ -0,0 +1,67 @@
+/**
+ * @file SpeciesFish.h
+ * @author Evan Gasper
+ *
+ * A fish of one species, described by a traits struct
+ */
+
+#ifndef SPECIESFISH_H
+#define SPECIESFISH_H
+
+#include "Fish.h"
+#include "Aquarium.h"
+
+/**
+ * A fish of one species.
+ *
+ * Fish species only differ in constants, so each is a traits
+ * struct rather than a class of its own. The traits give:
+ *
+ *  - Type, the type name the fish is saved with
+ *  - ImageName, the image the fish is drawn with
+ *  - SpeedXMin, SpeedXMax, SpeedYMin and SpeedYMax, the range
+ *    new fish pick their speed from, in pixels per second
+ *  - Schooling, how the species schools, or null if it does not
+ *
+ * Everything a fish does each frame is in Fish, marked final,
+ * so the aquarium can step its fish without virtual calls.
+ *
+ * @tparam Traits The traits of the species
+ */
+template <class Traits>
+class SpeciesFish final : public Fish {
+public:
+ /// Default constructor (disabled)
+ SpeciesFish() = delete;
+
+ /// Copy constructor (disabled)
+ SpeciesFish(const SpeciesFish &) = delete;
+
+ /// Assignment operator (disabled)
+ void operator=(const SpeciesFish &) = delete;
+
+ /**
+  * Constructor
+  * @param aquarium Aquarium this fish is a member of
+  */
+ explicit SpeciesFish(Aquarium *aquarium) :
+  Fish(aquarium, aquarium->GetAssets().GetSpecies(Traits::ImageName, Traits::Schooling))
+ {
+  std::uniform_real_distribution<> distributionX(Traits::SpeedXMin, Traits::SpeedXMax);
+  SetSpeedX(distributionX(aquarium->GetRandom()));
+  std::uniform_real_distribution<> distributionY(Traits::SpeedYMin, Traits::SpeedYMax);
+  SetSpeedY(distributionY(aquarium->GetRandom()));
+ }
+
+ /**
+  * Copy the state of this fish
+  * @param state The state to fill in
+  */
+ void GetState(ItemState &state) const override
+ {
+  Fish::GetState(state);
+  state.mType = Traits::Type;
+ }
+};
+
+#endif //SPECIESFISH_H
@@ -0,0 +1,564 @@
+/**
+ * @file Sprite.cpp
+ * @author Evan Gasper
+ */
+
+#include "pch.h"
+#include "Sprite.h"
+#include "AssetProvider.h"
+#include <cmath>
+
+using namespace std;
+
+/**
+ * Constructor
+ *
+ * Gets the image size from the provider. Use Get or
+ * AssetProvider::GetSprite rather than this, so sprites
+ * are shared and decoded in the background.
+ *
+ * @param assets Where the image comes from
+ * @param filename The image name
+ */
+Sprite::Sprite(const std::shared_ptr<AssetProvider> &assets, const wxString &filename) :
+    mFilename(filename), mAssets(assets)
+{
+ mSize = assets->GetSize(mFilename);
+ if (mSize == wxDefaultSize)
+ {
+  // The size has to come from decoding it
+  Decode();
+  auto &image = mImages[0].front();
+  mSize = image.IsOk() ? image.GetSize() : wxSize(0, 0);
+ }
+}
+
+/**
+ * Get the sprite for an image file from the shared
+ * provider, which loads it from the asset bundle or the file.
+ *
+ * @param filename The image file
+ * @return The sprite, which may not be decoded yet
+ */
+std::shared_ptr<Sprite> Sprite::Get(const wxString &filename)
+{
+ return AssetProvider::Shared()->GetSprite(filename);
+}
+
+/**
+ * Decode the image, if it has not been decoded already.
+ *
+ * Images in the asset bundle are already decoded, so they only
+ * need the smaller levels and mirrored copies made. If another
+ * thread is decoding the image, this waits for that to finish.
+ */
+void Sprite::Decode()
+{
+ call_once(mDecodeOnce, [this]() {
+  // If the provider is gone the image is left not ok
+  wxImage image;
+  auto assets = mAssets.lock();
+  if (assets != nullptr)
+  {
+   image = assets->Load(mFilename);
+  }
+
+  auto &levels = mImages[0];
+  levels.push_back(image);
+  if (image.IsOk())
+  {
+   if (image.HasMask() && !image.HasAlpha())
+   {
+    // Downsampling needs to know which pixels are see through
+    levels.front().InitAlpha();
+   }
+
+   // Each level is made from the one before it, so the
+   // whole chain costs about a third of the full image
+   auto size = image.GetSize();
+   while (size.GetWidth() > 1 || size.GetHeight() > 1)
+   {
+    size = wxSize(max(1, size.GetWidth() / 2), max(1, size.GetHeight() / 2));
+    levels.push_back(Downsample(levels.back(), size));
+   }
+
+   mColour = AverageColour(levels.front());
+   MakeSolid();
+  }
+
+  for (auto &level : levels)
+  {
+   mImages[1].push_back(level.IsOk() ? level.Mirror() : level);
+  }
+
+  mReady = true;
+ });
+}
+
+/**
+ * Get the decoded image, decoding it now if it is not ready.
+ * @param mirror true for the image mirrored left to right
+ * @param level Level of detail, 0 for full size. Levels past
+ * the last one get the last one.
+ * @return The image
+ */
+const wxImage &Sprite::GetImage(bool mirror, int level)
+{
+ Decode();
+ auto &levels = mImages[mirror ? 1 : 0];
+ return levels[min(size_t(max(level, 0)), levels.size() - 1)];
+}
+
+/**
+ * Get a bitmap for drawing the image.
+ *
+ * Level 0 is the image itself. Each level after that is half the
+ * size of the one before, for drawing items smaller when there
+ * are too many to draw at full size, or when zoomed out.
+ *
+ * Bitmaps can only be created on the UI thread, so this
+ * must only be called from there.
+ *
+ * @param mirror true for the image mirrored left to right
+ * @param level Level of detail, 0 for full size. Levels past
+ * the last one get the last one.
+ * @return The bitmap, or null if the image is not decoded yet or failed to load
+ */
+wxBitmap *Sprite::GetBitmap(bool mirror, int level)
+{
+ if (!mReady || !mImages[0].front().IsOk())
+ {
+  return nullptr;
+ }
+
+ level = min(max(level, 0), GetLevels() - 1);
+ auto &bitmaps = mBitmaps[mirror ? 1 : 0];
+ if (bitmaps.size() <= size_t(level))
+ {
+  bitmaps.resize(level + 1);
+ }
+
+ auto &bitmap = bitmaps[level];
+ if (bitmap == nullptr)
+ {
+  bitmap = make_unique<wxBitmap>(mImages[mirror ? 1 : 0][level]);
+ }
+
+ return bitmap.get();
+}
+
+/**
+ * Get the size of the image at a level of detail
+ * @param level Level of detail, 0 for full size
+ * @return Size in pixels, halved for each level
+ */
+wxSize Sprite::GetSize(int level) const
+{
+ return wxSize(max(1, mSize.GetWidth() >> level), max(1, mSize.GetHeight() >> level));
+}
+
+/**
+ * Draw the image.
+ *
+ * The image is drawn at the size of a level of detail, in the
+ * coordinates of the device context. If the device context is
+ * scaled down, a smaller level that is closest to the size the
+ * image will be on screen is drawn instead, scaled up to match.
+ * That way zooming out does not shrink the full image every time
+ * it is drawn. Like GetBitmap, this must only be called from the
+ * UI thread.
+ *
+ * @param dc Device context to draw on
+ * @param x Left of the image
+ * @param y Top of the image
+ * @param mirror true to draw the image mirrored left to right
+ * @param level Level of detail that sets the size drawn at, 0 for full size
+ */
+void Sprite::Draw(wxDC *dc, int x, int y, bool mirror, int level)
+{
+ double scaleX, scaleY;
+ dc->GetUserScale(&scaleX, &scaleY);
+
+ auto bitmap = GetBitmap(mirror, level + LevelForScale(max(scaleX, scaleY)));
+ if (bitmap == nullptr)
+ {
+  // Still being decoded
+  return;
+ }
+
+ auto size = GetSize(level);
+ if (bitmap->GetWidth() == size.GetWidth() && bitmap->GetHeight() == size.GetHeight())
+ {
+  dc->DrawBitmap(*bitmap, x, y);
+  return;
+ }
+
+ // Scale the device context up by as much as the bitmap is
+ // smaller, so it covers the same part of the screen
+ double factorX = double(size.GetWidth()) / bitmap->GetWidth();
+ double factorY = double(size.GetHeight()) / bitmap->GetHeight();
+ wxCoord originX, originY;
+ dc->GetLogicalOrigin(&originX, &originY);
+
+ dc->SetUserScale(scaleX * factorX, scaleY * factorY);
+ dc->SetLogicalOrigin(int(lround(originX / factorX)), int(lround(originY / factorY)));
+ dc->DrawBitmap(*bitmap, int(lround(x / factorX)), int(lround(y / factorY)));
+
+ dc->SetUserScale(scaleX, scaleY);
+ dc->SetLogicalOrigin(originX, originY);
+}
+
+/**
+ * Is every pixel in a rectangle of the image opaque?
+ *
+ * The first call makes a table of opaque pixel counts, after which
+ * any rectangle is tested in constant time. Like GetBitmap, this
+ * must only be called from the UI thread.
+ *
+ * @param rect Rectangle relative to the top left of the image
+ * @param mirror true to test the image mirrored left to right
+ * @return true if the image is decoded and the rectangle is inside it and opaque
+ */
+bool Sprite::IsOpaque(const wxRect &rect, bool mirror)
+{
+ int width = mSize.GetWidth();
+ int height = mSize.GetHeight();
+ if (!mReady || !mImages[0].front().IsOk() || rect.IsEmpty() ||
+     rect.GetLeft() < 0 || rect.GetTop() < 0 ||
+     rect.GetRight() >= width || rect.GetBottom() >= height)
+ {
+  return false;
+ }
+
+ if (mOpaqueCounts.empty())
+ {
+  auto &image = mImages[0].front();
+  mOpaqueCounts.resize(size_t(width + 1) * (height + 1), 0);
+  auto alpha = image.GetAlpha();
+  for (int y = 0; y < height; y++)
+  {
+   unsigned row = 0;
+   for (int x = 0; x < width; x++)
+   {
+    bool opaque = alpha != nullptr ? alpha[y * width + x] == wxIMAGE_ALPHA_OPAQUE :
+            !image.IsTransparent(x, y);
+    row += opaque ? 1 : 0;
+    mOpaqueCounts[(y + 1) * (width + 1) + x + 1] = mOpaqueCounts[y * (width + 1) + x + 1] + row;
+   }
+  }
+ }
+
+ // The table is for the image as it was loaded
+ int left = mirror ? width - 1 - rect.GetRight() : rect.GetLeft();
+ int right = left + rect.GetWidth();
+ int top = rect.GetTop();
+ int bottom = top + rect.GetHeight();
+
+ auto count = [this, width](int x, int y) { return mOpaqueCounts[y * (width + 1) + x]; };
+ unsigned opaque = count(right, bottom) - count(left, bottom) - count(right, top) + count(left, top);
+ return opaque == unsigned(rect.GetWidth()) * unsigned(rect.GetHeight());
+}
+
+/**
+ * Make the bits saying which pixels of the image are solid,
+ * which are the ones HitTest would find
+ */
+void Sprite::MakeSolid()
+{
+ auto &image = mImages[0].front();
+ int width = image.GetWidth();
+ int height = image.GetHeight();
+ auto alpha = image.GetAlpha();
+
+ // The spare word lets Overlaps read 64 bits from anywhere in a row
+ mSolidWords = size_t(width + 63) / 64 + 1;
+ for (auto &solid : mSolid)
+ {
+  solid.assign(mSolidWords * height, 0);
+ }
+
+ for (int y = 0; y < height; y++)
+ {
+  auto row = &mSolid[0][y * mSolidWords];
+  auto mirrorRow = &mSolid[1][y * mSolidWords];
+  for (int x = 0; x < width; x++)
+  {
+   bool solid = alpha != nullptr ? alpha[size_t(y) * width + x] >= wxIMAGE_ALPHA_THRESHOLD :
+           !image.IsTransparent(x, y);
+   if (solid)
+   {
+    row[x / 64] |= uint64_t(1) << (x % 64);
+    int mirrorX = width - 1 - x;
+    mirrorRow[mirrorX / 64] |= uint64_t(1) << (mirrorX % 64);
+   }
+  }
+ }
+}
+
+/**
+ * Do the solid parts of two images overlap?
+ *
+ * Pixels are compared 64 at a time, so the cost depends on the
+ * size of the area the images share rather than on their sizes.
+ * Safe to call from any thread once both images are ready.
+ *
+ * @param at Top left of this image
+ * @param mirror true for this image mirrored left to right
+ * @param other The other image
+ * @param otherAt Top left of the other image
+ * @param otherMirror true for the other image mirrored left to right
+ * @param centre If not null, receives the centre of the overlapping pixels
+ * @return true if any solid pixel of one is on a solid pixel of the other.
+ * False if either image is not decoded yet.
+ */
+bool Sprite::Overlaps(const wxPoint &at, bool mirror, const Sprite &other, const wxPoint &otherAt,
+        bool otherMirror, wxRealPoint *centre) const
+{
+ if (!mReady || !other.mReady || mSolidWords == 0 || other.mSolidWords == 0)
+ {
+  return false;
+ }
+
+ auto area = wxRect(at, mSize).Intersect(wxRect(otherAt, other.mSize));
+ if (area.IsEmpty())
+ {
+  return false;
+ }
+
+ // 64 bits of a row, starting at any pixel
+ auto bits = [](const uint64_t *row, int start) {
+  auto word = row[start / 64] >> (start % 64);
+  if (start % 64 != 0)
+  {
+   word |= row[start / 64 + 1] << (64 - start % 64);
+  }
+  return word;
+ };
+
+ auto &solid = mSolid[mirror ? 1 : 0];
+ auto &otherSolid = other.mSolid[otherMirror ? 1 : 0];
+ double count = 0, sumX = 0, sumY = 0;
+ for (int y = area.GetTop(); y <= area.GetBottom(); y++)
+ {
+  auto row = &solid[(y - at.y) * mSolidWords];
+  auto otherRow = &otherSolid[(y - otherAt.y) * other.mSolidWords];
+  for (int x = area.GetLeft(); x <= area.GetRight(); x += 64)
+  {
+   auto both = bits(row, x - at.x) & bits(otherRow, x - otherAt.x);
+   int width = area.GetRight() - x + 1;
+   if (width < 64)
+   {
+    both &= (uint64_t(1) << width) - 1;
+   }
+
+   if (both == 0)
+   {
+    continue;
+   }
+
+   if (centre == nullptr)
+   {
+    return true;
+   }
+
+   for (int bit = 0; bit < 64; bit++)
+   {
+    if (both >> bit & 1)
+    {
+     count++;
+     sumX += x + bit;
+     sumY += y;
+    }
+   }
+  }
+ }
+
+ if (count == 0)
+ {
+  return false;
+ }
+
+ *centre = wxRealPoint(sumX / count + 0.5, sumY / count + 0.5);
+ return true;
+}
+
+/**
+ * Get a brush of the average colour of the image.
+ *
+ * Used to draw a rectangle standing in for the image. Like
+ * GetBitmap, this must only be called from the UI thread.
+ *
+ * @return The brush, or null if the image is not decoded yet or failed to load
+ */
+wxBrush *Sprite::GetBrush()
+{
+ if (!mReady || !mImages[0].front().IsOk())
+ {
+  return nullptr;
+ }
+
+ if (mBrush == nullptr)
+ {
+  mBrush = make_unique<wxBrush>(mColour);
+ }
+
+ return mBrush.get();
+}
+
+/**
+ * Get the memory the pixels of this sprite take up.
+ *
+ * Counts the decoded images at every level, the bitmaps made from
+ * them so far and the tables used to test for solid pixels. Like
+ * GetBitmap, this must only be called from the UI thread.
+ *
+ * @return Size in bytes, or zero if the image is not decoded yet
+ */
+size_t Sprite::GetMemory() const
+{
+ if (!mReady)
+ {
+  return 0;
+ }
+
+ size_t bytes = 0;
+ for (int mirror = 0; mirror < 2; mirror++)
+ {
+  for (auto &image : mImages[mirror])
+  {
+   // Three bytes of colour per pixel and one of alpha if it has any
+   size_t pixels = size_t(image.GetWidth()) * image.GetHeight();
+   bytes += pixels * (image.HasAlpha() ? 4 : 3);
+  }
+
+  for (auto &bitmap : mBitmaps[mirror])
+  {
+   if (bitmap != nullptr)
+   {
+    bytes += size_t(bitmap->GetWidth()) * bitmap->GetHeight() * 4;
+   }
+  }
+
+  bytes += mSolid[mirror].capacity() * sizeof(uint64_t);
+ }
+
+ return bytes + mOpaqueCounts.capacity() * sizeof(unsigned);
+}
+
+/**
+ * Find the average colour of an image, weighted by alpha
+ * @param image The image
+ * @return Average colour
+ */
+wxColour Sprite::AverageColour(const wxImage &image)
+{
+ auto rgb = image.GetData();
+ auto alpha = image.HasAlpha() ? image.GetAlpha() : nullptr;
+ size_t pixels = size_t(image.GetWidth()) * image.GetHeight();
+
+ double red = 0, green = 0, blue = 0, total = 0;
+ for (size_t i = 0; i < pixels; i++)
+ {
+  double weight = alpha != nullptr ? alpha[i] : 255;
+  red += rgb[i * 3] * weight;
+  green += rgb[i * 3 + 1] * weight;
+  blue += rgb[i * 3 + 2] * weight;
+  total += weight;
+ }
+
+ if (total == 0)
+ {
+  return *wxBLACK;
+ }
+
+ return wxColour((unsigned char)(red / total), (unsigned char)(green / total), (unsigned char)(blue / total));
+}
+
+/**
+ * Choose the level of detail to draw at a scale.
+ * @param scale How much the image is scaled when drawn, greater than 0
+ * @return The level whose size is closest to the scaled size
+ */
+int Sprite::LevelForScale(double scale)
+{
+ if (scale >= 1)
+ {
+  return 0;
+ }
+
+ return int(lround(log2(1 / scale)));
+}
+
+/**
+ * Shrink an image by averaging the pixels each new pixel covers.
+ *
+ * Colours are weighted by alpha, so the colour of see through
+ * pixels, which is never seen, does not darken the edges of the
+ * smaller image. The alpha is the plain average, so an edge that
+ * was half covered stays half covered.
+ *
+ * @param image The image to shrink
+ * @param size The size to shrink to, no larger than the image
+ * @return The smaller image
+ */
+wxImage Sprite::Downsample(const wxImage &image, const wxSize &size)
+{
+ int srcWidth = image.GetWidth();
+ int srcHeight = image.GetHeight();
+ auto srcRgb = image.GetData();
+ auto srcAlpha = image.HasAlpha() ? image.GetAlpha() : nullptr;
+
+ int width = size.GetWidth();
+ int height = size.GetHeight();
+ wxImage result(width, height, false);
+ if (srcAlpha != nullptr)
+ {
+  result.InitAlpha();
+ }
+
+ auto rgb = result.GetData();
+ auto alpha = result.GetAlpha();
+ for (int y = 0; y < height; y++)
+ {
+  int top = y * srcHeight / height;
+  int bottom = (y + 1) * srcHeight / height;
+  for (int x = 0; x < width; x++)
+  {
+   int left = x * srcWidth / width;
+   int right = (x + 1) * srcWidth / width;
+
+   double red = 0, green = 0, blue = 0, total = 0;
+   for (int sy = top; sy < bottom; sy++)
+   {
+    for (int sx = left; sx < right; sx++)
+    {
+     size_t i = size_t(sy) * srcWidth + sx;
+     double weight = srcAlpha != nullptr ? srcAlpha[i] : 255;
+     red += srcRgb[i * 3] * weight;
+     green += srcRgb[i * 3 + 1] * weight;
+     blue += srcRgb[i * 3 + 2] * weight;
+     total += weight;
+    }
+   }
+
+   size_t i = size_t(y) * width + x;
+   if (total > 0)
+   {
+    rgb[i * 3] = (unsigned char)lround(red / total);
+    rgb[i * 3 + 1] = (unsigned char)lround(green / total);
+    rgb[i * 3 + 2] = (unsigned char)lround(blue / total);
+   }
+   else
+   {
+    rgb[i * 3] = rgb[i * 3 + 1] = rgb[i * 3 + 2] = 0;
+   }
+
+   if (alpha != nullptr)
+   {
+    alpha[i] = (unsigned char)lround(total / ((bottom - top) * (right - left)));
+   }
+  }
+ }
+
+ return result;
+}
@@ -0,0 +1,128 @@
+/**
+ * @file Sprite.h
+ * @author Evan Gasper
+ *
+ * An image drawn by items, decoded in the background
+ */
+
+#ifndef SPRITE_H
+#define SPRITE_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class AssetProvider;
+
+/**
+ * An image drawn by items, decoded in the background.
+ *
+ * Sprites are shared by every item that uses the same image file,
+ * so each file is decoded once. They are made and shared by an
+ * asset provider, which the image comes from. The size is known
+ * right away, but the pixels are decoded by the worker pool.
+ * Items draw nothing until their sprite is ready.
+ */
+class Sprite {
+private:
+ /// The image name
+ wxString mFilename;
+
+ /// Where the image comes from. Not kept alive by the sprite,
+ /// since the provider keeps its sprites alive.
+ std::weak_ptr<AssetProvider> mAssets;
+
+ /// Size of the image in pixels
+ wxSize mSize;
+
+ /// Makes sure the image is decoded exactly once
+ std::once_flag mDecodeOnce;
+
+ /// Set once the image has been decoded
+ std::atomic<bool> mReady{false};
+
+ /// The decoded image at each level, each half the size of the
+ /// one before, down to a single pixel. The first list is the
+ /// image as loaded and the second is mirrored left to right.
+ std::vector<wxImage> mImages[2];
+
+ /// Average colour of the image, weighted by alpha
+ wxColour mColour;
+
+ /// Bitmaps for drawing, indexed by level like mImages,
+ /// created the first time each level is drawn
+ std::vector<std::unique_ptr<wxBitmap>> mBitmaps[2];
+
+ /// Brush of mColour, created on first use
+ std::unique_ptr<wxBrush> mBrush;
+
+ /// One bit per pixel, set where the image is solid, in rows of
+ /// mSolidWords words. The first is the image as loaded and the
+ /// second is mirrored left to right.
+ std::vector<uint64_t> mSolid[2];
+
+ /// Words in each row of mSolid, including a spare one at the end
+ size_t mSolidWords = 0;
+
+ /// Number of opaque pixels above and left of each pixel, in a
+ /// table one larger than the image each way. Created on first use.
+ std::vector<unsigned> mOpaqueCounts;
+
+ void MakeSolid();
+ static wxColour AverageColour(const wxImage& image);
+
+public:
+ Sprite(const std::shared_ptr<AssetProvider>& assets, const wxString& filename);
+
+ /// Copy constructor (disabled)
+ Sprite(const Sprite &) = delete;
+
+ /// Assignment operator (disabled)
+ void operator=(const Sprite &) = delete;
+
+ static std::shared_ptr<Sprite> Get(const wxString& filename);
+
+ void Decode();
+ const wxImage& GetImage(bool mirror = false, int level = 0);
+ wxBitmap* GetBitmap(bool mirror = false, int level = 0);
+ wxSize GetSize(int level) const;
+ void Draw(wxDC* dc, int x, int y, bool mirror = false, int level = 0);
+ bool IsOpaque(const wxRect& rect, bool mirror = false);
+ bool Overlaps(const wxPoint& at, bool mirror, const Sprite& other, const wxPoint& otherAt,
+         bool otherMirror, wxRealPoint* centre = nullptr) const;
+ wxBrush* GetBrush();
+ size_t GetMemory() const;
+
+ static int LevelForScale(double scale);
+ static wxImage Downsample(const wxImage& image, const wxSize& size);
+
+ /**
+  * Get the size of the image. Known before the image is decoded.
+  * @return Size in pixels
+  */
+ const wxSize& GetSize() const { return mSize; }
+
+ /**
+  * Has the image been decoded?
+  * @return true if GetBitmap will not return null
+  */
+ bool IsReady() const { return mReady; }
+
+ /**
+  * Get the average colour of the image, weighted by alpha.
+  * Only valid once the image is ready.
+  * @return Colour to draw stand ins for the image with
+  */
+ const wxColour& GetColour() const { return mColour; }
+
+ /**
+  * Get the number of levels the image has.
+  * Only valid once the image is ready.
+  * @return Number of levels, including the full size image
+  */
+ int GetLevels() const { return int(mImages[0].size()); }
+};
+
+#endif //SPRITE_H
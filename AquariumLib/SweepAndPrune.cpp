@@ -0,0 +1,76 @@
+/**
+ * @file SweepAndPrune.cpp
+ * @author Evan Gasper
+ */
+
+#include "pch.h"
+#include "SweepAndPrune.h"
+#include <algorithm>
+#include <numeric>
+
+using namespace std;
+
+/**
+ * Find the pairs of rectangles that overlap
+ * @param rects The rectangles. Empty rectangles overlap nothing.
+ * @return Pairs of rectangle numbers, the smaller number first, in
+ * increasing order. Valid until the next call.
+ */
+const std::vector<std::pair<size_t, size_t>> &SweepAndPrune::FindPairs(const std::vector<wxRect> &rects)
+{
+ if (mOrder.size() != rects.size())
+ {
+  // Items were added or removed, so start over
+  mOrder.resize(rects.size());
+  iota(mOrder.begin(), mOrder.end(), 0);
+ }
+
+ for (size_t i = 1; i < mOrder.size(); i++)
+ {
+  auto number = mOrder[i];
+  int left = rects[number].GetLeft();
+  size_t j = i;
+  for (; j > 0 && rects[mOrder[j - 1]].GetLeft() > left; j--)
+  {
+   mOrder[j] = mOrder[j - 1];
+  }
+  mOrder[j] = number;
+ }
+
+ mPairs.clear();
+ mActive.clear();
+ for (auto number : mOrder)
+ {
+  auto &rect = rects[number];
+  if (rect.IsEmpty())
+  {
+   continue;
+  }
+
+  // Drop the rectangles the sweep has passed the right edge of
+  for (size_t i = 0; i < mActive.size();)
+  {
+   if (rects[mActive[i]].GetRight() < rect.GetLeft())
+   {
+    mActive[i] = mActive.back();
+    mActive.pop_back();
+   }
+   else
+   {
+    auto &other = rects[mActive[i]];
+    if (other.GetTop() <= rect.GetBottom() && rect.GetTop() <= other.GetBottom())
+    {
+     mPairs.emplace_back(min(number, mActive[i]), max(number, mActive[i]));
+    }
+    i++;
+   }
+  }
+
+  mActive.push_back(number);
+ }
+
+ // The same pairs come out in the same order however the
+ // rectangles were sorted before, so collisions replay exactly
+ sort(mPairs.begin(), mPairs.end());
+ return mPairs;
+}
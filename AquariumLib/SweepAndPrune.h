@@ -0,0 +1,53 @@
+/**
+ * @file SweepAndPrune.h
+ * @author Evan Gasper
+ *
+ * Finds the pairs of rectangles that overlap
+ */
+
+#ifndef SWEEPANDPRUNE_H
+#define SWEEPANDPRUNE_H
+
+#include <vector>
+#include <utility>
+
+/**
+ * Finds the pairs of rectangles that overlap.
+ *
+ * The rectangles are sorted by their left edges and swept from left
+ * to right, keeping a list of the ones the sweep is inside of. Only
+ * rectangles in that list are compared, so the cost is close to the
+ * number of rectangles plus the number that overlap left to right.
+ *
+ * The order is kept between calls. Items only move a little each
+ * step, so it is nearly sorted already and an insertion sort puts
+ * it right in close to linear time.
+ */
+class SweepAndPrune {
+private:
+ /// Rectangle numbers, sorted by left edge as of the last call
+ std::vector<size_t> mOrder;
+
+ /// Rectangles the sweep is inside of
+ std::vector<size_t> mActive;
+
+ /// Overlapping pairs found by the last call
+ std::vector<std::pair<size_t, size_t>> mPairs;
+
+public:
+ SweepAndPrune() = default;
+
+ const std::vector<std::pair<size_t, size_t>>& FindPairs(const std::vector<wxRect>& rects);
+
+ /**
+  * Get the memory the lists kept between calls take up
+  * @return Size in bytes
+  */
+ size_t GetMemory() const
+ {
+  return (mOrder.capacity() + mActive.capacity()) * sizeof(size_t) +
+         mPairs.capacity() * sizeof(mPairs[0]);
+ }
+};
+
+#endif //SWEEPANDPRUNE_H
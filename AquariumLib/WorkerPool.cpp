@@ -0,0 +1,165 @@
+/**
+ * @file WorkerPool.cpp
+ * @author Evan Gasper
+ */
+
+#include "pch.h"
+#include "WorkerPool.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+/**
+ * Constructor
+ * @param threads Number of worker threads, or 0 for one per core
+ */
+WorkerPool::WorkerPool(size_t threads)
+{
+ if (threads == 0)
+ {
+  threads = std::max(1u, std::thread::hardware_concurrency());
+ }
+
+ for (size_t i = 0; i < threads; i++)
+ {
+  mThreads.emplace_back(&WorkerPool::Worker, this);
+ }
+}
+
+/**
+ * Destructor
+ *
+ * Lets the workers finish the tasks already queued, then joins them.
+ */
+WorkerPool::~WorkerPool()
+{
+ {
+  std::lock_guard<std::mutex> lock(mMutex);
+  mStopping = true;
+ }
+
+ mCondition.notify_all();
+ for (auto &thread : mThreads)
+ {
+  thread.join();
+ }
+}
+
+/**
+ * Get the pool shared by the whole program
+ * @return The shared pool, with one thread per core
+ */
+WorkerPool &WorkerPool::Shared()
+{
+ static WorkerPool pool;
+ return pool;
+}
+
+/**
+ * Queue a task to run on a worker thread
+ * @param task The task to run
+ */
+void WorkerPool::Submit(std::function<void()> task)
+{
+ {
+  std::lock_guard<std::mutex> lock(mMutex);
+  mTasks.push_back(std::move(task));
+ }
+
+ mCondition.notify_one();
+}
+
+/**
+ * Run numbered tasks in parallel and wait for all of them.
+ *
+ * Tasks 0 to count-1 are handed out in order to the workers and
+ * to the calling thread, which works too rather than just waiting.
+ * Once the caller runs out of tasks it only waits for helpers that
+ * are in the middle of a task. Helpers still queued find nothing
+ * left to do, so this is safe to call from a worker, even when
+ * every other worker is busy.
+ *
+ * @param count Number of tasks
+ * @param task Function called with each task number
+ */
+void WorkerPool::Run(size_t count, const std::function<void(size_t)> &task)
+{
+ if (count == 0)
+ {
+  return;
+ }
+
+ /// Shared between the caller and the helpers it queues
+ struct State {
+  std::atomic<size_t> mNext{0};     ///< Next task number to hand out
+  size_t mWorking = 0;              ///< Helpers that started and are not yet finished
+  bool mClosed = false;             ///< Set once the caller is out of tasks, so helpers not started yet do nothing
+  std::mutex mMutex;                ///< Protects mWorking and mClosed
+  std::condition_variable mDone;    ///< Signalled when a helper finishes
+ };
+
+ auto state = std::make_shared<State>();
+
+ // The caller takes one share of the work itself
+ auto helpers = std::min(count - 1, mThreads.size());
+ for (size_t i = 0; i < helpers; i++)
+ {
+  // The helper only has the task while the caller is still
+  // waiting, so it checks in before touching it
+  Submit([state, count, &task]() {
+   {
+    std::lock_guard<std::mutex> lock(state->mMutex);
+    if (state->mClosed || state->mNext >= count)
+    {
+     return;
+    }
+
+    state->mWorking++;
+   }
+
+   for (size_t i; (i = state->mNext++) < count; )
+   {
+    task(i);
+   }
+
+   std::lock_guard<std::mutex> lock(state->mMutex);
+   if (--state->mWorking == 0)
+   {
+    state->mDone.notify_all();
+   }
+  });
+ }
+
+ for (size_t i; (i = state->mNext++) < count; )
+ {
+  task(i);
+ }
+
+ std::unique_lock<std::mutex> lock(state->mMutex);
+ state->mClosed = true;
+ state->mDone.wait(lock, [&state]() { return state->mWorking == 0; });
+}
+
+/**
+ * Thread function for each worker
+ */
+void WorkerPool::Worker()
+{
+ for (;;)
+ {
+  std::function<void()> task;
+  {
+   std::unique_lock<std::mutex> lock(mMutex);
+   mCondition.wait(lock, [this]() { return mStopping || !mTasks.empty(); });
+   if (mTasks.empty())
+   {
+    return;
+   }
+
+   task = std::move(mTasks.front());
+   mTasks.pop_front();
+  }
+
+  task();
+ }
+}
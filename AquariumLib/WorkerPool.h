@@ -0,0 +1,66 @@
+/**
+ * @file WorkerPool.h
+ * @author Evan Gasper
+ *
+ * A fixed set of worker threads that run tasks in the background
+ */
+
+#ifndef WORKERPOOL_H
+#define WORKERPOOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * A fixed set of worker threads that run tasks in the background.
+ *
+ * Submit queues a task and returns right away. Run splits work
+ * into numbered tasks, runs them across the workers and the
+ * calling thread, and returns once all of them are done.
+ */
+class WorkerPool {
+private:
+ /// The worker threads
+ std::vector<std::thread> mThreads;
+
+ /// Tasks waiting for a worker
+ std::deque<std::function<void()>> mTasks;
+
+ /// Protects mTasks and mStopping
+ std::mutex mMutex;
+
+ /// Signalled when a task is queued or the pool is stopping
+ std::condition_variable mCondition;
+
+ /// Set when the pool is being destroyed
+ bool mStopping = false;
+
+ void Worker();
+
+public:
+ explicit WorkerPool(size_t threads = 0);
+ ~WorkerPool();
+
+ /// Copy constructor (disabled)
+ WorkerPool(const WorkerPool &) = delete;
+
+ /// Assignment operator (disabled)
+ void operator=(const WorkerPool &) = delete;
+
+ static WorkerPool &Shared();
+
+ void Submit(std::function<void()> task);
+ void Run(size_t count, const std::function<void(size_t)> &task);
+
+ /**
+  * Get the number of worker threads
+  * @return Number of threads
+  */
+ size_t GetSize() const { return mThreads.size(); }
+};
+
+#endif //WORKERPOOL_H
@@ -0,0 +1,208 @@
+/**
+ * @file WorldExport.cpp
+ * @author Evan Gasper
+ */
+
+#include "pch.h"
+#include "WorldExport.h"
+#include <cstring>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+/**
+ * Destructor
+ */
+WorldExport::~WorldExport()
+{
+ Close();
+}
+
+/**
+ * Create the shared memory to publish into.
+ *
+ * Shared memory left by an export that did not close is replaced.
+ * Only POSIX shared memory is supported, so this always fails on
+ * Windows.
+ *
+ * @param name Name of the shared memory, which readers open by
+ * @param capacity Most items that are published in each frame
+ * @param slots Number of frames kept in the ring, at least 2
+ * @return true if the shared memory was created
+ */
+bool WorldExport::Open(const std::string &name, uint32_t capacity, uint32_t slots)
+{
+ Close();
+
+#ifdef _WIN32
+ return false;
+#else
+ // Portable shared memory names start with a slash
+ mName = name.empty() || name[0] != '/' ? "/" + name : name;
+ slots = max(slots, 2u);
+ auto size = WorldSlotsOffset + slots * WorldSlotSize(capacity);
+
+ shm_unlink(mName.c_str());
+ // Readers write the count of polls, so only this user can read
+ int fd = shm_open(mName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+ if (fd < 0)
+ {
+  return false;
+ }
+
+ void *memory = MAP_FAILED;
+ if (ftruncate(fd, off_t(size)) == 0)
+ {
+  memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+ }
+
+ close(fd);
+ if (memory == MAP_FAILED)
+ {
+  shm_unlink(mName.c_str());
+  return false;
+ }
+
+ // New shared memory is all zeros, so readers see no frames
+ // and no magic number until the header is filled in
+ mMemory = static_cast<char *>(memory);
+ mSize = size;
+ mSequence = 0;
+ mPolls = 0;
+ mIdle = 0;
+
+ auto header = GetHeader();
+ header->mVersion = WorldVersion;
+ header->mSlots = slots;
+ header->mCapacity = capacity;
+ header->mSlotSize = WorldSlotSize(capacity);
+ atomic_thread_fence(memory_order_release);
+ header->mMagic = WorldMagic;
+ return true;
+#endif
+}
+
+/**
+ * Remove the shared memory. Readers that have it
+ * open can keep reading the last frames.
+ */
+void WorldExport::Close()
+{
+#ifndef _WIN32
+ if (mMemory != nullptr)
+ {
+  munmap(mMemory, mSize);
+  shm_unlink(mName.c_str());
+ }
+#endif
+
+ mMemory = nullptr;
+ mSize = 0;
+}
+
+/**
+ * Is anyone reading the frames?
+ *
+ * Call this once a frame, and only build and publish the frame if
+ * it returns true. Frames go on being published for IdleFrames
+ * calls after a reader last looked for the latest one, so readers
+ * that poll now and then still see new frames.
+ *
+ * @return true if the frame should be published
+ */
+bool WorldExport::IsWanted()
+{
+ if (mMemory == nullptr)
+ {
+  return false;
+ }
+
+ auto polls = GetHeader()->mPolls.load(memory_order_relaxed);
+ if (polls != mPolls)
+ {
+  mPolls = polls;
+  mIdle = 0;
+ }
+
+ return mIdle++ < IdleFrames;
+}
+
+/**
+ * Publish a frame.
+ *
+ * The frame goes into the next slot of the ring. Its sequence
+ * number is odd while it is written, so readers skip it until
+ * it is done. Items that do not fit are left out, but the total
+ * is still published so readers can tell.
+ *
+ * @param items State of each item in drawing order, from Aquarium::Snapshot
+ * @param time Simulated time of the frame in seconds
+ */
+void WorldExport::Publish(const std::vector<ItemState> &items, double time)
+{
+ if (mMemory == nullptr)
+ {
+  return;
+ }
+
+ auto header = GetHeader();
+ auto sequence = ++mSequence;
+ auto slot = mMemory + WorldSlotsOffset + (sequence % header->mSlots) * header->mSlotSize;
+ auto frame = reinterpret_cast<WorldFrame *>(slot);
+ auto exported = reinterpret_cast<WorldItem *>(slot + sizeof(WorldFrame));
+
+ frame->mSequence.store(sequence * 2 - 1, memory_order_relaxed);
+ atomic_thread_fence(memory_order_release);
+
+ auto count = uint32_t(min<size_t>(items.size(), header->mCapacity));
+ for (uint32_t i = 0; i < count; i++)
+ {
+  auto &item = exported[i];
+  item.mType = TypeOf(items[i].mType);
+  item.mZ = i;
+  item.mX = items[i].mX;
+  item.mY = items[i].mY;
+  item.mMirror = items[i].mMirror ? 1 : 0;
+  item.mReserved = 0;
+ }
+
+ frame->mTime = time;
+ frame->mCount = count;
+ frame->mTotal = uint32_t(items.size());
+
+ frame->mSequence.store(sequence * 2, memory_order_release);
+ header->mLatest.store(sequence, memory_order_release);
+}
+
+/**
+ * Get the exported type of an item
+ * @param type Type name saved in the file, as in ItemState
+ * @return The exported type
+ */
+WorldType WorldExport::TypeOf(const wchar_t *type)
+{
+ /// Exported type of each type name
+ static const pair<const wchar_t *, WorldType> types[] = {
+         {L"beta", WorldType::Beta},
+         {L"dova", WorldType::Dova},
+         {L"chest", WorldType::Chest},
+         {L"castle", WorldType::Castle}};
+
+ if (type != nullptr)
+ {
+  for (auto &known : types)
+  {
+   if (wcscmp(known.first, type) == 0)
+   {
+    return known.second;
+   }
+  }
+ }
+
+ return WorldType::Unknown;
+}
@@ -0,0 +1,91 @@
+/**
+ * @file WorldExport.h
+ * @author Evan Gasper
+ *
+ * Publishes each frame of an aquarium into shared memory
+ */
+
+#ifndef WORLDEXPORT_H
+#define WORLDEXPORT_H
+
+#include <string>
+#include <vector>
+#include "WorldLayout.h"
+#include "ItemState.h"
+
+/**
+ * Publishes each frame of an aquarium into shared memory.
+ *
+ * Other programs, such as a second renderer or a monitoring tool,
+ * read the frames with WorldReader without anything being written
+ * to a file. See WorldLayout.h for how the memory is laid out.
+ *
+ * Only one thread may publish at a time. The shared memory is
+ * removed when the export is closed.
+ */
+class WorldExport {
+private:
+ /// Name of the shared memory
+ std::string mName;
+
+ /// The shared memory, or null if not open
+ char* mMemory = nullptr;
+
+ /// Size of the shared memory in bytes
+ size_t mSize = 0;
+
+ /// Number of the last frame published
+ uint64_t mSequence = 0;
+
+ /// Reader polls counted in the header when last checked
+ uint64_t mPolls = 0;
+
+ /// Frames asked about since a reader last looked
+ uint32_t mIdle = 0;
+
+ /**
+  * Get the header at the start of the shared memory
+  * @return The header
+  */
+ WorldHeader* GetHeader() const { return reinterpret_cast<WorldHeader*>(mMemory); }
+
+public:
+ /// Slots in the ring unless asked otherwise
+ static const uint32_t DefaultSlots = 4;
+
+ /// Items in each frame unless asked otherwise
+ static const uint32_t DefaultCapacity = 65536;
+
+ /// Frames published after a reader last looked, about three seconds
+ static const uint32_t IdleFrames = 100;
+
+ WorldExport() = default;
+ ~WorldExport();
+
+ /// Copy constructor (disabled)
+ WorldExport(const WorldExport &) = delete;
+
+ /// Assignment operator (disabled)
+ void operator=(const WorldExport &) = delete;
+
+ bool Open(const std::string& name, uint32_t capacity = DefaultCapacity, uint32_t slots = DefaultSlots);
+ void Close();
+ bool IsWanted();
+ void Publish(const std::vector<ItemState>& items, double time);
+
+ /**
+  * Is the shared memory open?
+  * @return true if frames can be published
+  */
+ bool IsOpen() const { return mMemory != nullptr; }
+
+ /**
+  * Get the number of the last frame published
+  * @return Frame number, from 1, or 0 if none has been
+  */
+ uint64_t GetSequence() const { return mSequence; }
+
+ static WorldType TypeOf(const wchar_t* type);
+};
+
+#endif //WORLDEXPORT_H
@@ -0,0 +1,105 @@
+/**
+ * @file WorldLayout.h
+ * @author Evan Gasper
+ *
+ * Layout of the aquarium world exported into shared memory
+ */
+
+#ifndef WORLDLAYOUT_H
+#define WORLDLAYOUT_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Layout of the aquarium world exported into shared memory.
+ *
+ * This is shared by WorldExport, which writes it, and WorldReader,
+ * which other programs use to read it. It does not use wxWidgets.
+ *
+ * The memory starts with a WorldHeader, followed by a ring of
+ * slots. Each slot is a WorldFrame followed by room for the items
+ * of one frame. Frame n is written to slot n modulo the number of
+ * slots, so readers can keep reading a frame while the next few
+ * are written.
+ *
+ * Each slot has a sequence number that is odd while the frame in
+ * it is being written and twice the frame number once it is done.
+ * Readers check it before and after reading, so they never need a
+ * lock and never see a frame that is half written.
+ *
+ * Readers count each time they look for the latest frame in the
+ * header, the only thing they write. The export stops publishing
+ * once nobody has looked for a while, since building a frame
+ * means working out where every item is.
+ */
+
+/// Identifies shared memory holding an aquarium world
+const uint32_t WorldMagic = 0x31575141;
+
+/// Version of this layout
+const uint32_t WorldVersion = 2;
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+        "Sequence numbers must be lock free to be shared between processes");
+
+/// The type of an item, as exported
+enum class WorldType : uint32_t {
+ Unknown = 0,   ///< Not a type the export knows
+ Beta = 1,      ///< Beta fish
+ Dova = 2,      ///< Dovahfin
+ Chest = 3,     ///< Chest
+ Castle = 4     ///< Castle decor
+};
+
+/// One item in an exported frame
+struct WorldItem {
+ WorldType mType;   ///< Type of the item
+ uint32_t mZ;       ///< Drawing order, from 0 at the back
+ double mX;         ///< X location of the centre in aquarium pixels
+ double mY;         ///< Y location of the centre in aquarium pixels
+ uint32_t mMirror;  ///< 1 if the image is drawn mirrored
+ uint32_t mReserved; ///< Always 0
+};
+
+/// The start of each slot, followed by its items
+struct WorldFrame {
+ /// Odd while the frame is being written, then twice the frame number
+ std::atomic<uint64_t> mSequence;
+ double mTime;      ///< Simulated time of the frame in seconds
+ uint32_t mCount;   ///< Number of items in the slot
+ uint32_t mTotal;   ///< Number of items in the aquarium, which may not all fit
+};
+
+/// The start of the shared memory
+struct WorldHeader {
+ uint32_t mMagic;      ///< WorldMagic once the memory is set up
+ uint32_t mVersion;    ///< WorldVersion
+ uint32_t mSlots;      ///< Number of slots in the ring
+ uint32_t mCapacity;   ///< Items that fit in each slot
+ uint64_t mSlotSize;   ///< Bytes in each slot, including its WorldFrame
+
+ /// Number of the last frame written, or 0 if none has been
+ std::atomic<uint64_t> mLatest;
+
+ /// Number of times readers have looked for the latest frame
+ std::atomic<uint64_t> mPolls;
+};
+
+/// Bytes from the start of the memory to the first slot
+const size_t WorldSlotsOffset = 64;
+
+static_assert(sizeof(WorldHeader) <= WorldSlotsOffset, "The header must fit before the slots");
+
+/**
+ * Get the size of one slot
+ * @param capacity Items that fit in the slot
+ * @return Size in bytes, a multiple of 8
+ */
+inline size_t WorldSlotSize(uint32_t capacity)
+{
+ return sizeof(WorldFrame) + capacity * sizeof(WorldItem);
+}
+
+#endif //WORLDLAYOUT_H
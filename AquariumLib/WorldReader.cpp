@@ -0,0 +1,200 @@
+/**
+ * @file WorldReader.cpp
+ * @author Evan Gasper
+ *
+ * Built into a library of its own for other programs, so
+ * this does not use the precompiled wxWidgets header.
+ */
+
+#include "WorldReader.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+/**
+ * Destructor
+ */
+WorldReader::~WorldReader()
+{
+ Close();
+}
+
+/**
+ * Open shared memory an aquarium exports into.
+ *
+ * This fails if the export has not set the memory up yet,
+ * so readers started first should try again. Readers must run
+ * as the same user as the export.
+ *
+ * @param name Name the export was opened with
+ * @return true if the shared memory holds an aquarium world
+ */
+bool WorldReader::Open(const std::string &name)
+{
+ Close();
+
+#ifdef _WIN32
+ return false;
+#else
+ auto shared = name.empty() || name[0] != '/' ? "/" + name : name;
+ int fd = shm_open(shared.c_str(), O_RDWR, 0);
+ if (fd < 0)
+ {
+  return false;
+ }
+
+ struct stat status;
+ void *memory = MAP_FAILED;
+ if (fstat(fd, &status) == 0 && size_t(status.st_size) >= WorldSlotsOffset)
+ {
+  memory = mmap(nullptr, size_t(status.st_size), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+ }
+
+ close(fd);
+ if (memory == MAP_FAILED)
+ {
+  return false;
+ }
+
+ mMemory = static_cast<char *>(memory);
+ mSize = size_t(status.st_size);
+
+ // The magic number is written last, so once it is there
+ // the rest of the header can be trusted
+ auto header = GetHeader();
+ bool ready = header->mMagic == WorldMagic;
+ atomic_thread_fence(memory_order_acquire);
+ if (!ready || header->mVersion != WorldVersion || header->mSlots == 0 ||
+     header->mSlotSize != WorldSlotSize(header->mCapacity) ||
+     WorldSlotsOffset + header->mSlots * header->mSlotSize > mSize)
+ {
+  Close();
+  return false;
+ }
+
+ return true;
+#endif
+}
+
+/**
+ * Stop reading the shared memory
+ */
+void WorldReader::Close()
+{
+#ifndef _WIN32
+ if (mMemory != nullptr)
+ {
+  munmap(mMemory, mSize);
+ }
+#endif
+
+ mMemory = nullptr;
+ mSize = 0;
+}
+
+/**
+ * Get the slot a frame is written to
+ * @param sequence Number of the frame
+ * @return The start of the slot
+ */
+const WorldFrame *WorldReader::GetSlot(uint64_t sequence) const
+{
+ auto header = GetHeader();
+ return reinterpret_cast<const WorldFrame *>(mMemory + WorldSlotsOffset +
+         (sequence % header->mSlots) * header->mSlotSize);
+}
+
+/**
+ * Get the number of the last frame published.
+ *
+ * This tells the export someone is reading, so it keeps
+ * publishing. It stops once nobody has asked for a while.
+ *
+ * @return Frame number, from 1, or 0 if none has been
+ */
+uint64_t WorldReader::GetLatest() const
+{
+ if (mMemory == nullptr)
+ {
+  return 0;
+ }
+
+ reinterpret_cast<WorldHeader *>(mMemory)->mPolls.fetch_add(1, memory_order_relaxed);
+ return GetHeader()->mLatest.load(memory_order_acquire);
+}
+
+/**
+ * Read a frame.
+ *
+ * The frame points into the shared memory. Call IsValid once
+ * done with it, since the export may have overwritten it.
+ *
+ * @param sequence Number of the frame to read
+ * @param frame Frame to fill in
+ * @return false if the frame is not in the ring, or is being written
+ */
+bool WorldReader::Read(uint64_t sequence, Frame &frame) const
+{
+ if (mMemory == nullptr || sequence == 0)
+ {
+  return false;
+ }
+
+ auto slot = GetSlot(sequence);
+ if (slot->mSequence.load(memory_order_acquire) != sequence * 2)
+ {
+  return false;
+ }
+
+ frame.mSequence = sequence;
+ frame.mTime = slot->mTime;
+ frame.mCount = slot->mCount;
+ frame.mTotal = slot->mTotal;
+ frame.mItems = reinterpret_cast<const WorldItem *>(reinterpret_cast<const char *>(slot) + sizeof(WorldFrame));
+
+ // The count and time are only good if the frame
+ // was not overwritten while they were read
+ return IsValid(frame) && frame.mCount <= GetHeader()->mCapacity;
+}
+
+/**
+ * Read the last frame published
+ * @param frame Frame to fill in
+ * @return false if no frame has been published
+ */
+bool WorldReader::ReadLatest(Frame &frame) const
+{
+ // The export can lap a slow reader, so try again
+ // with the new latest frame if that happens
+ for (int attempt = 0; attempt < 3; attempt++)
+ {
+  if (Read(GetLatest(), frame))
+  {
+   return true;
+  }
+ }
+
+ return false;
+}
+
+/**
+ * Has a frame been left alone since it was read?
+ * @param frame Frame filled in by Read or ReadLatest
+ * @return true if everything read from the frame is good
+ */
+bool WorldReader::IsValid(const Frame &frame) const
+{
+ if (mMemory == nullptr || frame.mSequence == 0)
+ {
+  return false;
+ }
+
+ atomic_thread_fence(memory_order_acquire);
+ return GetSlot(frame.mSequence)->mSequence.load(memory_order_relaxed) == frame.mSequence * 2;
+}
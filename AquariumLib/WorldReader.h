@@ -0,0 +1,74 @@
+/**
+ * @file WorldReader.h
+ * @author Evan Gasper
+ *
+ * Reads the frames an aquarium exports into shared memory
+ */
+
+#ifndef WORLDREADER_H
+#define WORLDREADER_H
+
+#include <string>
+#include "WorldLayout.h"
+
+/**
+ * Reads the frames an aquarium exports into shared memory.
+ *
+ * This is for other programs, so it does not use wxWidgets. Frames
+ * are read in place without copying or locking. A frame stays in
+ * the ring until the export has written as many frames as there
+ * are slots, so readers should use it promptly and then call
+ * IsValid to make sure it was not overwritten while they did.
+ */
+class WorldReader {
+public:
+ /// A frame, pointing straight into the shared memory
+ struct Frame {
+  uint64_t mSequence = 0;           ///< Number of the frame, from 1
+  double mTime = 0;                 ///< Simulated time of the frame in seconds
+  uint32_t mCount = 0;              ///< Number of items in mItems
+  uint32_t mTotal = 0;              ///< Number of items in the aquarium
+  const WorldItem* mItems = nullptr; ///< The items, in drawing order
+ };
+
+private:
+ /// The shared memory, or null if not open. Only
+ /// the count of polls in the header is written.
+ char* mMemory = nullptr;
+
+ /// Size of the shared memory in bytes
+ size_t mSize = 0;
+
+ /**
+  * Get the header at the start of the shared memory
+  * @return The header
+  */
+ const WorldHeader* GetHeader() const { return reinterpret_cast<const WorldHeader*>(mMemory); }
+
+ const WorldFrame* GetSlot(uint64_t sequence) const;
+
+public:
+ WorldReader() = default;
+ ~WorldReader();
+
+ /// Copy constructor (disabled)
+ WorldReader(const WorldReader &) = delete;
+
+ /// Assignment operator (disabled)
+ void operator=(const WorldReader &) = delete;
+
+ bool Open(const std::string& name);
+ void Close();
+ uint64_t GetLatest() const;
+ bool Read(uint64_t sequence, Frame& frame) const;
+ bool ReadLatest(Frame& frame) const;
+ bool IsValid(const Frame& frame) const;
+
+ /**
+  * Is the shared memory open?
+  * @return true if frames can be read
+  */
+ bool IsOpen() const { return mMemory != nullptr; }
+};
+
+#endif //WORLDREADER_H
@@ -1,23 +1,43 @@
-/**
- * @file ids.h
- * @author Evan Gasper
- *
- * ID values for our program.
- */
-
-#ifndef AQUARIUM_IDS_H
-#define AQUARIUM_IDS_H
-
-/**
- * IDs for each of the fish
- */
-enum IDs {
- IDM_ADDFISHBETA = wxID_HIGHEST + 1,
- IDM_ADDFISHDOVA,
- IDM_ADDFISHCHEST,
- IDM_ADDFISHCARP,
- IDM_ADDFISHMAGNET,
- IDM_ADDDECORCASTLE
-};
-
+/**
+ * @file ids.h
+ * @author Evan Gasper
+ *
+ * ID values for our program.
+ */
+
+#ifndef AQUARIUM_IDS_H
+#define AQUARIUM_IDS_H
+
+/**
+ * IDs for each of the fish
+ */
+enum IDs {
+ IDM_ADDFISHBETA = wxID_HIGHEST + 1,
+ IDM_ADDFISHDOVA,
+ IDM_ADDFISHCHEST,
+ IDM_ADDFISHCARP,
+ IDM_ADDFISHMAGNET,
+ IDM_ADDDECORCASTLE,
+ IDM_CANCELJOB,
+ IDM_ZOOMIN,
+ IDM_ZOOMOUT,
+ IDM_ZOOMRESET,
+ IDM_LARGETANK,
+ IDM_SCHOOLING,
+ IDM_COLLISIONS,
+ IDM_KINETIC,
+ IDM_RENDERDC,
+ IDM_RENDERGRAPHICS,
+ IDM_ADDTANK,
+ IDM_PREVIEW,
+ IDM_MEMORY,
+ IDM_DELETE,
+ IDM_BRINGTOFRONT,
+ IDM_MIRROR,
+ IDM_SELECTALL,
+ IDM_ADDMANY100,
+ IDM_ADDMANY1000,
+ IDM_ADDMANY10000
+};
+
 #endif //AQUARIUM_IDS_H
\ No newline at end of file
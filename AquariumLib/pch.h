@@ -1,14 +1,14 @@
-/**
-* @file pch.h
- * @author Evan Gasper
- */
-#ifndef AQUARIUM_PCH_H
-#define AQUARIUM_PCH_H
-
-#include <wx/wxprec.h>
-#ifndef WX_PRECOMP
-#include <wx/wx.h>
-#endif
-
-#include <wx/xml/xml.h>
-#endif //AQUARIUM_PCH_H
+/**
+* @file pch.h
+ * @author Evan Gasper
+ */
+#ifndef AQUARIUM_PCH_H
+#define AQUARIUM_PCH_H
+
+#include <wx/wxprec.h>
+#ifndef WX_PRECOMP
+#include <wx/wx.h>
+#endif
+
+#include <wx/xml/xml.h>
+#endif //AQUARIUM_PCH_H
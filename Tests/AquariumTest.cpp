@@ -1,291 +1,806 @@
-#include <pch.h>
-#include "gtest/gtest.h"
-#include <Item.h>
-#include <Aquarium.h>
-#include <FishBeta.h>
-#include <ChestFish.h>
-#include <DecorCastle.h>
-#include <DovaFish.h>
-#include <regex>
-#include <string>
-#include <fstream>
-#include <streambuf>
-#include <wx/filename.h>
-
-using namespace std;
-
-const unsigned int RandomSeed = 1238197374;
-
-class AquariumTest : public ::testing::Test {
-protected:
-    /**
-    * Create a path to a place to put temporary files
-    */
-    wxString TempPath()
-    {
-        // Create a temporary filename we can use
-        auto path = wxFileName::GetTempDir() + L"/aquarium";
-        if(!wxFileName::DirExists(path))
-        {
-            wxFileName::Mkdir(path);
-        }
-
-        return path;
-    }
-
-    /**
-    * Read a file into a wstring and return it.
-    * @param filename Name of the file to read
-    * @return File contents
-    */
-    wstring ReadFile(const wxString &filename)
-    {
-        ifstream t(filename.ToStdString());
-        wstring str((istreambuf_iterator<char>(t)),
-                istreambuf_iterator<char>());
-
-        return str;
-    }
-
-    /**
-     * Test to ensure an aquarium .aqua file is empty
-     */
-    void TestEmpty(wxString filename)
-    {
-        cout << "Temp file: " << filename << endl;
-
-        auto xml = ReadFile(filename);
-        cout << xml << endl;
-
-        ASSERT_TRUE(regex_search(xml, wregex(L"<\\?xml.*\\?>")));
-        ASSERT_TRUE(regex_search(xml, wregex(L"<aqua/>")));
-    }
-
-    /**
-     *  Populate an aquarium with three Beta fish
-     */
-    void PopulateThreeBetas(Aquarium *aquarium)
-    {
-        aquarium->GetRandom().seed(RandomSeed);
-        auto fish1 = make_shared<FishBeta>(aquarium);
-        aquarium->Add(fish1);
-        fish1->SetLocation(100, 200);
-
-        auto fish2 = make_shared<FishBeta>(aquarium);
-        aquarium->Add(fish2);
-        fish2->SetLocation(400, 400);
-
-        auto fish3 = make_shared<FishBeta>(aquarium);
-        aquarium->Add(fish3);
-        fish3->SetLocation(600, 100);
-    }
-
-    void TestThreeBetas(wxString filename)
-    {
-
-        cout << "Temp file: " << filename << endl;
-
-        auto xml = ReadFile(filename);
-        cout << xml << endl;
-
-        // Ensure three items
-        ASSERT_TRUE(regex_search(xml, wregex(L"<aqua><item.*<item.*<item.*</aqua>")));
-
-        // Ensure the positions are correct
-        ASSERT_TRUE(regex_search(xml, wregex(L"<item x=\"100\" y=\"200\"")));
-
-        // Ensure the positions are correct
-        ASSERT_TRUE(regex_search(xml, wregex(L"<item x=\"100\" y=\"200\"")));
-        ASSERT_TRUE(regex_search(xml, wregex(L"<item x=\"400\" y=\"400\"")));
-        ASSERT_TRUE(regex_search(xml, wregex(L"<item x=\"600\" y=\"100\"")));
-
-        // Ensure the types are correct
-        ASSERT_TRUE(regex_search(xml,
-                wregex(L"<aqua><item.* type=\"beta\"/><item.* type=\"beta\"/><item.* type=\"beta\"/></aqua>")));
-    }
-
-    void PopulateAllTypes(Aquarium *aquarium)
-    {
-        auto fish1 = make_shared<ChestFish>(aquarium);
-        aquarium->Add(fish1);
-        fish1->SetLocation(120, 220);
-
-        auto fish2 = make_shared<DovaFish>(aquarium);
-        aquarium->Add(fish2);
-        fish2->SetLocation(420, 420);
-
-        auto fish3 = make_shared<DecorCastle>(aquarium);
-        aquarium->Add(fish3);
-        fish3->SetLocation(620, 120);
-    }
-
-    void TestAllTypes(wxString filename)
-    {
-        cout << "Temp file: " << filename << endl;
-
-        auto xml = ReadFile(filename);
-        cout << xml << endl;
-
-        // Ensure three items
-        ASSERT_TRUE(regex_search(xml, wregex(L"<aqua><item.*<item.*<item.*</aqua>")));
-
-        // Ensure the positions are correct
-        ASSERT_TRUE(regex_search(xml, wregex(L"<item x=\"120\" y=\"220\"")));
-
-        // Ensure the positions are correct
-        ASSERT_TRUE(regex_search(xml, wregex(L"<item x=\"120\" y=\"220\"")));
-        ASSERT_TRUE(regex_search(xml, wregex(L"<item x=\"420\" y=\"420\"")));
-        ASSERT_TRUE(regex_search(xml, wregex(L"<item x=\"620\" y=\"120\"")));
-
-        // Ensure the types are correct
-        ASSERT_TRUE(regex_search(xml,
-                wregex(L"<aqua><item.* type=\"chest\"/><item.* type=\"dova\"/><item.* type=\"castle\"/></aqua>")));
-    }
-
-};
-
-TEST_F(AquariumTest, Construct){
-    Aquarium aquarium;
-}
-
-TEST_F(AquariumTest, HitTest) {
-    Aquarium aquarium;
-
-    ASSERT_EQ(aquarium.HitTest(100, 200), nullptr) <<
-        L"Testing empty aquarium";
-
-    shared_ptr<FishBeta> fish1 = make_shared<FishBeta>(&aquarium);
-    aquarium.Add(fish1);
-    fish1->SetLocation(100, 200);
-
-    ASSERT_TRUE(aquarium.HitTest(100, 200) == fish1) <<
-          L"Testing fish at 100, 200";
-    // Add second fish at the same location, it should be on top of fish1
-    shared_ptr<FishBeta> fish2 = make_shared<FishBeta>(&aquarium);
-    aquarium.Add(fish2);
-    fish2->SetLocation(100, 200);
-
-    // Test hit on second fish, which is on top of fish1
-    ASSERT_TRUE(aquarium.HitTest(100, 200) == fish2) << L"Testing top fish at 100, 200";
-
-    // Test hit slightly outside the fish location to ensure no hit
-    ASSERT_EQ(aquarium.HitTest(300, 400), nullptr) << L"Testing empty spot at 300, 400";
-
-    // Move second fish away and test again to ensure the first fish is now detected
-    fish2->SetLocation(150, 250);
-    ASSERT_TRUE(aquarium.HitTest(100, 200) == fish1) << L"Testing fish1 after moving fish2";
-
-    // Test the new location of fish2 to ensure it's now hit
-    ASSERT_TRUE(aquarium.HitTest(150, 250) == fish2) << L"Testing fish2 at new location 150, 250";
-}
-
-TEST_F(AquariumTest, Save) {
-    // Create a path to temporary files
-    auto path = TempPath();
-
-    // Create an aquarium
-    Aquarium aquarium;
-
-    //
-    // First test, saving an empty aquarium
-    //
-    auto file1 = path + L"/test1.aqua";
-    aquarium.Save(file1);
-
-    TestEmpty(file1);
-
-    //
-    // Now populate the aquarium
-    //
-
-    PopulateThreeBetas(&aquarium);
-
-    auto file2 = path + L"/test2.aqua";
-    aquarium.Save(file2);
-
-    TestThreeBetas(file2);
-
-    //
-    // Test all types
-    //
-    Aquarium aquarium3;
-    PopulateAllTypes(&aquarium3);
-
-    auto file3 = path + L"/test3.aqua";
-    aquarium3.Save(file3);
-
-    TestAllTypes(file3);
-}
-
-
-TEST_F(AquariumTest, Clear) {
-    // Create an aquarium
-    Aquarium aquarium;
-
-    // Populate the aquarium with three Beta fish
-    PopulateThreeBetas(&aquarium);
-
-    // Ensure there are fish in the aquarium before clearing
-    ASSERT_TRUE(aquarium.HitTest(100, 200) != nullptr) << L"Fish should be present before clearing";
-
-    // Clear the aquarium
-    aquarium.Clear();
-
-    // Ensure the aquarium is empty after clearing
-    ASSERT_EQ(aquarium.HitTest(100, 200), nullptr) << L"Aquarium should be empty after clearing";
-    ASSERT_EQ(aquarium.HitTest(400, 400), nullptr) << L"Aquarium should be empty after clearing";
-    ASSERT_EQ(aquarium.HitTest(600, 100), nullptr) << L"Aquarium should be empty after clearing";
-}
-
-
-TEST_F(AquariumTest, Load) {
-    // Create a path to temporary files
-    auto path = TempPath();
-
-    // Create an aquarium
-    Aquarium aquarium;
-    Aquarium aquarium2;
-
-    //
-    // First test, saving an empty aquarium
-    //
-    auto file1 = path + L"/test1.aqua";
-    aquarium.Save(file1);
-
-    TestEmpty(file1);
-
-    aquarium2.Load(file1);
-    aquarium2.Save(file1);
-    TestEmpty(file1);
-
-    //
-    // Now populate the aquarium
-    //
-
-    PopulateThreeBetas(&aquarium);
-
-    auto file2 = path + L"/test2.aqua";
-    aquarium.Save(file2);
-
-    TestThreeBetas(file2);
-
-    aquarium2.Load(file2);
-    aquarium2.Save(file2);
-    TestThreeBetas(file2);
-
-    //
-    // Test all types
-    //
-    Aquarium aquarium3;
-    PopulateAllTypes(&aquarium3);
-
-    auto file3 = path + L"/test3.aqua";
-    aquarium3.Save(file3);
-
-    TestAllTypes(file3);
-
-    aquarium2.Load(file3);
-    aquarium2.Save(file3);
-    TestAllTypes(file3);
-}
-
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <Item.h>
+#include <Aquarium.h>
+#include <FishBeta.h>
+#include <ChestFish.h>
+#include <DecorCastle.h>
+#include <DovaFish.h>
+#include <AquariumJob.h>
+#include "TestAssets.h"
+#include <regex>
+#include <string>
+#include <fstream>
+#include <streambuf>
+#include <thread>
+#include <chrono>
+#include <wx/filename.h>
+#include <wx/filefn.h>
+
+using namespace std;
+
+const unsigned int RandomSeed = 1238197374;
+
+/** Item with a plain image that can hide items behind it */
+class DecorMock : public Item
+{
+private:
+    bool mOccluder;
+
+public:
+    DecorMock(Aquarium *aquarium, const wxString &filename, bool occluder) :
+        Item(Species::Get(filename.ToStdWstring())), mOccluder(occluder) {}
+
+    bool IsOccluder() const override { return mOccluder; }
+};
+
+class AquariumTest : public ::testing::Test {
+protected:
+    /**
+    * Create a path to a place to put temporary files
+    */
+    wxString TempPath()
+    {
+        // Create a temporary filename we can use
+        auto path = wxFileName::GetTempDir() + L"/aquarium";
+        if(!wxFileName::DirExists(path))
+        {
+            wxFileName::Mkdir(path);
+        }
+
+        return path;
+    }
+
+    /**
+    * Read a file into a wstring and return it.
+    * @param filename Name of the file to read
+    * @return File contents
+    */
+    wstring ReadFile(const wxString &filename)
+    {
+        ifstream t(filename.ToStdString());
+        wstring str((istreambuf_iterator<char>(t)),
+                istreambuf_iterator<char>());
+
+        return str;
+    }
+
+    /**
+     * Test to ensure an aquarium .aqua file is empty
+     */
+    void TestEmpty(wxString filename)
+    {
+        cout << "Temp file: " << filename << endl;
+
+        auto xml = ReadFile(filename);
+        cout << xml << endl;
+
+        ASSERT_TRUE(regex_search(xml, wregex(L"<\\?xml.*\\?>")));
+        ASSERT_TRUE(regex_search(xml, wregex(L"<aqua/>")));
+    }
+
+    /**
+     *  Populate an aquarium with three Beta fish
+     */
+    void PopulateThreeBetas(Aquarium *aquarium)
+    {
+        aquarium->GetRandom().seed(RandomSeed);
+        auto fish1 = make_shared<FishBeta>(aquarium);
+        aquarium->Add(fish1);
+        fish1->SetLocation(100, 200);
+
+        auto fish2 = make_shared<FishBeta>(aquarium);
+        aquarium->Add(fish2);
+        fish2->SetLocation(400, 400);
+
+        auto fish3 = make_shared<FishBeta>(aquarium);
+        aquarium->Add(fish3);
+        fish3->SetLocation(600, 100);
+    }
+
+    void TestThreeBetas(wxString filename)
+    {
+
+        cout << "Temp file: " << filename << endl;
+
+        auto xml = ReadFile(filename);
+        cout << xml << endl;
+
+        // Ensure three items
+        ASSERT_TRUE(regex_search(xml, wregex(L"<aqua><item.*<item.*<item.*</aqua>")));
+
+        // Ensure the positions are correct
+        ASSERT_TRUE(regex_search(xml, wregex(L"<item x=\"100\" y=\"200\"")));
+
+        // Ensure the positions are correct
+        ASSERT_TRUE(regex_search(xml, wregex(L"<item x=\"100\" y=\"200\"")));
+        ASSERT_TRUE(regex_search(xml, wregex(L"<item x=\"400\" y=\"400\"")));
+        ASSERT_TRUE(regex_search(xml, wregex(L"<item x=\"600\" y=\"100\"")));
+
+        // Ensure the types are correct
+        ASSERT_TRUE(regex_search(xml,
+                wregex(L"<aqua><item.* type=\"beta\"/><item.* type=\"beta\"/><item.* type=\"beta\"/></aqua>")));
+    }
+
+    void PopulateAllTypes(Aquarium *aquarium)
+    {
+        auto fish1 = make_shared<ChestFish>(aquarium);
+        aquarium->Add(fish1);
+        fish1->SetLocation(120, 220);
+
+        auto fish2 = make_shared<DovaFish>(aquarium);
+        aquarium->Add(fish2);
+        fish2->SetLocation(420, 420);
+
+        auto fish3 = make_shared<DecorCastle>(aquarium);
+        aquarium->Add(fish3);
+        fish3->SetLocation(620, 120);
+    }
+
+    void TestAllTypes(wxString filename)
+    {
+        cout << "Temp file: " << filename << endl;
+
+        auto xml = ReadFile(filename);
+        cout << xml << endl;
+
+        // Ensure three items
+        ASSERT_TRUE(regex_search(xml, wregex(L"<aqua><item.*<item.*<item.*</aqua>")));
+
+        // Ensure the positions are correct
+        ASSERT_TRUE(regex_search(xml, wregex(L"<item x=\"120\" y=\"220\"")));
+
+        // Ensure the positions are correct
+        ASSERT_TRUE(regex_search(xml, wregex(L"<item x=\"120\" y=\"220\"")));
+        ASSERT_TRUE(regex_search(xml, wregex(L"<item x=\"420\" y=\"420\"")));
+        ASSERT_TRUE(regex_search(xml, wregex(L"<item x=\"620\" y=\"120\"")));
+
+        // Ensure the types are correct
+        ASSERT_TRUE(regex_search(xml,
+                wregex(L"<aqua><item.* type=\"chest\"/><item.* type=\"dova\"/><item.* type=\"castle\"/></aqua>")));
+    }
+
+};
+
+TEST_F(AquariumTest, Construct){
+    Aquarium aquarium(TestAssets());
+}
+
+TEST_F(AquariumTest, HitTest) {
+    Aquarium aquarium(TestAssets());
+
+    ASSERT_EQ(aquarium.HitTest(100, 200), nullptr) <<
+        L"Testing empty aquarium";
+
+    shared_ptr<FishBeta> fish1 = make_shared<FishBeta>(&aquarium);
+    aquarium.Add(fish1);
+    fish1->SetLocation(100, 200);
+
+    ASSERT_TRUE(aquarium.HitTest(100, 200) == fish1) <<
+          L"Testing fish at 100, 200";
+    // Add second fish at the same location, it should be on top of fish1
+    shared_ptr<FishBeta> fish2 = make_shared<FishBeta>(&aquarium);
+    aquarium.Add(fish2);
+    fish2->SetLocation(100, 200);
+
+    // Test hit on second fish, which is on top of fish1
+    ASSERT_TRUE(aquarium.HitTest(100, 200) == fish2) << L"Testing top fish at 100, 200";
+
+    // Test hit slightly outside the fish location to ensure no hit
+    ASSERT_EQ(aquarium.HitTest(300, 400), nullptr) << L"Testing empty spot at 300, 400";
+
+    // Move second fish away and test again to ensure the first fish is now detected
+    fish2->SetLocation(150, 250);
+    ASSERT_TRUE(aquarium.HitTest(100, 200) == fish1) << L"Testing fish1 after moving fish2";
+
+    // Test the new location of fish2 to ensure it's now hit
+    ASSERT_TRUE(aquarium.HitTest(150, 250) == fish2) << L"Testing fish2 at new location 150, 250";
+}
+
+TEST_F(AquariumTest, Save) {
+    // Create a path to temporary files
+    auto path = TempPath();
+
+    // Create an aquarium
+    Aquarium aquarium(TestAssets());
+
+    //
+    // First test, saving an empty aquarium
+    //
+    auto file1 = path + L"/test1.aqua";
+    aquarium.Save(file1);
+
+    TestEmpty(file1);
+
+    //
+    // Now populate the aquarium
+    //
+
+    PopulateThreeBetas(&aquarium);
+
+    auto file2 = path + L"/test2.aqua";
+    aquarium.Save(file2);
+
+    TestThreeBetas(file2);
+
+    //
+    // Test all types
+    //
+    Aquarium aquarium3(TestAssets());
+    PopulateAllTypes(&aquarium3);
+
+    auto file3 = path + L"/test3.aqua";
+    aquarium3.Save(file3);
+
+    TestAllTypes(file3);
+}
+
+
+TEST_F(AquariumTest, Clear) {
+    // Create an aquarium
+    Aquarium aquarium(TestAssets());
+
+    // Populate the aquarium with three Beta fish
+    PopulateThreeBetas(&aquarium);
+
+    // Ensure there are fish in the aquarium before clearing
+    ASSERT_TRUE(aquarium.HitTest(100, 200) != nullptr) << L"Fish should be present before clearing";
+
+    // Clear the aquarium
+    aquarium.Clear();
+
+    // Ensure the aquarium is empty after clearing
+    ASSERT_EQ(aquarium.HitTest(100, 200), nullptr) << L"Aquarium should be empty after clearing";
+    ASSERT_EQ(aquarium.HitTest(400, 400), nullptr) << L"Aquarium should be empty after clearing";
+    ASSERT_EQ(aquarium.HitTest(600, 100), nullptr) << L"Aquarium should be empty after clearing";
+}
+
+
+TEST_F(AquariumTest, Load) {
+    // Create a path to temporary files
+    auto path = TempPath();
+
+    // Create an aquarium
+    Aquarium aquarium(TestAssets());
+    Aquarium aquarium2(TestAssets());
+
+    //
+    // First test, saving an empty aquarium
+    //
+    auto file1 = path + L"/test1.aqua";
+    aquarium.Save(file1);
+
+    TestEmpty(file1);
+
+    aquarium2.Load(file1);
+    aquarium2.Save(file1);
+    TestEmpty(file1);
+
+    //
+    // Now populate the aquarium
+    //
+
+    PopulateThreeBetas(&aquarium);
+
+    auto file2 = path + L"/test2.aqua";
+    aquarium.Save(file2);
+
+    TestThreeBetas(file2);
+
+    aquarium2.Load(file2);
+    aquarium2.Save(file2);
+    TestThreeBetas(file2);
+
+    //
+    // Test all types
+    //
+    Aquarium aquarium3(TestAssets());
+    PopulateAllTypes(&aquarium3);
+
+    auto file3 = path + L"/test3.aqua";
+    aquarium3.Save(file3);
+
+    TestAllTypes(file3);
+
+    aquarium2.Load(file3);
+    aquarium2.Save(file3);
+    TestAllTypes(file3);
+}
+
+TEST_F(AquariumTest, LoadItems) {
+    auto path = TempPath();
+
+    Aquarium aquarium(TestAssets());
+    PopulateAllTypes(&aquarium);
+
+    auto file = path + L"/test4.aqua";
+    aquarium.Save(file);
+
+    // Loading reports progress and does not touch the aquarium
+    Aquarium aquarium2(TestAssets());
+    vector<shared_ptr<Item>> items;
+    double last = 0;
+    ASSERT_TRUE(aquarium2.LoadItems(file, items, [&last](double progress) {
+        EXPECT_GE(progress, last);
+        last = progress;
+        return true;
+    }));
+    ASSERT_EQ(items.size(), 3u);
+    ASSERT_EQ(aquarium2.HitTest(420, 420), nullptr);
+
+    // The loaded items appear only once they are swapped in
+    aquarium2.SetItems(std::move(items));
+    aquarium2.Save(file);
+    TestAllTypes(file);
+
+    // A cancelled load fails
+    vector<shared_ptr<Item>> cancelled;
+    ASSERT_FALSE(aquarium2.LoadItems(file, cancelled, [](double progress) { return false; }));
+}
+
+TEST_F(AquariumTest, BackgroundJob) {
+    auto path = TempPath();
+
+    Aquarium aquarium(TestAssets());
+    PopulateThreeBetas(&aquarium);
+
+    auto file = path + L"/test5.aqua";
+    std::shared_ptr<wxXmlDocument> xmlDoc = aquarium.XmlDocument();
+    AquariumJob save(nullptr, L"Saving", [&aquarium, xmlDoc, file](AquariumJob& job) {
+        return aquarium.WriteDocument(*xmlDoc, file, job.Progress());
+    });
+    save.Start();
+    ASSERT_TRUE(save.Wait());
+    ASSERT_TRUE(save.IsDone());
+    TestThreeBetas(file);
+
+    Aquarium aquarium2(TestAssets());
+    vector<shared_ptr<Item>> items;
+    AquariumJob load(nullptr, L"Loading", [&aquarium2, &items, file](AquariumJob& job) {
+        return aquarium2.LoadItems(file, items, job.Progress());
+    });
+    load.Start();
+    ASSERT_TRUE(load.Wait());
+    ASSERT_EQ(items.size(), 3u);
+}
+
+TEST_F(AquariumTest, Journal) {
+    auto path = TempPath();
+    auto file = path + L"/test6.aqua";
+
+    Aquarium aquarium(TestAssets());
+    PopulateAllTypes(&aquarium);
+    aquarium.Save(file);
+
+    auto chest = aquarium.HitTest(120, 220);
+    auto dova = aquarium.HitTest(420, 420);
+    ASSERT_TRUE(chest != nullptr);
+    ASSERT_TRUE(dova != nullptr);
+
+    // Edits after a save go to the journal, not the file
+    auto fish = make_shared<FishBeta>(&aquarium);
+    aquarium.Add(fish);
+    fish->SetLocation(100, 200);
+    aquarium.ItemMoved(fish);
+    aquarium.Remove(chest);
+    aquarium.MoveItemToEnd(dova);
+    TestAllTypes(file);
+
+    // Loading replays the journal on top of the file
+    Aquarium aquarium2(TestAssets());
+    aquarium2.Load(file);
+
+    auto file2 = path + L"/test7.aqua";
+    aquarium2.Save(file2);
+
+    auto xml = ReadFile(file2);
+    ASSERT_TRUE(regex_search(xml, wregex(L"<item x=\"100\" y=\"200\"")));
+    ASSERT_FALSE(regex_search(xml, wregex(L"<item x=\"120\" y=\"220\"")));
+    ASSERT_TRUE(regex_search(xml,
+            wregex(L"<aqua><item.* type=\"castle\"/><item.* type=\"beta\"/><item.* type=\"dova\"/></aqua>")));
+
+    // Saving to the same file compacts the journal into it
+    aquarium.Save(file);
+    ASSERT_TRUE(regex_search(ReadFile(AquariumJournal::JournalFilename(file)), wregex(L"^aquajournal \\w+\n$")));
+
+    Aquarium aquarium3(TestAssets());
+    aquarium3.Load(file);
+    aquarium3.Save(file2);
+    xml = ReadFile(file2);
+    ASSERT_TRUE(regex_search(xml,
+            wregex(L"<aqua><item.* type=\"castle\"/><item.* type=\"beta\"/><item.* type=\"dova\"/></aqua>")));
+}
+
+TEST_F(AquariumTest, JournalTail) {
+    auto path = TempPath();
+    auto file = path + L"/test16.aqua";
+    auto name = AquariumJournal::JournalFilename(file);
+    wxRemoveFile(name + L".rejected");
+
+    Aquarium aquarium(TestAssets());
+    PopulateThreeBetas(&aquarium);
+    aquarium.Save(file);
+    aquarium.Add(make_shared<FishBeta>(&aquarium));
+    {
+        ofstream journal(name.ToStdString(), ios::app);
+        journal << "999 bogus\n1000 clear\n";
+    }
+
+    auto before = ReadFile(name);
+
+    // A load that is not resumed leaves the journal file alone
+    vector<shared_ptr<Item>> items;
+    unique_ptr<AquariumJournal> journal;
+    ASSERT_TRUE(aquarium.LoadItems(file, items, nullptr, &journal));
+    ASSERT_EQ(items.size(), 4u);
+    journal = nullptr;
+    ASSERT_EQ(ReadFile(name), before);
+
+    // Resuming sets aside the records replay stopped at
+    Aquarium aquarium2(TestAssets());
+    aquarium2.Load(file);
+    ASSERT_EQ(aquarium2.GetCount(), 4u);
+    ASSERT_EQ(ReadFile(name + L".rejected"), L"999 bogus\n1000 clear\n");
+    ASSERT_FALSE(regex_search(ReadFile(name), wregex(L"bogus")));
+}
+
+TEST_F(AquariumTest, Compressed) {
+    auto path = TempPath();
+
+    Aquarium aquarium(TestAssets());
+    PopulateThreeBetas(&aquarium);
+
+    // A .gz filename is saved gzip compressed
+    auto file = path + L"/test8.aqua.gz";
+    aquarium.Save(file);
+
+    ifstream t(file.ToStdString(), ios::binary);
+    ASSERT_EQ(t.get(), 0x1f);
+    ASSERT_EQ(t.get(), 0x8b);
+
+    // Compressed files load like any other
+    Aquarium aquarium2(TestAssets());
+    aquarium2.Load(file);
+
+    auto file2 = path + L"/test8.aqua";
+    aquarium2.Save(file2);
+    TestThreeBetas(file2);
+}
+
+TEST_F(AquariumTest, ParallelLoad) {
+    auto path = TempPath();
+
+    // Enough items that the load is split between several workers
+    Aquarium aquarium(TestAssets());
+    for (int i = 0; i < 1000; i++)
+    {
+        auto fish = make_shared<FishBeta>(&aquarium);
+        aquarium.Add(fish);
+        fish->SetLocation(i, 100);
+    }
+
+    auto file = path + L"/test9.aqua";
+    aquarium.Save(file);
+
+    // Items come back in file order
+    Aquarium aquarium2(TestAssets());
+    vector<shared_ptr<Item>> items;
+    ASSERT_TRUE(aquarium2.LoadItems(file, items));
+    ASSERT_EQ(items.size(), 1000u);
+    for (int i = 0; i < 1000; i++)
+    {
+        ASSERT_NEAR(i, items[i]->GetX(), 0.0001);
+    }
+}
+
+TEST_F(AquariumTest, Snapshot) {
+    auto path = TempPath();
+
+    Aquarium aquarium(TestAssets());
+    PopulateAllTypes(&aquarium);
+
+    auto snapshot = aquarium.Snapshot();
+    ASSERT_EQ(snapshot->size(), 3u);
+
+    // The snapshot does not change when the items do
+    auto file = path + L"/test10.aqua";
+    aquarium.Save(file);
+    auto saved = ReadFile(file);
+
+    aquarium.Update(1);
+    aquarium.Clear();
+
+    auto file2 = path + L"/test11.aqua";
+    ASSERT_TRUE(Aquarium::WriteSnapshot(*snapshot, file2));
+    TestAllTypes(file2);
+
+    // A snapshot writes the same items Save does
+    auto written = ReadFile(file2);
+    ASSERT_EQ(saved.substr(saved.find(L"<aqua")), written.substr(written.find(L"<aqua")));
+}
+
+TEST_F(AquariumTest, Detail) {
+    Aquarium aquarium;
+    wxRect all(0, 0, aquarium.GetWidth(), aquarium.GetHeight());
+    aquarium.Add(make_shared<FishBeta>(&aquarium));
+    ASSERT_EQ(aquarium.ChooseDetail(aquarium.ItemsIn(all), all), Aquarium::Detail::Full);
+
+    // Fish covering the aquarium several times over are reduced
+    for (int i = 0; i < 299; i++)
+    {
+        aquarium.Add(make_shared<FishBeta>(&aquarium));
+    }
+    ASSERT_EQ(aquarium.ChooseDetail(aquarium.ItemsIn(all), all), Aquarium::Detail::Reduced);
+
+    // Many more are drawn as impostors
+    for (int i = 0; i < 700; i++)
+    {
+        aquarium.Add(make_shared<FishBeta>(&aquarium));
+    }
+    ASSERT_EQ(aquarium.ChooseDetail(aquarium.ItemsIn(all), all), Aquarium::Detail::Impostor);
+}
+
+TEST_F(AquariumTest, Hidden) {
+    auto path = TempPath();
+
+    // Plain opaque images to make items with
+    auto large = path + L"/large.png";
+    auto small = path + L"/small.png";
+    wxImage(100, 100).SaveFile(large, wxBITMAP_TYPE_PNG);
+    wxImage(20, 20).SaveFile(small, wxBITMAP_TYPE_PNG);
+    Sprite::Get(large)->GetImage();
+    Sprite::Get(small)->GetImage();
+
+    Aquarium aquarium;
+    auto behind = make_shared<DecorMock>(&aquarium, small, false);
+    auto partly = make_shared<DecorMock>(&aquarium, small, false);
+    auto decor = make_shared<DecorMock>(&aquarium, large, true);
+    auto front = make_shared<DecorMock>(&aquarium, small, false);
+    aquarium.Add(behind);
+    aquarium.Add(partly);
+    aquarium.Add(decor);
+    aquarium.Add(front);
+    behind->SetLocation(210, 190);
+    partly->SetLocation(250, 200);
+    decor->SetLocation(200, 200);
+    front->SetLocation(200, 200);
+
+    // Only the item entirely behind the decor is hidden
+    wxRect all(0, 0, aquarium.GetWidth(), aquarium.GetHeight());
+    auto hidden = aquarium.FindHidden(aquarium.ItemsIn(all));
+    ASSERT_EQ(hidden, vector<bool>({true, false, false, false}));
+
+    // Items that do not hide others hide nothing
+    aquarium.MoveItemToEnd(behind);
+    hidden = aquarium.FindHidden(aquarium.ItemsIn(all));
+    ASSERT_EQ(hidden, vector<bool>({false, false, false, false}));
+}
+
+TEST_F(AquariumTest, ItemsIn) {
+    // An aquarium much larger than the window
+    Aquarium aquarium(TestAssets());
+    aquarium.SetSize(wxSize(10000, 10000));
+    ASSERT_EQ(aquarium.GetWidth(), 10000);
+
+    auto near = make_shared<FishBeta>(&aquarium);
+    auto far = make_shared<FishBeta>(&aquarium);
+    auto other = make_shared<FishBeta>(&aquarium);
+    aquarium.Add(near);
+    aquarium.Add(far);
+    aquarium.Add(other);
+    near->SetLocation(100, 100);
+    far->SetLocation(9000, 9000);
+    other->SetLocation(500, 300);
+
+    // Only items near the rectangle are found, in drawing order
+    ASSERT_EQ(aquarium.ItemsIn(wxRect(0, 0, 1000, 800)), vector<size_t>({0, 2}));
+    ASSERT_EQ(aquarium.ItemsIn(wxRect(8500, 8500, 1000, 800)), vector<size_t>({1}));
+
+    // Shrinking the aquarium keeps the items in it
+    aquarium.SetSize(wxSize(1000, 800));
+    ASSERT_NEAR(far->GetX(), 1000, 0.0001);
+    ASSERT_NEAR(far->GetY(), 800, 0.0001);
+}
+
+TEST_F(AquariumTest, Clock) {
+    Aquarium aquarium(TestAssets());
+    auto fish = make_shared<FishBeta>(&aquarium);
+    aquarium.Add(fish);
+    fish->SetLocation(400, 300);
+    ASSERT_DOUBLE_EQ(aquarium.GetTime(), 0);
+
+    // The aquarium keeps its own time, moved on by updates
+    aquarium.Update(0.5);
+    ASSERT_DOUBLE_EQ(aquarium.GetTime(), 0.5);
+
+    // Advancing moves the fish on by the real time that passed,
+    // however many views draw it in between
+    aquarium.RestartClock();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    ItemState before;
+    fish->GetState(before);
+    auto elapsed = aquarium.Advance();
+    ASSERT_GE(elapsed, 0.02);
+    ASSERT_DOUBLE_EQ(aquarium.GetTime(), 0.5 + elapsed);
+
+    ItemState after;
+    fish->GetState(after);
+    ASSERT_NEAR(after.mX, before.mX + before.mSpeedX * elapsed, 0.0001);
+
+    // Restarting the clock skips time nothing simulated
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    aquarium.RestartClock();
+    ASSERT_LT(aquarium.Advance(), 0.02);
+}
+
+TEST_F(AquariumTest, Memory) {
+    // A fish holds only its own state, the rest is in its species
+    static_assert(sizeof(FishBeta) < 64, "fish should fit in a cache line");
+    static_assert(sizeof(DovaFish) == sizeof(Fish), "fish species should not add members");
+
+    Aquarium aquarium;
+    auto before = aquarium.GetMemory();
+    ASSERT_EQ(before.mItems, 0u);
+
+    for (int i = 0; i < 100; i++)
+    {
+        aquarium.Add(make_shared<FishBeta>(&aquarium));
+    }
+
+    // Wait for the images to be decoded, so the pixels stay put
+    Sprite::Get(L"images/background1.png")->GetImage();
+    Sprite::Get(L"images/beta.png")->GetImage();
+
+    auto after = aquarium.GetMemory();
+    ASSERT_EQ(after.mItems, 100 * sizeof(Fish));
+    ASSERT_GT(after.mPixels, 0u);
+    // The reference counts of each item are counted too
+    ASSERT_GE(after.mContainers, before.mContainers + 100 * (sizeof(shared_ptr<Item>) + 2 * sizeof(int)));
+    ASSERT_EQ(after.GetTotal(), after.mItems + after.mPixels + after.mContainers + after.mXml);
+
+    // Every fish of a species shares one sprite, so the
+    // pixels do not grow with the number of fish
+    aquarium.Add(make_shared<FishBeta>(&aquarium));
+    ASSERT_EQ(aquarium.GetMemory().mPixels, after.mPixels);
+
+    // The document a save holds is counted
+    auto xmlDoc = aquarium.XmlDocument();
+    ASSERT_GT(Aquarium::XmlMemory(*xmlDoc), 101 * sizeof(wxXmlNode));
+
+    // A load's document is counted while the load holds it,
+    // only for the aquarium loading, and freed after
+    auto file = TempPath() + L"/test17.aqua";
+    aquarium.Save(file);
+    ASSERT_EQ(aquarium.GetMemory().mXml, 0u);
+
+    Aquarium other;
+    size_t held = 0;
+    vector<shared_ptr<Item>> items;
+    ASSERT_TRUE(aquarium.LoadItems(file, items, [&aquarium, &other, &held](double fraction) {
+        held = max(held, aquarium.GetMemory().mXml);
+        return other.GetMemory().mXml == 0;
+    }));
+    ASSERT_GT(held, 101 * sizeof(wxXmlNode));
+    auto freed = aquarium.GetMemory();
+    ASSERT_EQ(freed.mXml, 0u);
+    ASSERT_EQ(freed.GetTotal(), freed.mItems + freed.mPixels + freed.mContainers);
+}
+
+TEST_F(AquariumTest, Selection) {
+    auto path = TempPath();
+    auto file = path + L"/test12.aqua";
+
+    Aquarium aquarium(TestAssets());
+    auto beta = make_shared<FishBeta>(&aquarium);
+    auto castle = make_shared<DecorCastle>(&aquarium);
+    auto dova = make_shared<DovaFish>(&aquarium);
+    auto stray = make_shared<FishBeta>(&aquarium);
+    aquarium.Add(beta);
+    aquarium.Add(castle);
+    aquarium.Add(dova);
+    aquarium.Add(stray);
+    beta->SetLocation(100, 100);
+    castle->SetLocation(700, 300);
+    dova->SetLocation(300, 100);
+    stray->SetLocation(700, 700);
+    aquarium.Save(file);
+
+    // Everything that overlaps the rectangle is selected
+    aquarium.Select(wxRect(0, 0, 400, 200));
+    ASSERT_EQ(aquarium.GetSelection().size(), 2u);
+    ASSERT_TRUE(aquarium.IsSelected(beta));
+    ASSERT_TRUE(aquarium.IsSelected(dova));
+    ASSERT_FALSE(aquarium.IsSelected(castle));
+
+    // The selection moves together
+    aquarium.MoveSelection(50, 20);
+    aquarium.SelectionMoved();
+    ASSERT_NEAR(beta->GetX(), 150, 0.0001);
+    ASSERT_NEAR(beta->GetY(), 120, 0.0001);
+    ASSERT_NEAR(dova->GetX(), 350, 0.0001);
+    ASSERT_NEAR(castle->GetX(), 700, 0.0001);
+
+    // Mirroring turns the fish around
+    double speedX, speedY, mirroredX;
+    beta->GetSpeed(&speedX, &speedY);
+    aquarium.MirrorSelection();
+    beta->GetSpeed(&mirroredX, &speedY);
+    ASSERT_DOUBLE_EQ(mirroredX, -speedX);
+
+    aquarium.MoveSelectionToEnd();
+
+    // Removing leaves the items that are not selected
+    aquarium.Select(wxRect(650, 650, 100, 100));
+    ASSERT_EQ(aquarium.GetSelection().size(), 1u);
+    aquarium.RemoveSelection();
+    ASSERT_TRUE(aquarium.GetSelection().empty());
+    ASSERT_EQ(aquarium.GetCount(), 3u);
+
+    // Each bulk edit is journaled, so loading the file
+    // gets the same aquarium
+    Aquarium aquarium2(TestAssets());
+    aquarium2.Load(file);
+
+    auto file2 = path + L"/test13.aqua";
+    auto file3 = path + L"/test14.aqua";
+    aquarium2.Save(file2);
+    aquarium.Save(file3);
+
+    auto xml = ReadFile(file2);
+    ASSERT_EQ(xml, ReadFile(file3));
+    ASSERT_TRUE(regex_search(xml,
+            wregex(L"<aqua><item.* type=\"castle\"/><item x=\"150\" y=\"120\".* type=\"beta\"/><item x=\"350\" y=\"120\".* type=\"dova\"/></aqua>")));
+
+    // Selecting all takes items outside the aquarium too
+    aquarium.MoveItem(beta, -500, -500);
+    aquarium.SelectAll();
+    ASSERT_EQ(aquarium.GetSelection().size(), 3u);
+    ASSERT_TRUE(aquarium.IsSelected(beta));
+}
+
+TEST_F(AquariumTest, AddBulk) {
+    auto path = TempPath();
+    auto file = path + L"/test15.aqua";
+
+    Aquarium aquarium(TestAssets());
+    aquarium.GetRandom().seed(RandomSeed);
+    aquarium.Save(file);
+    aquarium.AddBulk(L"beta", 1000);
+    aquarium.AddBulk(L"dova", 10, Aquarium::Spread::Centred);
+    ASSERT_EQ(aquarium.GetCount(), 1010u);
+
+    // The items are spread over the tank, inside it
+    auto snapshot = aquarium.Snapshot();
+    double left = aquarium.GetWidth(), right = 0;
+    for (auto &state : *snapshot)
+    {
+        ASSERT_GE(state.mX, 0);
+        ASSERT_LE(state.mX, aquarium.GetWidth());
+        ASSERT_GE(state.mY, 0);
+        ASSERT_LE(state.mY, aquarium.GetHeight());
+        left = min(left, state.mX);
+        right = max(right, state.mX);
+    }
+
+    ASSERT_LT(left, aquarium.GetWidth() / 4);
+    ASSERT_GT(right, aquarium.GetWidth() * 3 / 4);
+    ASSERT_STREQ((*snapshot)[0].mType, L"beta");
+    ASSERT_STREQ((*snapshot)[1009].mType, L"dova");
+
+    // The same seed adds the same items, whichever
+    // threads create them
+    Aquarium aquarium2(TestAssets());
+    aquarium2.GetRandom().seed(RandomSeed);
+    aquarium2.AddBulk(L"beta", 1000);
+    auto snapshot2 = aquarium2.Snapshot();
+    for (size_t i = 0; i < snapshot2->size(); i++)
+    {
+        ASSERT_EQ((*snapshot)[i].mX, (*snapshot2)[i].mX);
+        ASSERT_EQ((*snapshot)[i].mSpeedX, (*snapshot2)[i].mSpeedX);
+    }
+
+    // The adds are journaled
+    Aquarium aquarium3(TestAssets());
+    aquarium3.Load(file);
+    ASSERT_EQ(aquarium3.GetCount(), 1010u);
+}
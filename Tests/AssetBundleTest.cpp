@@ -0,0 +1,59 @@
+/**
+ * @file AssetBundleTest.cpp
+ * @author Evan Gasper
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <AssetBundle.h>
+#include <wx/filename.h>
+
+TEST(AssetBundleTest, WriteOpen) {
+    // A small image with a different value in every pixel
+    wxImage image(3, 2);
+    image.InitAlpha();
+    for (int y = 0; y < 2; y++)
+    {
+        for (int x = 0; x < 3; x++)
+        {
+            image.SetRGB(x, y, x * 10, y * 10, x + y);
+            image.SetAlpha(x, y, x * 50 + y);
+        }
+    }
+
+    // One without alpha
+    wxImage opaque(5, 7);
+
+    auto filename = wxFileName::GetTempDir() + L"/test.aqb";
+    ASSERT_TRUE(AssetBundle::Write(filename, {{L"images/small.png", image}, {L"images/opaque.png", opaque}}));
+
+    AssetBundle bundle;
+    ASSERT_TRUE(bundle.Open(filename));
+    ASSERT_TRUE(bundle.Contains(L"images/small.png"));
+    ASSERT_FALSE(bundle.Contains(L"images/beta.png"));
+    ASSERT_EQ(bundle.GetSize(L"images/opaque.png").GetWidth(), 5);
+    ASSERT_EQ(bundle.GetSize(L"images/opaque.png").GetHeight(), 7);
+
+    auto loaded = bundle.GetImage(L"images/small.png");
+    ASSERT_TRUE(loaded.IsOk());
+    ASSERT_TRUE(loaded.HasAlpha());
+    for (int y = 0; y < 2; y++)
+    {
+        for (int x = 0; x < 3; x++)
+        {
+            ASSERT_EQ(loaded.GetRed(x, y), x * 10);
+            ASSERT_EQ(loaded.GetGreen(x, y), y * 10);
+            ASSERT_EQ(loaded.GetBlue(x, y), x + y);
+            ASSERT_EQ(loaded.GetAlpha(x, y), x * 50 + y);
+        }
+    }
+
+    ASSERT_FALSE(bundle.GetImage(L"images/opaque.png").HasAlpha());
+    ASSERT_FALSE(bundle.GetImage(L"images/beta.png").IsOk());
+}
+
+TEST(AssetBundleTest, Missing) {
+    AssetBundle bundle;
+    ASSERT_FALSE(bundle.Open(wxFileName::GetTempDir() + L"/missing.aqb"));
+    ASSERT_FALSE(bundle.IsOpen());
+}
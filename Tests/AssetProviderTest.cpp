@@ -0,0 +1,67 @@
+/**
+ * @file AssetProviderTest.cpp
+ * @author Evan Gasper
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <MemoryAssetProvider.h>
+#include <Aquarium.h>
+#include <FishBeta.h>
+#include <DecorCastle.h>
+
+using namespace std;
+
+TEST(AssetProviderTest, Placeholder) {
+    auto assets = make_shared<MemoryAssetProvider>(wxSize(40, 20));
+
+    // Images nobody added are made up, without looking on disk
+    auto sprite = assets->GetSprite(L"nowhere/fish.png");
+    ASSERT_EQ(sprite->GetSize(), wxSize(40, 20));
+
+    auto &image = sprite->GetImage();
+    ASSERT_TRUE(image.IsOk());
+    ASSERT_FALSE(image.IsTransparent(20, 10));
+    ASSERT_TRUE(image.IsTransparent(0, 0));
+    ASSERT_TRUE(image.IsTransparent(39, 19));
+
+    // Sprites are shared within a provider, but not between them
+    ASSERT_EQ(assets->GetSprite(L"nowhere/fish.png"), sprite);
+    ASSERT_NE(make_shared<MemoryAssetProvider>()->GetSprite(L"nowhere/fish.png"), sprite);
+}
+
+TEST(AssetProviderTest, Added) {
+    auto assets = make_shared<MemoryAssetProvider>();
+    wxImage added(7, 5);
+    added.SetRGB(3, 2, 10, 20, 30);
+    assets->Add(L"images/castle.png", added);
+
+    auto sprite = assets->GetSprite(L"images/castle.png");
+    ASSERT_EQ(sprite->GetSize(), wxSize(7, 5));
+    ASSERT_EQ(sprite->GetImage().GetGreen(3, 2), 20);
+}
+
+TEST(AssetProviderTest, Aquarium) {
+    auto assets = make_shared<MemoryAssetProvider>(wxSize(30, 30));
+    assets->Add(L"images/background1.png", wxImage(800, 600));
+    Aquarium aquarium(assets);
+    ASSERT_EQ(aquarium.GetWidth(), 800);
+    ASSERT_EQ(aquarium.GetHeight(), 600);
+
+    // Items get their images from the aquarium's provider
+    auto fish = make_shared<FishBeta>(&aquarium);
+    aquarium.Add(fish);
+    aquarium.MoveItem(fish, 100, 200);
+    ASSERT_EQ(fish->GetBounds(), wxRect(85, 185, 30, 30));
+    ASSERT_TRUE(aquarium.HitTest(100, 200) == fish);
+    ASSERT_EQ(aquarium.HitTest(86, 186), nullptr);
+
+    // Items of a kind share a species, but aquariums
+    // with different providers do not
+    auto castle1 = make_shared<DecorCastle>(&aquarium);
+    auto castle2 = make_shared<DecorCastle>(&aquarium);
+    ASSERT_EQ(castle1->GetSpecies(), castle2->GetSpecies());
+
+    Aquarium other;
+    ASSERT_NE(make_shared<DecorCastle>(&other)->GetSpecies(), castle1->GetSpecies());
+}
@@ -0,0 +1,78 @@
+/**
+ * @file AttributeCodecTest.cpp
+ * @author Evan Gasper
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <AttributeCodec.h>
+#include <clocale>
+#include <limits>
+
+TEST(AttributeCodecTest, Format) {
+    // Whole numbers have no decimal point, as the files always had
+    ASSERT_EQ(AttributeCodec::Format(120), L"120");
+    ASSERT_EQ(AttributeCodec::Format(-72), L"-72");
+    ASSERT_EQ(AttributeCodec::Format(0), L"0");
+
+    // Shortest text that reads back exactly
+    ASSERT_EQ(AttributeCodec::Format(0.1), L"0.1");
+    ASSERT_EQ(AttributeCodec::Format(17.25), L"17.25");
+}
+
+TEST(AttributeCodecTest, RoundTrip) {
+    const double values[] = {0.1, 1.0 / 3.0, -107.5, 1e-300, 123456789.123456789,
+            std::numeric_limits<double>::max(), std::numeric_limits<double>::min()};
+
+    for (auto value : values)
+    {
+        double parsed = 0;
+        ASSERT_TRUE(AttributeCodec::Parse(AttributeCodec::Format(value), &parsed));
+        ASSERT_EQ(value, parsed);
+    }
+}
+
+TEST(AttributeCodecTest, Parse) {
+    double value = 42;
+    ASSERT_TRUE(AttributeCodec::Parse(L"10.5", &value));
+    ASSERT_EQ(value, 10.5);
+
+    // Text that is not entirely a number leaves the value alone
+    value = 42;
+    ASSERT_FALSE(AttributeCodec::Parse(L"", &value));
+    ASSERT_FALSE(AttributeCodec::Parse(L"abc", &value));
+    ASSERT_FALSE(AttributeCodec::Parse(L"10.5x", &value));
+    ASSERT_FALSE(AttributeCodec::Parse(L"10,5", &value));
+    ASSERT_FALSE(AttributeCodec::Parse(L"1\u00e9", &value));
+    ASSERT_EQ(value, 42);
+}
+
+TEST(AttributeCodecTest, Locale) {
+    // A locale with a comma for the decimal point changes nothing
+    auto old = std::setlocale(LC_NUMERIC, nullptr);
+    std::string saved = old != nullptr ? old : "C";
+    if (std::setlocale(LC_NUMERIC, "de_DE.UTF-8") == nullptr)
+    {
+        GTEST_SKIP() << "de_DE locale not installed";
+    }
+
+    double value = 0;
+    ASSERT_EQ(AttributeCodec::Format(17.25), L"17.25");
+    ASSERT_TRUE(AttributeCodec::Parse(L"17.25", &value));
+    std::setlocale(LC_NUMERIC, saved.c_str());
+    ASSERT_EQ(value, 17.25);
+}
+
+TEST(AttributeCodecTest, XmlNode) {
+    wxXmlNode node(wxXML_ELEMENT_NODE, L"item");
+    AttributeCodec::Save(&node, L"x", 120.5);
+    node.AddAttribute(L"bad", L"fish");
+
+    ASSERT_EQ(node.GetAttribute(L"x"), L"120.5");
+    ASSERT_EQ(AttributeCodec::Load(&node, L"x"), 120.5);
+
+    // Missing or bad attributes give the default
+    ASSERT_EQ(AttributeCodec::Load(&node, L"y"), 0);
+    ASSERT_EQ(AttributeCodec::Load(&node, L"y", 7), 7);
+    ASSERT_EQ(AttributeCodec::Load(&node, L"bad", 7), 7);
+}
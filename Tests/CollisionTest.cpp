@@ -0,0 +1,155 @@
+/**
+ * @file CollisionTest.cpp
+ * @author Evan Gasper
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <SweepAndPrune.h>
+#include <Sprite.h>
+#include <Aquarium.h>
+#include <FishBeta.h>
+#include "TestAssets.h"
+#include <random>
+#include <set>
+
+TEST(CollisionTest, SweepAndPrune) {
+    std::mt19937 random(3);
+    std::uniform_int_distribution<> location(0, 2000);
+    std::uniform_int_distribution<> size(1, 100);
+
+    std::vector<wxRect> rects;
+    for (int i = 0; i < 500; i++)
+    {
+        rects.emplace_back(location(random), location(random), size(random), size(random));
+    }
+
+    SweepAndPrune sweep;
+    for (int step = 0; step < 3; step++)
+    {
+        // Every overlapping pair is found once, smaller number first
+        auto &pairs = sweep.FindPairs(rects);
+        std::set<std::pair<size_t, size_t>> found(pairs.begin(), pairs.end());
+        ASSERT_EQ(found.size(), pairs.size());
+
+        size_t expected = 0;
+        for (size_t i = 0; i < rects.size(); i++)
+        {
+            for (size_t j = i + 1; j < rects.size(); j++)
+            {
+                if (rects[i].Intersects(rects[j]))
+                {
+                    expected++;
+                    ASSERT_EQ(1u, found.count({i, j}));
+                }
+            }
+        }
+        ASSERT_EQ(expected, pairs.size());
+
+        // Move everything a little, as items do between steps
+        for (auto &rect : rects)
+        {
+            rect.Offset(location(random) % 21 - 10, location(random) % 21 - 10);
+        }
+    }
+}
+
+TEST(CollisionTest, Overlaps) {
+    auto sprite = Sprite::Get(L"images/beta.png");
+    sprite->GetImage();
+    auto size = sprite->GetSize();
+
+    // An image overlaps itself in the same place, centred on its solid part
+    wxRealPoint centre;
+    ASSERT_TRUE(sprite->Overlaps(wxPoint(100, 100), false, *sprite, wxPoint(100, 100), false, &centre));
+    ASSERT_GT(centre.x, 100);
+    ASSERT_LT(centre.x, 100 + size.GetWidth());
+    ASSERT_GT(centre.y, 100);
+    ASSERT_LT(centre.y, 100 + size.GetHeight());
+
+    // Images side by side do not
+    ASSERT_FALSE(sprite->Overlaps(wxPoint(100, 100), false, *sprite, wxPoint(100 + size.GetWidth(), 100), true));
+
+    // Bounds overlapping by a single corner pixel of see through space do not
+    ASSERT_FALSE(sprite->Overlaps(wxPoint(0, 0), false, *sprite,
+            wxPoint(size.GetWidth() - 1, size.GetHeight() - 1), false));
+}
+
+TEST(CollisionTest, Bounce) {
+    // Collisions depend on the images, so they are decoded first
+    auto assets = TestAssets();
+    Aquarium aquarium(assets);
+    assets->GetSprite(L"images/beta.png")->GetImage();
+
+    // Two beta fish swimming into each other
+    auto fish1 = std::make_shared<FishBeta>(&aquarium);
+    auto fish2 = std::make_shared<FishBeta>(&aquarium);
+    wxXmlNode node1(wxXML_ELEMENT_NODE, L"item");
+    node1.AddAttribute(L"x", L"400");
+    node1.AddAttribute(L"y", L"300");
+    node1.AddAttribute(L"speedx", L"10");
+    node1.AddAttribute(L"speedy", L"0");
+    fish1->XmlLoad(&node1);
+    wxXmlNode node2(wxXML_ELEMENT_NODE, L"item");
+    node2.AddAttribute(L"x", L"420");
+    node2.AddAttribute(L"y", L"300");
+    node2.AddAttribute(L"speedx", L"-10");
+    node2.AddAttribute(L"speedy", L"0");
+    fish2->XmlLoad(&node2);
+    aquarium.Add(fish1);
+    aquarium.Add(fish2);
+
+    // Adding puts items at the initial location, so put them back
+    aquarium.MoveItem(fish1, 400, 300);
+    aquarium.MoveItem(fish2, 420, 300);
+
+    // Without collisions they swim through each other
+    aquarium.Update(0.01);
+    ItemState state1, state2;
+    fish1->GetState(state1);
+    fish2->GetState(state2);
+    ASSERT_DOUBLE_EQ(10, state1.mSpeedX);
+    ASSERT_DOUBLE_EQ(-10, state2.mSpeedX);
+
+    // With collisions they trade speeds and turn around
+    aquarium.SetCollisions(true);
+    aquarium.Update(0.01);
+    fish1->GetState(state1);
+    fish2->GetState(state2);
+    ASSERT_NEAR(-10, state1.mSpeedX, 0.001);
+    ASSERT_NEAR(10, state2.mSpeedX, 0.001);
+
+    // Moving apart, so they do not bounce again
+    aquarium.Update(0.01);
+    fish1->GetState(state1);
+    ASSERT_NEAR(-10, state1.mSpeedX, 0.001);
+}
+
+TEST(CollisionTest, NewImage) {
+    // Fish collide the first step their image is used,
+    // without waiting for it to be decoded in the background
+    Aquarium aquarium(TestAssets());
+    auto fish1 = std::make_shared<FishBeta>(&aquarium);
+    auto fish2 = std::make_shared<FishBeta>(&aquarium);
+    wxXmlNode node1(wxXML_ELEMENT_NODE, L"item");
+    node1.AddAttribute(L"speedx", L"10");
+    node1.AddAttribute(L"speedy", L"0");
+    fish1->XmlLoad(&node1);
+    wxXmlNode node2(wxXML_ELEMENT_NODE, L"item");
+    node2.AddAttribute(L"speedx", L"-10");
+    node2.AddAttribute(L"speedy", L"0");
+    fish2->XmlLoad(&node2);
+    aquarium.Add(fish1);
+    aquarium.Add(fish2);
+    aquarium.MoveItem(fish1, 400, 300);
+    aquarium.MoveItem(fish2, 420, 300);
+
+    aquarium.SetCollisions(true);
+    aquarium.Update(0.001);
+
+    ItemState state1, state2;
+    fish1->GetState(state1);
+    fish2->GetState(state2);
+    ASSERT_NEAR(-10, state1.mSpeedX, 0.001);
+    ASSERT_NEAR(10, state2.mSpeedX, 0.001);
+}
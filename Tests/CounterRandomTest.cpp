@@ -0,0 +1,75 @@
+/**
+ * @file CounterRandomTest.cpp
+ * @author Evan Gasper
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <CounterRandom.h>
+#include <WorkerPool.h>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+TEST(CounterRandomTest, Philox) {
+    // Known answers from the authors of Philox
+    uint32_t output[4];
+    uint32_t zeroCounter[4] = {0, 0, 0, 0};
+    uint32_t zeroKey[2] = {0, 0};
+    CounterRandom::Philox(zeroCounter, zeroKey, output);
+    ASSERT_EQ(output[0], 0x6627e8d5u);
+    ASSERT_EQ(output[3], 0x9b00dbd8u);
+
+    uint32_t piCounter[4] = {0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344};
+    uint32_t piKey[2] = {0xa4093822, 0x299f31d0};
+    CounterRandom::Philox(piCounter, piKey, output);
+    ASSERT_EQ(output[0], 0xd16cfe09u);
+    ASSERT_EQ(output[1], 0x94fdccebu);
+    ASSERT_EQ(output[2], 0x5001e420u);
+    ASSERT_EQ(output[3], 0x24126ea1u);
+}
+
+TEST(CounterRandomTest, Streams) {
+    CounterRandom random(1238197374);
+    std::uniform_real_distribution<> distribution(0, 1);
+    auto first = distribution(random);
+
+    // Reseeding starts the stream again
+    random.seed(1238197374);
+    ASSERT_EQ(distribution(random), first);
+
+    // A stream gives the same numbers however far the
+    // generator it came from has got
+    auto stream = random.Stream(5);
+    auto value = stream();
+    random();
+    ASSERT_EQ(random.Stream(5)(), value);
+    ASSERT_NE(random.Stream(6)(), value);
+
+    // Reserved streams count up until the next seed
+    ASSERT_EQ(random.Reserve(10), 0u);
+    ASSERT_EQ(random.Reserve(10), 10u);
+    random.seed(7);
+    ASSERT_EQ(random.Reserve(1), 0u);
+}
+
+TEST(CounterRandomTest, Parallel) {
+    // Drawing the streams on many threads gives the same
+    // numbers as drawing them one after another
+    const CounterRandom random(42);
+    vector<uint32_t> serial(1000), parallel(1000);
+    for (size_t i = 0; i < serial.size(); i++)
+    {
+        auto stream = random.Stream(i);
+        serial[i] = stream();
+    }
+
+    WorkerPool pool(4);
+    pool.Run(parallel.size(), [&](size_t i) {
+        auto stream = random.Stream(i);
+        parallel[i] = stream();
+    });
+
+    ASSERT_EQ(serial, parallel);
+}
@@ -1,9 +1,9 @@
-#include "gtest/gtest.h"
-
-
-
-TEST(EmptyTest, ExampleTest){
-
-
-  ASSERT_EQ(7, 7);
-}
+#include "gtest/gtest.h"
+
+
+
+TEST(EmptyTest, ExampleTest){
+
+
+  ASSERT_EQ(7, 7);
+}
@@ -1,9 +1,48 @@
-/**
- * @file FishBetaTest.cpp
- * @author evang
- */
-
-#include <pch.h>
-#include "gtest/gtest.h"
-#include <Aquarium.h>
-#include <FishBeta.h>
+/**
+ * @file FishBetaTest.cpp
+ * @author evang
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <Aquarium.h>
+#include <FishBeta.h>
+#include <DecorCastle.h>
+#include <ItemState.h>
+#include "TestAssets.h"
+
+using namespace std;
+
+TEST(FishBetaTest, Traits) {
+    // Species only add constants to Fish
+    static_assert(FishBetaTraits::SpeedXMin < FishBetaTraits::SpeedXMax, "speed range");
+    static_assert(sizeof(FishBeta) == sizeof(Fish), "species should not add members");
+
+    Aquarium aquarium(TestAssets());
+    auto fish = make_shared<FishBeta>(&aquarium);
+    auto castle = make_shared<DecorCastle>(&aquarium);
+    aquarium.Add(fish);
+    aquarium.Add(castle);
+    fish->SetLocation(400, 300);
+    castle->SetLocation(200, 300);
+
+    ItemState state;
+    fish->GetState(state);
+    ASSERT_STREQ(state.mType, L"beta");
+    ASSERT_GE(state.mSpeedX, FishBetaTraits::SpeedXMin);
+    ASSERT_LE(state.mSpeedX, FishBetaTraits::SpeedXMax);
+    ASSERT_EQ(fish->GetSpecies()->GetSchooling(), FishBetaTraits::Schooling);
+
+    // The fish are stepped apart from the other items
+    aquarium.Update(0.5);
+    ASSERT_NEAR(fish->GetX(), 400 + state.mSpeedX * 0.5, 0.0001);
+    ASSERT_NEAR(castle->GetX(), 200, 0.0001);
+
+    // Items added later are stepped too
+    auto fish2 = make_shared<FishBeta>(&aquarium);
+    aquarium.Add(fish2);
+    fish2->SetLocation(400, 300);
+    fish2->GetState(state);
+    aquarium.Update(0.5);
+    ASSERT_NEAR(fish2->GetX(), 400 + state.mSpeedX * 0.5, 0.0001);
+}
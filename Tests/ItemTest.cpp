@@ -2,6 +2,7 @@
 #include "gtest/gtest.h"
 #include <Item.h>
 #include <Aquarium.h>
+#include "TestAssets.h"
 
 
 /// Fish filename
@@ -10,18 +11,18 @@ const std::wstring FishBetaImageName = L"images/beta.png";
 class ItemMock : public Item
 {
 public:
-    ItemMock(Aquarium *aquarium) : Item(aquarium, FishBetaImageName) {}
+    ItemMock(Aquarium *aquarium) : Item(Species::Get(FishBetaImageName)) {}
 
-    void Draw(wxDC* dc) override {}
+    void Draw(Renderer* renderer, const Aquarium& aquarium) override {}
 };
 
 TEST(ItemTest, Construct){
-    Aquarium aquarium;
+    Aquarium aquarium(TestAssets());
     ItemMock item(&aquarium);
 }
 
 TEST(ItemTest, GettersSetters){
-    Aquarium aquarium;
+    Aquarium aquarium(TestAssets());
     ItemMock item(&aquarium);
 
     // Test initial values
@@ -0,0 +1,121 @@
+/**
+ * @file KineticsTest.cpp
+ * @author Evan Gasper
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <Aquarium.h>
+#include <FishBeta.h>
+#include <DecorCastle.h>
+#include <AttributeCodec.h>
+#include "TestAssets.h"
+
+/**
+ * Make a beta fish swimming straight across
+ * @param aquarium The aquarium the fish goes in
+ * @param x Starting X location
+ * @param speedX Speed across
+ * @return The fish, already added to the aquarium
+ */
+static std::shared_ptr<FishBeta> AddFish(Aquarium& aquarium, double x, double speedX)
+{
+    auto fish = std::make_shared<FishBeta>(&aquarium);
+    wxXmlNode node(wxXML_ELEMENT_NODE, L"item");
+    AttributeCodec::Save(&node, L"x", x);
+    AttributeCodec::Save(&node, L"y", 300);
+    AttributeCodec::Save(&node, L"speedx", speedX);
+    AttributeCodec::Save(&node, L"speedy", 0);
+    fish->XmlLoad(&node);
+    aquarium.Add(fish);
+    aquarium.MoveItem(fish, x, 300);
+    return fish;
+}
+
+TEST(KineticsTest, Lazy) {
+    Aquarium aquarium(TestAssets());
+    aquarium.SetKinetic(true);
+    ASSERT_TRUE(aquarium.IsKinetic());
+    auto fish = AddFish(aquarium, 400, 10);
+
+    // Nothing has looked at the fish, so it has not been moved
+    aquarium.Update(0.5);
+    ASSERT_DOUBLE_EQ(400, fish->GetX());
+
+    // Finding it moves it to where it is now
+    wxRect all(0, 0, aquarium.GetWidth(), aquarium.GetHeight());
+    ASSERT_EQ(std::vector<size_t>{0}, aquarium.ItemsIn(all));
+    ASSERT_NEAR(405, fish->GetX(), 0.0001);
+
+    // As does hit testing it
+    aquarium.Update(0.5);
+    ASSERT_EQ(fish, aquarium.HitTest(410, 300));
+    ASSERT_NEAR(410, fish->GetX(), 0.0001);
+}
+
+TEST(KineticsTest, Seek) {
+    Aquarium aquarium(TestAssets());
+    aquarium.SetKinetic(true);
+    auto fish = AddFish(aquarium, 400, 10);
+    aquarium.Add(std::make_shared<DecorCastle>(&aquarium));
+
+    // The fish turns around at the right wall, which is where
+    // the fish's centre is half its width plus 10 from the edge
+    double wall = aquarium.GetWidth() - 10 - fish->GetBounds().GetWidth() / 2.0;
+    double reached = (wall - 400) / 10;
+    aquarium.Update(100);
+    auto items = aquarium.ItemsIn(wxRect(0, 0, aquarium.GetWidth(), aquarium.GetHeight()));
+    ASSERT_EQ(2u, items.size());
+    ASSERT_NEAR(wall - 10 * (100 - reached), fish->GetX(), 0.0001);
+
+    // Turning kinetic motion off leaves the fish where it is now
+    aquarium.Update(1);
+    aquarium.SetKinetic(false);
+    ASSERT_NEAR(wall - 10 * (101 - reached), fish->GetX(), 0.0001);
+
+    // And it moves on frame by frame from there
+    aquarium.Update(1);
+    ASSERT_NEAR(wall - 10 * (102 - reached), fish->GetX(), 0.0001);
+}
+
+TEST(KineticsTest, Schooling) {
+    Aquarium aquarium(TestAssets());
+    aquarium.SetKinetic(true);
+    auto fish = AddFish(aquarium, 400, 10);
+    aquarium.Update(1);
+
+    // Schooling fish do not swim in straight lines, so
+    // kinetic motion waits until schooling is off again
+    aquarium.SetSchooling(true);
+    ASSERT_NEAR(410, fish->GetX(), 0.0001);
+    ASSERT_TRUE(aquarium.IsKinetic());
+
+    aquarium.SetSchooling(false);
+    aquarium.Update(1);
+    aquarium.Snapshot();
+    ASSERT_NEAR(420, fish->GetX(), 0.0001);
+}
+
+TEST(KineticsTest, Looking) {
+    Aquarium aquarium(TestAssets());
+    aquarium.SetKinetic(true);
+    auto fish = AddFish(aquarium, 400, 10.3);
+
+    Aquarium aquarium2(TestAssets());
+    aquarium2.SetKinetic(true);
+    auto fish2 = AddFish(aquarium2, 400, 10.3);
+
+    // Looking at a fish every frame does not change where it
+    // goes, even across a turn at the wall
+    wxRect all(0, 0, aquarium.GetWidth(), aquarium.GetHeight());
+    for (int frame = 0; frame < 10000; frame++)
+    {
+        aquarium.Update(0.013);
+        aquarium.ItemsIn(all);
+        aquarium2.Update(0.013);
+    }
+
+    aquarium2.ItemsIn(all);
+    ASSERT_EQ(fish2->GetX(), fish->GetX());
+    ASSERT_EQ(fish2->GetY(), fish->GetY());
+}
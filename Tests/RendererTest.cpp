@@ -0,0 +1,63 @@
+/**
+ * @file RendererTest.cpp
+ * @author Evan Gasper
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <Renderer.h>
+#include <DcRenderer.h>
+#include <GraphicsRenderer.h>
+#include <Aquarium.h>
+#include <Sprite.h>
+
+/**
+ * Draw an empty aquarium with a renderer
+ * @param name Name of the renderer
+ * @return What was drawn
+ */
+static wxImage DrawAquarium(const wxString& name)
+{
+    // The background is decoded before drawing, so it is drawn
+    Sprite::Get(L"images/background1.png")->GetImage();
+
+    Aquarium aquarium;
+    wxBitmap bitmap(200, 200);
+    {
+        wxMemoryDC dc(bitmap);
+        auto renderer = Renderer::Create(name);
+        renderer->Begin(&dc, 1, wxPoint(100, 100));
+        aquarium.OnDraw(renderer.get(), wxRect(100, 100, 200, 200));
+        renderer->End();
+    }
+
+    return bitmap.ConvertToImage();
+}
+
+TEST(RendererTest, Create) {
+    auto dc = Renderer::Create(L"dc");
+    ASSERT_NE(dc, nullptr);
+    ASSERT_EQ(dc->GetName(), L"dc");
+
+    auto graphics = Renderer::Create(L"graphics");
+    ASSERT_NE(graphics, nullptr);
+    ASSERT_EQ(graphics->GetName(), L"graphics");
+
+    ASSERT_EQ(Renderer::Create(L"opengl"), nullptr);
+}
+
+TEST(RendererTest, Same) {
+    // Both renderers draw the background through
+    // the camera to the same pixels
+    auto dc = DrawAquarium(DcRenderer::Name);
+    auto graphics = DrawAquarium(GraphicsRenderer::Name);
+    for (int y = 0; y < 200; y += 50)
+    {
+        for (int x = 0; x < 200; x += 50)
+        {
+            ASSERT_EQ(dc.GetRed(x, y), graphics.GetRed(x, y));
+            ASSERT_EQ(dc.GetGreen(x, y), graphics.GetGreen(x, y));
+            ASSERT_EQ(dc.GetBlue(x, y), graphics.GetBlue(x, y));
+        }
+    }
+}
@@ -0,0 +1,126 @@
+/**
+ * @file SchoolTest.cpp
+ * @author Evan Gasper
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <School.h>
+#include <Aquarium.h>
+#include <FishBeta.h>
+#include <DovaFish.h>
+#include "TestAssets.h"
+#include <random>
+#include <set>
+#include <cmath>
+
+TEST(SchoolTest, Neighbours) {
+    School school(100);
+
+    // Fish spread over an area much larger than a cell,
+    // including some at negative locations
+    std::mt19937 random(7);
+    std::uniform_real_distribution<> location(-500, 1500);
+    for (int i = 0; i < 2000; i++)
+    {
+        school.Add({location(random), location(random), 0, 0, nullptr});
+    }
+    school.Build();
+    ASSERT_EQ(2000u, school.GetSize());
+
+    for (size_t i = 0; i < school.GetSize(); i += 37)
+    {
+        auto &member = school.GetMember(i);
+
+        // Every fish within the cell size is visited exactly once
+        std::multiset<size_t> visited;
+        school.Visit(member.mX, member.mY, [&visited](size_t index) {
+            visited.insert(index);
+            return true;
+        });
+
+        for (size_t j = 0; j < school.GetSize(); j++)
+        {
+            auto &other = school.GetMember(j);
+            if (std::hypot(other.mX - member.mX, other.mY - member.mY) < school.GetCellSize())
+            {
+                ASSERT_EQ(1u, visited.count(j));
+            }
+            else
+            {
+                ASSERT_LE(visited.count(j), 1u);
+            }
+        }
+    }
+}
+
+TEST(SchoolTest, Stop) {
+    School school(100);
+    for (int i = 0; i < 10; i++)
+    {
+        school.Add({50, 50, 0, 0, nullptr});
+    }
+    school.Build();
+
+    // Returning false stops the visit
+    int visits = 0;
+    school.Visit(50, 50, [&visits](size_t index) { return ++visits < 3; });
+    ASSERT_EQ(3, visits);
+
+    // Nothing to visit once cleared
+    school.Clear();
+    school.Visit(50, 50, [&visits](size_t index) { visits++; return true; });
+    ASSERT_EQ(3, visits);
+}
+
+TEST(SchoolTest, Align) {
+    Aquarium aquarium(TestAssets());
+    aquarium.GetRandom().seed(1);
+
+    // Two dova fish close together swimming the same way. Adding
+    // puts items at the initial location, so they are moved after.
+    auto fish1 = std::make_shared<DovaFish>(&aquarium);
+    auto fish2 = std::make_shared<DovaFish>(&aquarium);
+    aquarium.Add(fish1);
+    aquarium.Add(fish2);
+    aquarium.MoveItem(fish1, 400, 300);
+    aquarium.MoveItem(fish2, 440, 300);
+
+    ItemState state1, state2;
+    fish1->GetState(state1);
+    fish2->GetState(state2);
+    ASSERT_GT(state1.mSpeedX * state2.mSpeedX, 0);
+
+    // Without schooling they keep their speeds
+    aquarium.Update(0.1);
+    ItemState after1;
+    fish1->GetState(after1);
+    ASSERT_DOUBLE_EQ(state1.mSpeedX, after1.mSpeedX);
+
+    // Turn one around where it is, well within schooling distance
+    // of the other, and schooling brings them back into line
+    wxXmlNode node(wxXML_ELEMENT_NODE, L"item");
+    node.AddAttribute(L"x", L"400");
+    node.AddAttribute(L"y", L"300");
+    node.AddAttribute(L"speedx", L"-20");
+    node.AddAttribute(L"speedy", L"0");
+    fish1->XmlLoad(&node);
+    aquarium.SetSchooling(true);
+    ASSERT_NE(nullptr, aquarium.GetSchool());
+
+    auto difference = [&]() {
+        fish1->GetState(state1);
+        fish2->GetState(state2);
+        return std::hypot(state1.mSpeedX - state2.mSpeedX, state1.mSpeedY - state2.mSpeedY);
+    };
+
+    auto before = difference();
+    for (int i = 0; i < 30; i++)
+    {
+        aquarium.Update(0.03);
+    }
+    ASSERT_LT(difference(), before);
+
+    aquarium.SetSchooling(false);
+    ASSERT_EQ(nullptr, aquarium.GetSchool());
+}
@@ -0,0 +1,183 @@
+/**
+ * @file SessionTest.cpp
+ * @author Evan Gasper
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <Aquarium.h>
+#include <FishBeta.h>
+#include <DecorCastle.h>
+#include <SessionRecorder.h>
+#include <SessionPlayer.h>
+#include "TestAssets.h"
+#include <wx/filename.h>
+
+using namespace std;
+
+TEST(SessionTest, RecordReplay) {
+    auto file = wxFileName::GetTempDir() + L"/test.aqsession";
+    const uint32_t seed = 1238197374;
+
+    // Make the changes AquariumView would, recording them as it does
+    Aquarium aquarium(TestAssets());
+    aquarium.GetRandom().seed(seed);
+    {
+        SessionRecorder recorder;
+        ASSERT_TRUE(recorder.Open(file, seed));
+
+        auto fish = make_shared<FishBeta>(&aquarium);
+        aquarium.Add(fish);
+        recorder.RecordAdd(fish.get());
+
+        aquarium.Update(0.031);
+        recorder.RecordFrame(0.031);
+
+        auto castle = make_shared<DecorCastle>(&aquarium);
+        aquarium.Add(castle);
+        recorder.RecordAdd(castle.get());
+
+        // Grab whatever is on top at the add location and drag it away
+        recorder.RecordGrab(200, 200);
+        auto grabbed = aquarium.HitTest(200, 200);
+        ASSERT_NE(grabbed, nullptr);
+        aquarium.MoveItemToEnd(grabbed);
+
+        grabbed->SetLocation(300, 250);
+        recorder.RecordDrag(300, 250);
+        aquarium.Update(0.029);
+        recorder.RecordFrame(0.029);
+
+        aquarium.ItemMoved(grabbed);
+        recorder.RecordRelease();
+
+        // Turn everything around
+        aquarium.SelectAll();
+        recorder.RecordSelectAll();
+        aquarium.MirrorSelection();
+        recorder.RecordMirror();
+
+        for (int i = 0; i < 100; i++)
+        {
+            aquarium.Update(0.03 + i * 0.0001);
+            recorder.RecordFrame(0.03 + i * 0.0001);
+        }
+    }
+
+    // The replay ends up in exactly the same place
+    SessionPlayer player;
+    ASSERT_TRUE(player.Open(file));
+    ASSERT_EQ(player.GetSeed(), seed);
+
+    Aquarium aquarium2(TestAssets());
+    player.Start(&aquarium2);
+    while (player.PlayFrame(&aquarium2))
+    {
+    }
+
+    ASSERT_EQ(player.GetFrames(), 102);
+
+    auto expected = aquarium.Snapshot();
+    auto replayed = aquarium2.Snapshot();
+    ASSERT_EQ(expected->size(), replayed->size());
+    for (size_t i = 0; i < expected->size(); i++)
+    {
+        auto &a = (*expected)[i];
+        auto &b = (*replayed)[i];
+        ASSERT_EQ(wxString(a.mType), wxString(b.mType));
+        ASSERT_EQ(a.mX, b.mX);
+        ASSERT_EQ(a.mY, b.mY);
+        ASSERT_EQ(a.mSpeedX, b.mSpeedX);
+        ASSERT_EQ(a.mSpeedY, b.mSpeedY);
+        ASSERT_EQ(a.mMirror, b.mMirror);
+    }
+}
+
+TEST(SessionTest, NotASession) {
+    auto file = wxFileName::GetTempDir() + L"/test.aqsession";
+    {
+        wxFFile out(file, L"wb");
+        out.Write("<aqua/>", 7);
+    }
+
+    SessionPlayer player;
+    ASSERT_FALSE(player.Open(file));
+}
+
+TEST(SessionTest, BadSpread) {
+    auto file = wxFileName::GetTempDir() + L"/test.aqsession";
+    {
+        SessionRecorder recorder;
+        ASSERT_TRUE(recorder.Open(file, 1));
+        recorder.RecordBulk(L"beta", 10, uint8_t(Aquarium::Spread::Centred));
+        recorder.RecordBulk(L"beta", 10, 2);
+        recorder.RecordFrame(0.03);
+    }
+
+    // Replay stops at a spread that is not one of Aquarium::Spread
+    SessionPlayer player;
+    ASSERT_TRUE(player.Open(file));
+    Aquarium aquarium(TestAssets());
+    player.Start(&aquarium);
+    ASSERT_FALSE(player.PlayFrame(&aquarium));
+    ASSERT_EQ(aquarium.GetCount(), 10u);
+}
+
+TEST(SessionTest, LoadChanged) {
+    auto file = wxFileName::GetTempDir() + L"/test.aqsession";
+    auto tank = wxFileName::GetTempDir() + L"/session.aqua";
+    const uint32_t seed = 1238197374;
+
+    {
+        Aquarium saved(TestAssets());
+        for (int i = 0; i < 3; i++)
+        {
+            auto fish = make_shared<FishBeta>(&saved);
+            saved.Add(fish);
+            fish->SetLocation(100 + i * 100, 300);
+        }
+
+        saved.Save(tank);
+    }
+
+    // Record a load and a fish added after it
+    Aquarium aquarium(TestAssets());
+    aquarium.GetRandom().seed(seed);
+    {
+        SessionRecorder recorder;
+        ASSERT_TRUE(recorder.Open(file, seed));
+
+        aquarium.Load(tank);
+        recorder.RecordLoad(tank, *aquarium.XmlDocument());
+
+        auto fish = make_shared<FishBeta>(&aquarium);
+        aquarium.Add(fish);
+        recorder.RecordAdd(fish.get());
+
+        aquarium.Update(0.03);
+        recorder.RecordFrame(0.03);
+    }
+
+    // Change the file before the replay
+    Aquarium empty(TestAssets());
+    empty.Save(tank);
+
+    // The replay loads what was loaded when recording
+    SessionPlayer player;
+    ASSERT_TRUE(player.Open(file));
+    Aquarium aquarium2(TestAssets());
+    player.Start(&aquarium2);
+    while (player.PlayFrame(&aquarium2))
+    {
+    }
+
+    auto expected = aquarium.Snapshot();
+    auto replayed = aquarium2.Snapshot();
+    ASSERT_EQ(expected->size(), 4u);
+    ASSERT_EQ(expected->size(), replayed->size());
+    for (size_t i = 0; i < expected->size(); i++)
+    {
+        ASSERT_EQ((*expected)[i].mX, (*replayed)[i].mX);
+        ASSERT_EQ((*expected)[i].mSpeedX, (*replayed)[i].mSpeedX);
+    }
+}
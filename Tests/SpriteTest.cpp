@@ -0,0 +1,95 @@
+/**
+ * @file SpriteTest.cpp
+ * @author Evan Gasper
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <Sprite.h>
+
+TEST(SpriteTest, Shared) {
+    // Items using the same file share one sprite
+    auto sprite1 = Sprite::Get(L"images/beta.png");
+    auto sprite2 = Sprite::Get(L"images/beta.png");
+    ASSERT_EQ(sprite1, sprite2);
+
+    auto sprite3 = Sprite::Get(L"images/castle.png");
+    ASSERT_NE(sprite1, sprite3);
+}
+
+TEST(SpriteTest, Size) {
+    auto sprite = Sprite::Get(L"images/background1.png");
+
+    // The size is known right away and matches the decoded image
+    auto size = sprite->GetSize();
+    ASSERT_GT(size.GetWidth(), 0);
+    ASSERT_GT(size.GetHeight(), 0);
+
+    auto &image = sprite->GetImage();
+    ASSERT_TRUE(sprite->IsReady());
+    ASSERT_EQ(image.GetWidth(), size.GetWidth());
+    ASSERT_EQ(image.GetHeight(), size.GetHeight());
+}
+
+TEST(SpriteTest, Mirror) {
+    auto sprite = Sprite::Get(L"images/beta.png");
+
+    auto &image = sprite->GetImage();
+    auto &mirror = sprite->GetImage(true);
+    ASSERT_EQ(image.GetSize(), mirror.GetSize());
+
+    // Pixels swap from left to right
+    auto width = image.GetWidth();
+    for (int y = 0; y < image.GetHeight(); y++)
+    {
+        ASSERT_EQ(image.IsTransparent(0, y), mirror.IsTransparent(width - 1, y));
+    }
+}
+
+TEST(SpriteTest, Levels) {
+    auto sprite = Sprite::Get(L"images/background1.png");
+    sprite->GetImage();
+
+    // Each level halves the size, down to a single pixel
+    ASSERT_GT(sprite->GetLevels(), 1);
+    for (int level = 0; level < sprite->GetLevels(); level++)
+    {
+        ASSERT_EQ(sprite->GetSize(level), sprite->GetImage(false, level).GetSize());
+        ASSERT_EQ(sprite->GetSize(level), sprite->GetImage(true, level).GetSize());
+    }
+
+    auto last = sprite->GetLevels() - 1;
+    ASSERT_EQ(wxSize(1, 1), sprite->GetImage(false, last).GetSize());
+    ASSERT_EQ(wxSize(1, 1), sprite->GetImage(false, last + 5).GetSize());
+}
+
+TEST(SpriteTest, LevelForScale) {
+    ASSERT_EQ(0, Sprite::LevelForScale(4));
+    ASSERT_EQ(0, Sprite::LevelForScale(1));
+    ASSERT_EQ(0, Sprite::LevelForScale(0.8));
+    ASSERT_EQ(1, Sprite::LevelForScale(0.5));
+    ASSERT_EQ(1, Sprite::LevelForScale(0.6));
+    ASSERT_EQ(2, Sprite::LevelForScale(0.25));
+    ASSERT_EQ(5, Sprite::LevelForScale(1.0 / 32));
+}
+
+TEST(SpriteTest, Downsample) {
+    // An opaque red pixel next to a see through green one
+    wxImage image(2, 2, false);
+    image.InitAlpha();
+    for (int y = 0; y < 2; y++)
+    {
+        image.SetRGB(0, y, 255, 0, 0);
+        image.SetAlpha(0, y, wxIMAGE_ALPHA_OPAQUE);
+        image.SetRGB(1, y, 0, 255, 0);
+        image.SetAlpha(1, y, wxIMAGE_ALPHA_TRANSPARENT);
+    }
+
+    // The hidden green does not show through, and the pixel is half covered
+    auto small = Sprite::Downsample(image, wxSize(1, 1));
+    ASSERT_EQ(wxSize(1, 1), small.GetSize());
+    ASSERT_EQ(255, small.GetRed(0, 0));
+    ASSERT_EQ(0, small.GetGreen(0, 0));
+    ASSERT_EQ(0, small.GetBlue(0, 0));
+    ASSERT_EQ(128, small.GetAlpha(0, 0));
+}
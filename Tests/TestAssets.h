@@ -0,0 +1,28 @@
+/**
+ * @file TestAssets.h
+ * @author Evan Gasper
+ *
+ * Images for tests that do not look at pixels
+ */
+
+#ifndef TESTASSETS_H
+#define TESTASSETS_H
+
+#include <MemoryAssetProvider.h>
+#include <memory>
+
+/**
+ * Make a provider of images held in memory, so a test does not
+ * depend on the directory it runs in or wait on the PNG decoder.
+ * The background is the size of the real one, so aquariums are
+ * too. Every other image is a made up placeholder.
+ * @return The provider
+ */
+inline std::shared_ptr<MemoryAssetProvider> TestAssets()
+{
+    auto assets = std::make_shared<MemoryAssetProvider>();
+    assets->Add(L"images/background1.png", wxImage(1024, 800));
+    return assets;
+}
+
+#endif //TESTASSETS_H
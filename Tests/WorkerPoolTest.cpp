@@ -0,0 +1,149 @@
+/**
+ * @file WorkerPoolTest.cpp
+ * @author Evan Gasper
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <WorkerPool.h>
+#include <Aquarium.h>
+#include <DovaFish.h>
+#include <FishBeta.h>
+#include "TestAssets.h"
+#include <atomic>
+#include <vector>
+#include <memory>
+#include <future>
+
+TEST(WorkerPoolTest, Run) {
+    WorkerPool pool(4);
+    ASSERT_EQ(pool.GetSize(), 4u);
+
+    // Every task runs exactly once
+    std::vector<int> counts(1000, 0);
+    pool.Run(counts.size(), [&counts](size_t i) { counts[i]++; });
+    for (auto count : counts)
+    {
+        ASSERT_EQ(count, 1);
+    }
+
+    // Nothing to do is fine
+    pool.Run(0, [](size_t i) { FAIL(); });
+}
+
+TEST(WorkerPoolTest, Nested) {
+    // Tasks that run more tasks finish, even with every
+    // worker busy in an outer task
+    WorkerPool pool(1);
+    std::atomic<int> count{0};
+    pool.Run(4, [&pool, &count](size_t i) {
+        pool.Run(4, [&count](size_t j) { count++; });
+    });
+    ASSERT_EQ(count, 16);
+
+    // Also when the outer tasks are run from the worker
+    std::promise<void> done;
+    pool.Submit([&pool, &count, &done]() {
+        pool.Run(4, [&pool, &count](size_t i) {
+            pool.Run(4, [&count](size_t j) { count++; });
+        });
+        done.set_value();
+    });
+    done.get_future().wait();
+    ASSERT_EQ(count, 32);
+}
+
+TEST(WorkerPoolTest, Busy) {
+    // Run does not wait behind tasks queued before it. The
+    // caller does all the work itself while the worker is busy.
+    WorkerPool pool(1);
+    std::promise<void> release;
+    auto released = release.get_future().share();
+    pool.Submit([released]() { released.wait(); });
+    pool.Submit([]() {});
+
+    std::atomic<int> count{0};
+    pool.Run(8, [&count](size_t i) { count++; });
+    ASSERT_EQ(count, 8);
+    release.set_value();
+}
+
+TEST(WorkerPoolTest, Submit) {
+    std::atomic<int> count{0};
+    {
+        WorkerPool pool(2);
+        for (int i = 0; i < 100; i++)
+        {
+            pool.Submit([&count]() { count++; });
+        }
+    }
+
+    // Destroying the pool finishes the queued tasks
+    ASSERT_EQ(count, 100);
+}
+
+/**
+ * Fill an aquarium with schooling fish that collide
+ * @param aquarium The aquarium to fill
+ */
+static void FillTank(Aquarium &aquarium)
+{
+    aquarium.GetRandom().seed(7);
+    for (int i = 0; i < 40; i++)
+    {
+        std::shared_ptr<Item> fish;
+        if (i % 2 == 0)
+        {
+            fish = std::make_shared<DovaFish>(&aquarium);
+        }
+        else
+        {
+            fish = std::make_shared<FishBeta>(&aquarium);
+        }
+
+        aquarium.Add(fish);
+        aquarium.MoveItem(fish, 100 + (i % 8) * 90, 100 + (i / 8) * 80);
+    }
+
+    aquarium.SetSchooling(true);
+    aquarium.SetCollisions(true);
+}
+
+TEST(WorkerPoolTest, Tanks) {
+    // Collisions depend on the images, so they are
+    // decoded before any of the tanks move
+    auto assets = TestAssets();
+    assets->GetSprite(L"images/dovahfin.png")->GetImage();
+    assets->GetSprite(L"images/beta.png")->GetImage();
+
+    // Tanks stepped at the same time end up where
+    // a tank stepped on its own does
+    Aquarium alone(assets);
+    FillTank(alone);
+
+    std::vector<std::unique_ptr<Aquarium>> tanks;
+    for (int i = 0; i < 4; i++)
+    {
+        tanks.push_back(std::make_unique<Aquarium>(assets));
+        FillTank(*tanks.back());
+    }
+
+    WorkerPool pool(4);
+    for (int frame = 0; frame < 100; frame++)
+    {
+        alone.Update(0.03);
+        pool.Run(tanks.size(), [&tanks](size_t i) { tanks[i]->Update(0.03); });
+    }
+
+    auto expected = alone.Snapshot();
+    for (auto &tank : tanks)
+    {
+        auto snapshot = tank->Snapshot();
+        ASSERT_EQ(expected->size(), snapshot->size());
+        for (size_t i = 0; i < expected->size(); i++)
+        {
+            ASSERT_DOUBLE_EQ((*expected)[i].mX, (*snapshot)[i].mX);
+            ASSERT_DOUBLE_EQ((*expected)[i].mY, (*snapshot)[i].mY);
+        }
+    }
+}
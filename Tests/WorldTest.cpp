@@ -0,0 +1,201 @@
+/**
+ * @file WorldTest.cpp
+ * @author Evan Gasper
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <WorldExport.h>
+#include <WorldReader.h>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <csignal>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/**
+ * Get a shared memory name no other test run is using
+ * @param test Name of the test
+ * @return The name
+ */
+static std::string SharedName(const char *test)
+{
+    return "/aquarium-" + std::string(test) + "-" + std::to_string(getpid());
+}
+
+/**
+ * Make the items for a frame, all at a location
+ * given by the frame number
+ * @param sequence Frame number
+ * @param count Number of items
+ * @return The items
+ */
+static std::vector<ItemState> FrameItems(uint64_t sequence, size_t count)
+{
+    std::vector<ItemState> items(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        items[i].mType = i % 2 == 0 ? L"beta" : L"castle";
+        items[i].mX = double(sequence);
+        items[i].mY = double(sequence) * 2;
+        items[i].mMirror = i % 3 == 0;
+    }
+
+    return items;
+}
+
+TEST(WorldTest, Publish) {
+    auto name = SharedName("publish");
+    WorldExport exporter;
+    ASSERT_TRUE(exporter.Open(name, 8, 3));
+
+    WorldReader reader;
+    ASSERT_TRUE(reader.Open(name));
+
+    // Nothing to read until a frame is published
+    WorldReader::Frame frame;
+    ASSERT_EQ(reader.GetLatest(), 0u);
+    ASSERT_FALSE(reader.ReadLatest(frame));
+
+    exporter.Publish(FrameItems(1, 5), 0.5);
+    ASSERT_TRUE(reader.ReadLatest(frame));
+    ASSERT_EQ(frame.mSequence, 1u);
+    ASSERT_DOUBLE_EQ(frame.mTime, 0.5);
+    ASSERT_EQ(frame.mCount, 5u);
+    ASSERT_EQ(frame.mTotal, 5u);
+    ASSERT_EQ(frame.mItems[0].mType, WorldType::Beta);
+    ASSERT_EQ(frame.mItems[1].mType, WorldType::Castle);
+    ASSERT_EQ(frame.mItems[4].mZ, 4u);
+    ASSERT_DOUBLE_EQ(frame.mItems[2].mX, 1);
+    ASSERT_DOUBLE_EQ(frame.mItems[2].mY, 2);
+    ASSERT_EQ(frame.mItems[0].mMirror, 1u);
+    ASSERT_EQ(frame.mItems[1].mMirror, 0u);
+    ASSERT_TRUE(reader.IsValid(frame));
+
+    // Items that do not fit are left out, but counted
+    exporter.Publish(FrameItems(2, 10), 1.0);
+    ASSERT_TRUE(reader.ReadLatest(frame));
+    ASSERT_EQ(frame.mCount, 8u);
+    ASSERT_EQ(frame.mTotal, 10u);
+
+    // Frames stay readable until the ring comes round to them
+    WorldReader::Frame first;
+    ASSERT_TRUE(reader.Read(1, first));
+    exporter.Publish(FrameItems(3, 1), 1.5);
+    ASSERT_TRUE(reader.IsValid(first));
+    exporter.Publish(FrameItems(4, 1), 2.0);
+    ASSERT_FALSE(reader.IsValid(first));
+    ASSERT_FALSE(reader.Read(1, first));
+
+    // Unknown types are exported as such
+    ASSERT_EQ(WorldExport::TypeOf(L"dova"), WorldType::Dova);
+    ASSERT_EQ(WorldExport::TypeOf(L"shark"), WorldType::Unknown);
+    ASSERT_EQ(WorldExport::TypeOf(nullptr), WorldType::Unknown);
+
+    // Closing the export removes the shared memory
+    exporter.Close();
+    WorldReader late;
+    ASSERT_FALSE(late.Open(name));
+}
+
+TEST(WorldTest, Wanted) {
+    auto name = SharedName("wanted");
+    WorldExport exporter;
+    ASSERT_FALSE(exporter.IsWanted());
+    ASSERT_TRUE(exporter.Open(name, 8));
+
+    // Frames are wanted for a while after opening, in case
+    // a reader is already waiting for them
+    for (uint32_t i = 0; i < WorldExport::IdleFrames; i++)
+    {
+        ASSERT_TRUE(exporter.IsWanted());
+    }
+    ASSERT_FALSE(exporter.IsWanted());
+
+    // Then only once a reader looks for the latest frame
+    WorldReader reader;
+    ASSERT_TRUE(reader.Open(name));
+    ASSERT_FALSE(exporter.IsWanted());
+    reader.GetLatest();
+    ASSERT_TRUE(exporter.IsWanted());
+}
+
+TEST(WorldTest, ReaderProcess) {
+    auto name = SharedName("process");
+    WorldExport exporter;
+    ASSERT_TRUE(exporter.Open(name, 64));
+
+    auto child = fork();
+    ASSERT_GE(child, 0);
+    if (child == 0)
+    {
+        // The reader process checks every frame it reads is
+        // whole, then exits once it has seen enough of them
+        WorldReader reader;
+        if (!reader.Open(name))
+        {
+            _exit(2);
+        }
+
+        uint64_t seen = 0;
+        auto start = std::chrono::steady_clock::now();
+        while (seen < 200)
+        {
+            if (std::chrono::steady_clock::now() - start > std::chrono::seconds(10))
+            {
+                _exit(3);
+            }
+
+            WorldReader::Frame frame;
+            if (!reader.ReadLatest(frame) || frame.mSequence <= seen)
+            {
+                continue;
+            }
+
+            bool whole = frame.mCount == 64;
+            for (uint32_t i = 0; i < frame.mCount; i++)
+            {
+                whole = whole && frame.mItems[i].mX == double(frame.mSequence) &&
+                        frame.mItems[i].mY == double(frame.mSequence) * 2;
+            }
+
+            if (reader.IsValid(frame))
+            {
+                if (!whole)
+                {
+                    _exit(1);
+                }
+
+                seen = frame.mSequence;
+            }
+        }
+
+        _exit(0);
+    }
+
+    // Keep publishing until the reader is done
+    int status = 0;
+    auto start = std::chrono::steady_clock::now();
+    while (waitpid(child, &status, WNOHANG) == 0)
+    {
+        if (std::chrono::steady_clock::now() - start > std::chrono::seconds(20))
+        {
+            kill(child, SIGKILL);
+            waitpid(child, &status, 0);
+            FAIL() << "The reader process did not finish";
+        }
+
+        auto sequence = exporter.GetSequence() + 1;
+        exporter.Publish(FrameItems(sequence, 64), sequence * 0.03);
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+
+    ASSERT_TRUE(WIFEXITED(status));
+    ASSERT_EQ(WEXITSTATUS(status), 0);
+}
+
+#endif
@@ -1,13 +1,13 @@
-/**
-* @file pch.h
- * @author Evan Gasper
- */
-#ifndef AQUARIUM_PCH_H
-#define AQUARIUM_PCH_H
-
-#include <wx/wxprec.h>
-#ifndef WX_PRECOMP
-#include <wx/wx.h>
-#endif
-
-#endif //AQUARIUM_PCH_H
+/**
+* @file pch.h
+ * @author Evan Gasper
+ */
+#ifndef AQUARIUM_PCH_H
+#define AQUARIUM_PCH_H
+
+#include <wx/wxprec.h>
+#ifndef WX_PRECOMP
+#include <wx/wx.h>
+#endif
+
+#endif //AQUARIUM_PCH_H
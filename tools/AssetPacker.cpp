@@ -0,0 +1,58 @@
+/**
+ * @file AssetPacker.cpp
+ * @author Evan Gasper
+ *
+ * Build tool that packs the images into an asset bundle
+ *
+ * Usage: AssetPacker bundle directory name...
+ *
+ * Each name is the path of an image relative to directory, such
+ * as images/beta.png. The image is stored in the bundle under that
+ * name, which is the name the program asks for it by.
+ */
+
+#include "pch.h"
+#include <AssetBundle.h>
+#include <wx/init.h>
+#include <iostream>
+
+/**
+ * Pack the images named on the command line into a bundle
+ * @param argc Number of arguments
+ * @param argv Arguments
+ * @return 0 if successful
+ */
+int main(int argc, char **argv)
+{
+ wxInitializer initializer;
+ if (!initializer.IsOk() || argc < 3)
+ {
+  std::cerr << "Usage: AssetPacker bundle directory name..." << std::endl;
+  return 1;
+ }
+
+ wxInitAllImageHandlers();
+
+ wxString directory(argv[2]);
+ std::vector<std::pair<wxString, wxImage>> images;
+ for (int i = 3; i < argc; i++)
+ {
+  wxString name(argv[i]);
+  wxImage image;
+  if (!image.LoadFile(directory + L"/" + name, wxBITMAP_TYPE_ANY))
+  {
+   std::cerr << "Unable to load " << argv[i] << std::endl;
+   return 1;
+  }
+
+  images.emplace_back(name, image);
+ }
+
+ if (!AssetBundle::Write(argv[1], images))
+ {
+  std::cerr << "Unable to write " << argv[1] << std::endl;
+  return 1;
+ }
+
+ return 0;
+}